@@ -158,7 +158,7 @@ static void Cleanup(Rr_App *App, void *UserData)
     Rr_DestroyPipelineLayout(Renderer, Layout);
 }
 
-int main()
+int main(int argc, char **argv)
 {
     Rr_AppConfig Config = {};
     Config.Title = "11_PrefixSum";
@@ -167,5 +167,6 @@ int main()
     Config.InitFunc = Init;
     Config.CleanupFunc = Cleanup;
     Config.IterateFunc = Iterate;
+    Config.Headless = argc > 1 && std::strcmp(argv[1], "--headless") == 0;
     Rr_Run(&Config);
 }
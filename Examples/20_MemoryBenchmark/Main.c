@@ -0,0 +1,210 @@
+#include <Rr/Rr.h>
+
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_timer.h>
+
+#include <assert.h>
+#include <stdio.h>
+
+/* Standalone timings for the memory module, no window or device. */
+
+#define FRAME_COUNT      1000
+#define RESOURCE_COUNT   512
+#define LOOKUPS_PER_NODE 8
+#define HEAP_SLOT_COUNT  4096
+#define HEAP_STEP_COUNT  (1 << 22)
+
+static double GetSeconds(void)
+{
+    return (double)SDL_GetPerformanceCounter() /
+           (double)SDL_GetPerformanceFrequency();
+}
+
+static void PrintTiming(const char *Name, double Seconds, size_t OpCount)
+{
+    printf("%-28s %8.2f ns/op\n", Name, Seconds * 1e9 / (double)OpCount);
+}
+
+/* Models the lookups of a graph compile: every frame the resources
+ * used by the graph are inserted, then each node looks up a few of
+ * them. Keys are either Vulkan handles, which look like aligned
+ * pointers, or graph handle hashes. */
+
+static void FillPointerKeys(Rr_MapKey *Keys, Rr_Arena *Arena)
+{
+    for(size_t Index = 0; Index < RESOURCE_COUNT; ++Index)
+    {
+        Keys[Index] = (Rr_MapKey)Rr_AllocArena(Arena, 96, 64, 1);
+    }
+}
+
+static void FillHashKeys(Rr_MapKey *Keys)
+{
+    uint64_t State = 0x9E3779B97F4A7C15ull;
+    for(size_t Index = 0; Index < RESOURCE_COUNT; ++Index)
+    {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+        Keys[Index] = (Rr_MapKey)State;
+    }
+}
+
+static size_t GetLookupIndex(size_t Lookup)
+{
+    return (Lookup * 2654435761u) % RESOURCE_COUNT;
+}
+
+static void BenchmarkTrie(const char *Name, Rr_MapKey *Keys)
+{
+    Rr_Arena *Arena = Rr_CreateDefaultArena();
+    size_t Found = 0;
+
+    double Start = GetSeconds();
+    for(size_t Frame = 0; Frame < FRAME_COUNT; ++Frame)
+    {
+        Rr_Map *Map = NULL;
+        for(size_t Index = 0; Index < RESOURCE_COUNT; ++Index)
+        {
+            RR_UPSERT_DEREF(&Map, Keys[Index], Arena) = Keys + Index;
+        }
+        for(size_t Lookup = 0; Lookup < RESOURCE_COUNT * LOOKUPS_PER_NODE;
+            ++Lookup)
+        {
+            Found += Rr_UpsertMap(&Map, Keys[GetLookupIndex(Lookup)], NULL) !=
+                     NULL;
+        }
+        Rr_ResetArena(Arena);
+    }
+    double Seconds = GetSeconds() - Start;
+
+    assert(Found == (size_t)FRAME_COUNT * RESOURCE_COUNT * LOOKUPS_PER_NODE);
+    PrintTiming(
+        Name,
+        Seconds,
+        (size_t)FRAME_COUNT * RESOURCE_COUNT * (LOOKUPS_PER_NODE + 1));
+
+    Rr_DestroyArena(Arena);
+}
+
+static void BenchmarkHashMap(const char *Name, Rr_MapKey *Keys)
+{
+    Rr_Arena *Arena = Rr_CreateDefaultArena();
+    size_t Found = 0;
+
+    double Start = GetSeconds();
+    for(size_t Frame = 0; Frame < FRAME_COUNT; ++Frame)
+    {
+        Rr_HashMap Map = { 0 };
+        for(size_t Index = 0; Index < RESOURCE_COUNT; ++Index)
+        {
+            *Rr_UpsertHashMap(&Map, Keys[Index], Arena) = Keys + Index;
+        }
+        for(size_t Lookup = 0; Lookup < RESOURCE_COUNT * LOOKUPS_PER_NODE;
+            ++Lookup)
+        {
+            Found += Rr_UpsertHashMap(
+                         &Map,
+                         Keys[GetLookupIndex(Lookup)],
+                         NULL) != NULL;
+        }
+        Rr_ResetArena(Arena);
+    }
+    double Seconds = GetSeconds() - Start;
+
+    assert(Found == (size_t)FRAME_COUNT * RESOURCE_COUNT * LOOKUPS_PER_NODE);
+    PrintTiming(
+        Name,
+        Seconds,
+        (size_t)FRAME_COUNT * RESOURCE_COUNT * (LOOKUPS_PER_NODE + 1));
+
+    Rr_DestroyArena(Arena);
+}
+
+static void BenchmarkMaps(void)
+{
+    Rr_Arena *KeyArena = Rr_CreateDefaultArena();
+    Rr_MapKey PointerKeys[RESOURCE_COUNT];
+    Rr_MapKey HashKeys[RESOURCE_COUNT];
+    FillPointerKeys(PointerKeys, KeyArena);
+    FillHashKeys(HashKeys);
+
+    BenchmarkTrie("Trie, pointer keys", PointerKeys);
+    BenchmarkHashMap("Hash map, pointer keys", PointerKeys);
+    BenchmarkTrie("Trie, hash keys", HashKeys);
+    BenchmarkHashMap("Hash map, hash keys", HashKeys);
+
+    Rr_DestroyArena(KeyArena);
+}
+
+/* Models long-lived allocations of mixed size freed in any order:
+ * each step frees a random live slot and refills it. */
+
+static size_t GetHeapSize(uint64_t *State, size_t *Slot)
+{
+    *State ^= *State << 13;
+    *State ^= *State >> 7;
+    *State ^= *State << 17;
+    *Slot = (size_t)(*State % HEAP_SLOT_COUNT);
+    return 16 + (size_t)((*State >> 32) % 4096);
+}
+
+static void BenchmarkTLSF(void)
+{
+    Rr_TLSF *TLSF = Rr_CreateDefaultTLSF();
+    void **Slots = Rr_Calloc(HEAP_SLOT_COUNT, sizeof(void *));
+    uint64_t State = 0x9E3779B97F4A7C15ull;
+
+    double Start = GetSeconds();
+    for(size_t Step = 0; Step < HEAP_STEP_COUNT; ++Step)
+    {
+        size_t Slot;
+        size_t Size = GetHeapSize(&State, &Slot);
+        if(Slots[Slot] != NULL)
+        {
+            Rr_FreeTLSF(TLSF, Slots[Slot]);
+        }
+        Slots[Slot] = Rr_AllocTLSF(TLSF, Size);
+    }
+    double Seconds = GetSeconds() - Start;
+
+    PrintTiming("TLSF, alloc + free", Seconds, HEAP_STEP_COUNT);
+
+    Rr_Free(Slots);
+    Rr_DestroyTLSF(TLSF);
+}
+
+static void BenchmarkMalloc(void)
+{
+    void **Slots = Rr_Calloc(HEAP_SLOT_COUNT, sizeof(void *));
+    uint64_t State = 0x9E3779B97F4A7C15ull;
+
+    double Start = GetSeconds();
+    for(size_t Step = 0; Step < HEAP_STEP_COUNT; ++Step)
+    {
+        size_t Slot;
+        size_t Size = GetHeapSize(&State, &Slot);
+        SDL_free(Slots[Slot]);
+        Slots[Slot] = SDL_malloc(Size);
+    }
+    double Seconds = GetSeconds() - Start;
+
+    PrintTiming("SDL_malloc, alloc + free", Seconds, HEAP_STEP_COUNT);
+
+    for(size_t Slot = 0; Slot < HEAP_SLOT_COUNT; ++Slot)
+    {
+        SDL_free(Slots[Slot]);
+    }
+    Rr_Free(Slots);
+}
+
+int main(int ArgC, char **ArgV)
+{
+    Rr_InitPlatform();
+
+    BenchmarkMaps();
+    BenchmarkTLSF();
+    BenchmarkMalloc();
+
+    return 0;
+}
@@ -122,6 +122,7 @@ struct SSortList
 
         Rr_GraphNode *ComputeNode =
             Rr_AddComputeNode(Renderer, "generate_sort_list");
+        Rr_SetComputeNodeAsync(ComputeNode, true);
         Rr_BindComputePipeline(ComputeNode, Pipeline);
         Rr_BindUniformBuffer(
             ComputeNode,
@@ -300,6 +301,7 @@ struct SBitonicSorter
             std::memcpy(Dst, &SortInfo, sizeof(SGPUSortInfo));
 
             Rr_GraphNode *ComputeNode = Rr_AddComputeNode(Renderer, "compute");
+            Rr_SetComputeNodeAsync(ComputeNode, true);
             Rr_BindComputePipeline(ComputeNode, Pipeline);
             Rr_BindStorageBuffer(
                 ComputeNode,
@@ -19,10 +19,47 @@ struct Rr_AppConfig
     void (*IterateFunc)(Rr_App *App, void *UserData);
     void (*FileDroppedFunc)(Rr_App *App, const char *Path);
     void *UserData;
+
+    /* Run without a window, surface and swapchain. Swapchain image
+     * is backed by offscreen images and frames are never presented. */
+    bool Headless;
+    Rr_IntVec2 HeadlessSize;
+
+    /* Record independent graph nodes on worker threads into secondary
+     * command buffers. Zero keeps recording on the main thread. */
+    size_t RecordingThreadCount;
+
+    /* Wait on events set right after the producing graph batch when
+     * results are consumed a few dependency levels later, instead of
+     * a pipeline barrier in front of the consumer. */
+    bool SplitBarriers;
+
+    /* Fail buffer and image allocations that would exceed the heap
+     * budget instead of letting the driver page memory out. Before
+     * failing, GPUMemoryPressureFunc may release streamable assets,
+     * returning true retries the allocation once. */
+    bool GPUMemoryBudget;
+    bool (*GPUMemoryPressureFunc)(Rr_App *App, size_t Size, void *UserData);
+
+    /* File the Vulkan pipeline cache is loaded from on startup and
+     * saved to on shutdown. NULL keeps the cache in memory only. */
+    const char *PipelineCachePath;
+
+    /* Compile pipelines created with the async API on worker threads.
+     * Zero compiles them on the calling thread, so they are ready as
+     * soon as the call returns. */
+    size_t PipelineCompilerThreadCount;
+
+    /* Keep sampled and storage images, samplers and storage buffers
+     * in one global descriptor set indexed from shaders. Ignored
+     * without VK_EXT_descriptor_indexing, see Rr_IsBindlessEnabled. */
+    bool Bindless;
 };
 
 extern void Rr_Run(Rr_AppConfig *Config);
 
+extern void Rr_RequestExit(Rr_App *App);
+
 extern void Rr_SetFrameLimiterEnabled(Rr_App *App, bool Enabled);
 
 extern struct Rr_Renderer *Rr_GetRenderer(Rr_App *App);
@@ -8,6 +8,7 @@ extern "C" {
 
 typedef struct Rr_Buffer Rr_Buffer;
 typedef struct Rr_StagingBuffer Rr_StagingBuffer;
+typedef struct Rr_BufferPool Rr_BufferPool;
 
 typedef enum
 {
@@ -31,6 +32,32 @@ extern Rr_Buffer *Rr_CreateBuffer(
 
 extern void Rr_DestroyBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer);
 
+/* Buffers created from a pool are ranges of a few large VkBuffers.
+ * They share descriptor bindings and synchronization with the rest
+ * of their block, binding one only changes the dynamic offset.
+ * Keep buffers used by async compute nodes in a pool of their own.
+ * Destroy pooled buffers before their pool. Zero BlockSize uses
+ * RR_BUFFER_POOL_BLOCK_SIZE. */
+
+extern Rr_BufferPool *Rr_CreateBufferPool(
+    Rr_Renderer *Renderer,
+    size_t BlockSize,
+    Rr_BufferFlags Flags);
+
+extern void Rr_DestroyBufferPool(Rr_Renderer *Renderer, Rr_BufferPool *Pool);
+
+extern Rr_Buffer *Rr_CreatePooledBuffer(
+    Rr_Renderer *Renderer,
+    Rr_BufferPool *Pool,
+    size_t Size);
+
+/* Only storage buffers get a bindless index, pooled ones describe
+ * just their own range. */
+
+extern uint32_t Rr_GetBufferBindlessIndex(
+    Rr_Renderer *Renderer,
+    Rr_Buffer *Buffer);
+
 extern void *Rr_GetMappedBufferData(Rr_Renderer *Renderer, Rr_Buffer *Buffer);
 
 extern void *Rr_MapBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer);
@@ -91,11 +91,15 @@ struct Rr_Data
 /* Renderer Configuration */
 
 #define RR_FORCE_DISABLE_TRANSFER_QUEUE 0
+#define RR_FORCE_DISABLE_COMPUTE_QUEUE  0
 #define RR_PERFORMANCE_COUNTER          1
 #define RR_MAX_OBJECTS                  128
 #define RR_MAX_FRAME_OVERLAP            3
 #define RR_FRAME_OVERLAP                2
 #define RR_STAGING_BUFFER_SIZE          RR_MEGABYTES(16)
+#define RR_BUFFER_POOL_BLOCK_SIZE       RR_MEGABYTES(16)
+#define RR_MAX_RECORDING_THREADS        16
+#define RR_MAX_COMPILER_THREADS         8
 
 /* Arenas */
 
@@ -104,4 +108,25 @@ struct Rr_Data
 #define RR_SYNC_ARENA_SIZE                RR_MEGABYTES(1)
 #define RR_LOADING_THREAD_ARENA_SIZE      RR_MEGABYTES(1)
 #define RR_MAIN_THREAD_SCRATCH_ARENA_SIZE RR_MEGABYTES(2)
-#define RR_LOADING_THREAD_SCRATCH_SIZE    RR_MEGABYTES(32)
+#define RR_LOADING_THREAD_SCRATCH_SIZE    RR_MEGABYTES(2)
+#define RR_RECORDING_THREAD_SCRATCH_SIZE  RR_MEGABYTES(2)
+#define RR_SCRATCH_ARENA_COUNT            4
+#define RR_PIPELINE_JOB_ARENA_SIZE        RR_KILOBYTES(64)
+
+/* Bindless array sizes, clamped to device limits on startup. */
+
+#define RR_BINDLESS_SAMPLED_IMAGE_COUNT  16384
+#define RR_BINDLESS_STORAGE_IMAGE_COUNT  1024
+#define RR_BINDLESS_SAMPLER_COUNT        256
+#define RR_BINDLESS_STORAGE_BUFFER_COUNT 16384
+#define RR_MAX_PUSH_CONSTANTS_SIZE       128
+
+/* Poison released arena memory when built with AddressSanitizer. */
+
+#define RR_ARENA_POISONING 1
+
+/* Arena resets per decommit window, scratch arenas count every
+ * outermost scratch released. */
+
+#define RR_FRAME_ARENA_DECOMMIT_WINDOW   240
+#define RR_SCRATCH_ARENA_DECOMMIT_WINDOW 4096
@@ -79,6 +79,24 @@ struct Rr_DrawIndirectCommand
     uint32_t FirstInstance;
 };
 
+/* Create an image owned by the current frame graph. Memory is
+ * aliased with other graph images whose lifetimes don't overlap,
+ * contents are undefined at the first use in every frame. */
+
+extern Rr_Image *Rr_CreateGraphImage(
+    Rr_Renderer *Renderer,
+    Rr_IntVec3 Extent,
+    Rr_TextureFormat Format,
+    Rr_ImageFlags Flags);
+
+/* Nodes that don't contribute to the swapchain image, readback
+ * resources or exported resources are culled. Export resources that
+ * are consumed outside of the current frame graph. */
+
+extern void Rr_ExportImage(Rr_Renderer *Renderer, Rr_Image *Image);
+
+extern void Rr_ExportBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer);
+
 extern Rr_GraphNode *Rr_AddTransferNode(
     Rr_Renderer *Renderer,
     const char *Name);
@@ -100,8 +118,29 @@ extern Rr_GraphNode *Rr_AddBlitNode(
     Rr_IntVec4 DstRect,
     Rr_ImageAspect ImageAspect);
 
+/* Blit between single mip levels, e.g. when generating a mip chain.
+ * Only the given levels are tracked so blits into other levels of
+ * the same image aren't serialized with this one. */
+
+extern Rr_GraphNode *Rr_AddMipBlitNode(
+    Rr_Renderer *Renderer,
+    const char *Name,
+    Rr_Image *SrcImage,
+    uint32_t SrcMipLevel,
+    Rr_Image *DstImage,
+    uint32_t DstMipLevel,
+    Rr_IntVec4 SrcRect,
+    Rr_IntVec4 DstRect,
+    Rr_ImageAspect ImageAspect);
+
 extern Rr_GraphNode *Rr_AddComputeNode(Rr_Renderer *Renderer, const char *Name);
 
+/* Allow a compute node to run on the dedicated compute queue.
+ * Falls back to the graphics queue when there is no such queue
+ * or when the node shares resources with graphics work. */
+
+extern void Rr_SetComputeNodeAsync(Rr_GraphNode *Node, bool Async);
+
 extern void Rr_BindComputePipeline(
     Rr_GraphNode *Node,
     Rr_ComputePipeline *ComputePipeline);
@@ -205,6 +244,26 @@ extern void Rr_BindStorageImage(
     uint32_t Set,
     uint32_t Binding);
 
+/* Bindless nodes pass resource indices through push constants and
+ * declare the resources they access with Rr_Use* so the graph can
+ * order and transition them, nothing gets bound. */
+
+extern void Rr_PushConstants(
+    Rr_GraphNode *Node,
+    uint32_t Offset,
+    uint32_t Size,
+    const void *Data);
+
+extern void Rr_UseSampledImage(Rr_GraphNode *Node, Rr_Image *Image);
+
+extern void Rr_UseStorageImage(Rr_GraphNode *Node, Rr_Image *Image);
+
+extern void Rr_UseStorageBuffer(
+    Rr_GraphNode *Node,
+    Rr_Buffer *Buffer,
+    uint32_t Offset,
+    uint32_t Size);
+
 #ifdef __cplusplus
 }
 #endif
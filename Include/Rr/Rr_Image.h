@@ -72,6 +72,8 @@ extern Rr_Sampler *Rr_CreateSampler(
 
 extern void Rr_DestroySampler(Rr_Renderer *Renderer, Rr_Sampler *Sampler);
 
+extern uint32_t Rr_GetSamplerBindlessIndex(Rr_Sampler *Sampler);
+
 typedef struct Rr_Image Rr_Image;
 
 typedef enum
@@ -102,6 +104,17 @@ extern Rr_IntVec2 Rr_GetImageExtent2D(Rr_Image *Image);
 
 extern float Rr_GetImageAspect2D(Rr_Image *Image);
 
+/* Per-frame images have an index per copy, these return the one used
+ * by the current frame. */
+
+extern uint32_t Rr_GetImageBindlessIndex(
+    Rr_Renderer *Renderer,
+    Rr_Image *Image);
+
+extern uint32_t Rr_GetStorageImageBindlessIndex(
+    Rr_Renderer *Renderer,
+    Rr_Image *Image);
+
 extern Rr_Image *Rr_GetDummyColorTexture(Rr_Renderer *Renderer);
 
 extern Rr_Image *Rr_GetDummyNormalTexture(Rr_Renderer *Renderer);
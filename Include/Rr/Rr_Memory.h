@@ -29,6 +29,17 @@ extern void Rr_AlignedFree(void *Ptr);
 #define RR_ARENA_RESERVE_DEFAULT RR_GIGABYTES(8)
 #define RR_ARENA_COMMIT_DEFAULT  RR_KILOBYTES(64)
 
+/* Huge pages are transparent and silently fall back to regular pages
+ * when the platform has none, commits then grow in huge page steps.
+ * Prefaulted arenas touch every page they commit. */
+
+typedef enum
+{
+    RR_ARENA_FLAGS_HUGE_PAGES_BIT = (1 << 0),
+    RR_ARENA_FLAGS_PREFAULT_BIT = (1 << 1),
+} Rr_ArenaFlagsBits;
+typedef uint32_t Rr_ArenaFlags;
+
 typedef struct Rr_Arena Rr_Arena;
 struct Rr_Arena
 {
@@ -37,9 +48,31 @@ struct Rr_Arena
     uintptr_t CommitSize;
     uintptr_t Reserved;
     uintptr_t Commited;
+
+    /* High-water marks, folded in whenever Position moves back. */
+    uintptr_t Peak;
+    uintptr_t WindowPeak;
+
+    /* Resets per decommit window, zero keeps everything committed. */
+    uint32_t DecommitWindow;
+    uint32_t WindowResets;
+
+    Rr_ArenaFlags Flags;
 };
 
-extern Rr_Arena *Rr_CreateArena(size_t Reserve, size_t Commit);
+typedef struct Rr_ArenaStats Rr_ArenaStats;
+struct Rr_ArenaStats
+{
+    size_t Reserved;
+    size_t Committed;
+    size_t Peak;
+    size_t Current;
+};
+
+extern Rr_Arena *Rr_CreateArena(
+    size_t Reserve,
+    size_t Commit,
+    Rr_ArenaFlags Flags);
 
 extern Rr_Arena *Rr_CreateDefaultArena(void);
 
@@ -47,6 +80,13 @@ extern void Rr_ResetArena(Rr_Arena *Arena);
 
 extern void Rr_DestroyArena(Rr_Arena *Arena);
 
+/* Every Resets resets, pages above the high-water mark of that window
+ * are decommitted. */
+
+extern void Rr_SetArenaDecommitWindow(Rr_Arena *Arena, uint32_t Resets);
+
+extern Rr_ArenaStats Rr_GetArenaStats(Rr_Arena *Arena);
+
 extern void *Rr_AllocArenaNoZero(
     Rr_Arena *Arena,
     size_t Size,
@@ -81,10 +121,54 @@ static void Rr_GenericArenaFree(void *Arena, void *Ptr)
 {
 }
 
+/*
+ * Concurrent Arena
+ */
+
+/* Lock-free arena shared between threads. Each thread carves chunks off
+ * a shared atomic position and bumps inside its own chunk, large
+ * requests get a chunk to themselves. Resetting and destroying require
+ * that no thread is allocating. */
+
+#define RR_CONCURRENT_ARENA_CHUNK_DEFAULT RR_KILOBYTES(256)
+
+typedef struct Rr_ConcurrentArena Rr_ConcurrentArena;
+
+extern Rr_ConcurrentArena *Rr_CreateConcurrentArena(
+    size_t Reserve,
+    size_t ChunkSize);
+
+extern Rr_ConcurrentArena *Rr_CreateDefaultConcurrentArena(void);
+
+extern void Rr_ResetConcurrentArena(Rr_ConcurrentArena *Arena);
+
+extern void Rr_DestroyConcurrentArena(Rr_ConcurrentArena *Arena);
+
+extern void *Rr_AllocConcurrentArenaNoZero(
+    Rr_ConcurrentArena *Arena,
+    size_t Size,
+    size_t Align,
+    size_t Count);
+
+extern void *Rr_AllocConcurrentArena(
+    Rr_ConcurrentArena *Arena,
+    size_t Size,
+    size_t Align,
+    size_t Count);
+
+#define RR_CONCURRENT_ALLOC(Arena, Size) \
+    Rr_AllocConcurrentArena(Arena, Size, RR_SAFE_ALIGNMENT, 1)
+#define RR_CONCURRENT_ALLOC_TYPE(Arena, Type) \
+    (Type *)Rr_AllocConcurrentArena(Arena, sizeof(Type), RR_SAFE_ALIGNMENT, 1)
+
 /*
  * Scratch Arena
  */
 
+/* Each thread owns a few scratch arenas. A scratch is taken from the
+ * first arena that is not in the conflict set, which should hold every
+ * arena the caller returns results in. */
+
 typedef struct Rr_Scratch Rr_Scratch;
 struct Rr_Scratch
 {
@@ -98,10 +182,14 @@ extern void Rr_DestroyScratch(Rr_Scratch Scratch);
 
 extern void Rr_SetScratchTLS(void *TLSID);
 
-extern void Rr_InitScratch(size_t Size);
+extern void Rr_InitScratch(size_t Size, size_t Count, Rr_ArenaFlags Flags);
 
 extern Rr_Scratch Rr_GetScratch(Rr_Arena *Conflict);
 
+extern Rr_Scratch Rr_GetScratchAvoiding(
+    size_t ConflictCount,
+    Rr_Arena **Conflicts);
+
 /*
  * Dynamic Slice
  */
@@ -147,6 +235,52 @@ extern void Rr_ResizeSlice(
         (Dst)->Count = (Src)->Count,            \
         memcpy((Dst)->Data, (Src)->Data, sizeof(*(Dst)->Data) * (Src)->Count)
 
+/*
+ * Segmented Slice
+ */
+
+/* Append-only storage whose elements never move. Segment N holds
+ * RR_SEGMENTED_SLICE_BASE << N elements and is allocated on first use,
+ * so growing never copies or abandons arena memory. */
+
+#define RR_SEGMENTED_SLICE_BASE     8
+#define RR_SEGMENTED_SLICE_SEGMENTS 32
+
+#define RR_SEGMENTED_SLICE(Type)                     \
+    struct                                           \
+    {                                                \
+        Type *Segments[RR_SEGMENTED_SLICE_SEGMENTS]; \
+        size_t Count;                                \
+    }
+
+static inline size_t Rr_GetSliceSegment(size_t Index)
+{
+    size_t Block = Index / RR_SEGMENTED_SLICE_BASE + 1;
+    size_t Segment = 0;
+    while(Block >>= 1)
+    {
+        Segment++;
+    }
+    return Segment;
+}
+
+static inline size_t Rr_GetSliceSegmentOffset(size_t Index)
+{
+    size_t Segment = Rr_GetSliceSegment(Index);
+    return Index + RR_SEGMENTED_SLICE_BASE -
+           ((size_t)RR_SEGMENTED_SLICE_BASE << Segment);
+}
+
+extern void Rr_PushSegmentedSlice(void *Slice, size_t Size, Rr_Arena *Arena);
+
+#define RR_AT_SEGMENTED_SLICE(Slice, Index)         \
+    ((Slice)->Segments[Rr_GetSliceSegment(Index)] + \
+     Rr_GetSliceSegmentOffset(Index))
+
+#define RR_PUSH_SEGMENTED_SLICE(Slice, Arena)                              \
+    (Rr_PushSegmentedSlice((Slice), sizeof(**(Slice)->Segments), (Arena)), \
+     RR_AT_SEGMENTED_SLICE((Slice), (Slice)->Count - 1))
+
 /*
  * Hashmap
  */
@@ -169,6 +303,51 @@ extern void **Rr_UpsertMap(Rr_Map **Map, Rr_MapKey Key, Rr_Arena *Arena);
 #define RR_UPSERT_DEREF(Map, Key, Arena) \
     (*(void **)Rr_UpsertMap((Map), (uintptr_t)Key, Arena))
 
+/*
+ * Hash Table
+ */
+
+/* Open addressing in the style of SwissTable. Each slot has a control
+ * byte holding 7 bits of the key hash, probing matches a whole group of
+ * control bytes at once. Unlike Rr_Map, entries can be removed. Storage
+ * comes from the arena passed on insertion, growing leaves the previous
+ * storage in that arena. Value pointers stay valid until the next
+ * insertion. */
+
+#define RR_HASH_MAP_GROUP_SIZE 16
+
+typedef struct Rr_HashMapSlot Rr_HashMapSlot;
+struct Rr_HashMapSlot
+{
+    Rr_MapKey Key;
+    void *Value;
+};
+
+typedef struct Rr_HashMap Rr_HashMap;
+struct Rr_HashMap
+{
+    uint8_t *Control;
+    Rr_HashMapSlot *Slots;
+    size_t Capacity;
+    size_t Count;
+    size_t Tombstones;
+};
+
+/* New entries start with a NULL value. Returns NULL if the key is not
+ * present and Arena is NULL. */
+
+extern void **Rr_UpsertHashMap(
+    Rr_HashMap *Map,
+    Rr_MapKey Key,
+    Rr_Arena *Arena);
+
+extern bool Rr_RemoveHashMap(Rr_HashMap *Map, Rr_MapKey Key);
+
+extern void Rr_ClearHashMap(Rr_HashMap *Map);
+
+#define RR_HASH_UPSERT(Map, Key, Arena) \
+    ((void *)Rr_UpsertHashMap((Map), (uintptr_t)Key, Arena))
+
 /*
  * Free List
  */
@@ -190,6 +369,73 @@ extern void Rr_ReturnFreeListItem(void *FreeList, void *Pointer);
 #define RR_RETURN_FREE_LIST_ITEM(FreeList, Pointer) \
     Rr_ReturnFreeListItem((FreeList), Pointer)
 
+/*
+ * Pool
+ */
+
+/* Slot allocator for fixed-size items. Items are stored by slot index
+ * in segmented storage, so pointers stay valid and live items are
+ * packed next to each other. Freed slots are reused. */
+
+typedef struct Rr_Pool Rr_Pool;
+struct Rr_Pool
+{
+    RR_SEGMENTED_SLICE(char) Items;
+
+    /* Catches double frees. */
+    RR_SEGMENTED_SLICE(bool) LiveSlots;
+
+    /* Free slots are chained through their first bytes, index + 1. */
+    uint32_t FirstFree;
+    size_t LiveCount;
+};
+
+#define RR_POOL(Type)   \
+    struct              \
+    {                   \
+        Rr_Pool Pool;   \
+        Type *SizeHint; \
+    }
+
+/* Returns a zeroed item. */
+
+extern void *Rr_AllocPoolItem(Rr_Pool *Pool, size_t Size, Rr_Arena *Arena);
+
+extern void Rr_FreePoolItem(Rr_Pool *Pool, size_t Size, void *Item);
+
+#define RR_ALLOC_POOL_ITEM(PoolPtr, Arena) \
+    Rr_AllocPoolItem(&(PoolPtr)->Pool, sizeof(*(PoolPtr)->SizeHint), Arena)
+
+#define RR_FREE_POOL_ITEM(PoolPtr, Item) \
+    Rr_FreePoolItem(&(PoolPtr)->Pool, sizeof(*(PoolPtr)->SizeHint), Item)
+
+/*
+ * TLSF Allocator
+ */
+
+/* Two-level segregated fit heap for allocations freed in any order.
+ * Allocation and free are O(1). Blocks are carved from an arena the
+ * heap owns, which grows by at least GrowSize whenever no free block
+ * fits. Memory is aligned to 16 bytes. */
+
+#define RR_TLSF_GROW_DEFAULT RR_MEGABYTES(1)
+
+typedef struct Rr_TLSF Rr_TLSF;
+
+extern Rr_TLSF *Rr_CreateTLSF(size_t Reserve, size_t GrowSize);
+
+extern Rr_TLSF *Rr_CreateDefaultTLSF(void);
+
+extern void Rr_DestroyTLSF(Rr_TLSF *TLSF);
+
+extern void *Rr_AllocTLSF(Rr_TLSF *TLSF, size_t Size);
+
+extern void Rr_FreeTLSF(Rr_TLSF *TLSF, void *Data);
+
+/* Usable size of an allocation, at least the requested size. */
+
+extern size_t Rr_GetTLSFAllocationSize(void *Data);
+
 #ifdef __cplusplus
 }
 #endif
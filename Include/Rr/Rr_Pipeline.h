@@ -209,11 +209,18 @@ struct Rr_PipelineBinding
 };
 
 typedef struct Rr_PipelineBindingSet Rr_PipelineBindingSet;
+/* Push sets are written straight into the command buffer through
+ * VK_KHR_push_descriptor, suited for small sets that change on every
+ * draw. Without the extension, or with more bindings than the device
+ * can push, they are allocated like any other set. A pipeline layout
+ * may have one push set. */
+
 struct Rr_PipelineBindingSet
 {
     size_t BindingCount;
     Rr_PipelineBinding *Bindings;
     Rr_ShaderStage Stages;
+    bool Push;
 };
 
 extern Rr_PipelineLayout *Rr_CreatePipelineLayout(
@@ -221,6 +228,15 @@ extern Rr_PipelineLayout *Rr_CreatePipelineLayout(
     size_t SetCount,
     Rr_PipelineBindingSet *Sets);
 
+/* Layout with the global bindless set as set 0 and PushConstantSize
+ * bytes of push constants for all stages, at most
+ * RR_MAX_PUSH_CONSTANTS_SIZE. Returns NULL unless bindless mode is
+ * enabled. Bind* node functions are not used with these layouts. */
+
+extern Rr_PipelineLayout *Rr_CreateBindlessPipelineLayout(
+    Rr_Renderer *Renderer,
+    size_t PushConstantSize);
+
 extern void Rr_DestroyPipelineLayout(
     Rr_Renderer *Renderer,
     Rr_PipelineLayout *PipelineLayout);
@@ -241,6 +257,30 @@ extern void Rr_DestroyGraphicsPipeline(
     Rr_Renderer *Renderer,
     Rr_GraphicsPipeline *GraphicsPipelin);
 
+/* Async variants return right away and compile on worker threads,
+ * see Rr_AppConfig.PipelineCompilerThreadCount. Shader code is only
+ * read during the call. Graph nodes skip draws
+ * and dispatches until the bound pipeline is ready, so check
+ * readiness to substitute a fallback pipeline instead. Destroying a
+ * pipeline waits for its compilation to finish. */
+
+extern Rr_ComputePipeline *Rr_CreateComputePipelineAsync(
+    Rr_Renderer *Renderer,
+    Rr_ComputePipelineCreateInfo *CreateInfo);
+
+extern Rr_GraphicsPipeline *Rr_CreateGraphicsPipelineAsync(
+    Rr_Renderer *Renderer,
+    Rr_GraphicsPipelineCreateInfo *CreateInfo);
+
+extern bool Rr_IsComputePipelineReady(Rr_ComputePipeline *ComputePipeline);
+
+extern bool Rr_IsGraphicsPipelineReady(Rr_GraphicsPipeline *GraphicsPipeline);
+
+/* Writes the pipeline cache to Rr_AppConfig.PipelineCachePath, which
+ * also happens on shutdown. Returns false without a path. */
+
+extern bool Rr_SavePipelineCache(Rr_Renderer *Renderer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,9 @@ struct Rr_PlatformInfo
 {
     int PageSize;
     int AllocationGranularity;
+
+    /* Zero when transparent huge pages are unavailable. */
+    int HugePageSize;
 };
 
 extern bool Rr_InitPlatform(void);
@@ -19,12 +22,19 @@ extern Rr_PlatformInfo *Rr_GetPlatformInfo(void);
 
 extern void *Rr_ReserveMemory(size_t Size);
 
+/* Reserve aligned to PlatformInfo.HugePageSize, backed by transparent
+ * huge pages as it gets committed. */
+
+extern void *Rr_ReserveHugeMemory(size_t Size);
+
 extern void Rr_ReleaseMemory(void *Data, size_t Size);
 
 extern bool Rr_CommitMemory(void *Data, size_t Size);
 
 extern void Rr_DecommitMemory(void *Data, size_t Size);
 
+extern void Rr_PrefaultMemory(void *Data, size_t Size);
+
 typedef struct Rr_AtomicInt Rr_AtomicInt;
 struct Rr_AtomicInt
 {
@@ -99,6 +99,44 @@ typedef enum
     RR_PRESENT_MODE_MAILBOX,
 } Rr_PresentMode;
 
+typedef enum
+{
+    RR_GPU_MEMORY_CATEGORY_BUFFER,
+    RR_GPU_MEMORY_CATEGORY_IMAGE,
+    RR_GPU_MEMORY_CATEGORY_STAGING,
+    RR_GPU_MEMORY_CATEGORY_PER_FRAME_COPIES,
+    RR_GPU_MEMORY_CATEGORY_TRANSIENT,
+    RR_GPU_MEMORY_CATEGORY_COUNT,
+} Rr_GPUMemoryCategory;
+
+#define RR_MAX_GPU_MEMORY_HEAPS 16
+
+typedef struct Rr_GPUMemoryHeap Rr_GPUMemoryHeap;
+struct Rr_GPUMemoryHeap
+{
+    uint64_t Size;
+    uint64_t Budget;
+    uint64_t Usage;
+    uint64_t AllocatedBytes;
+    uint64_t BlockBytes;
+    bool DeviceLocal;
+};
+
+typedef struct Rr_GPUMemoryStats Rr_GPUMemoryStats;
+struct Rr_GPUMemoryStats
+{
+    size_t HeapCount;
+    Rr_GPUMemoryHeap Heaps[RR_MAX_GPU_MEMORY_HEAPS];
+
+    /* Additional copies of per-frame buffers and images are counted
+     * separately from the first copy. */
+    uint64_t CategoryBytes[RR_GPU_MEMORY_CATEGORY_COUNT];
+
+    /* Budget and usage come from VK_EXT_memory_budget, without it
+     * they are estimated from the heap size and own allocations. */
+    bool HasMemoryBudget;
+};
+
 extern struct Rr_Graph *Rr_GetGraph(Rr_Renderer *Renderer);
 
 extern Rr_Arena *Rr_GetFrameArena(Rr_Renderer *Renderer);
@@ -121,6 +159,23 @@ extern size_t Rr_GetMaxComputeSharedMemorySize(Rr_Renderer *Renderer);
 
 extern size_t Rr_GetMaxComputeWorkgroupInvocations(Rr_Renderer *Renderer);
 
+extern Rr_GPUMemoryStats Rr_GetGPUMemoryStats(Rr_Renderer *Renderer);
+
+/* Bindless mode keeps a global descriptor set bound as set 0 of
+ * layouts from Rr_CreateBindlessPipelineLayout:
+ *
+ * binding 0: texture2D[]  sampled images
+ * binding 1: image2D[]    storage images
+ * binding 2: sampler[]    samplers
+ * binding 3: buffer[]     storage buffers
+ *
+ * Resources get their indices on creation, pass them to shaders with
+ * Rr_PushConstants. Index zero is never handed out. */
+
+#define RR_BINDLESS_INVALID_INDEX 0
+
+extern bool Rr_IsBindlessEnabled(Rr_Renderer *Renderer);
+
 #ifdef __cplusplus
 }
 #endif
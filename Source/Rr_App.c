@@ -174,9 +174,17 @@ static void Rr_InitFrameTime(Rr_FrameTime *FrameTime, SDL_Window *Window)
         (double)SDL_GetPerformanceFrequency();
 #endif
 
-    SDL_DisplayID DisplayID = SDL_GetDisplayForWindow(Window);
+    SDL_DisplayID DisplayID = SDL_GetPrimaryDisplay();
+    if(Window != NULL)
+    {
+        DisplayID = SDL_GetDisplayForWindow(Window);
+    }
     const SDL_DisplayMode *Mode = SDL_GetDesktopDisplayMode(DisplayID);
-    FrameTime->TargetFramerate = (uint64_t)Mode->refresh_rate;
+    FrameTime->TargetFramerate = 60;
+    if(Mode != NULL && Mode->refresh_rate > 0.0f)
+    {
+        FrameTime->TargetFramerate = (uint64_t)Mode->refresh_rate;
+    }
     FrameTime->StartTime = SDL_GetTicksNS();
 
     FrameTime->Now = SDL_GetPerformanceCounter();
@@ -205,27 +213,39 @@ void Rr_Run(Rr_AppConfig *Config)
 
     SDL_SetAppMetadata(Config->Title, Config->Version, Config->Package);
     SDL_SetLogPriorities(SDL_LOG_PRIORITY_CRITICAL);
+    if(Config->Headless)
+    {
+        /* Vulkan library is still loaded through SDL but
+         * no display server is required. */
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    }
     SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
 
     SDL_Vulkan_LoadLibrary(NULL);
 
-    Rr_IntVec2 WindowSize = Rr_GetDefaultWindowSize();
-
     Rr_App App = (Rr_App){ 0 };
     App.Config = Config;
-    App.Window = SDL_CreateWindow(
-        Config->Title,
-        WindowSize.Width,
-        WindowSize.Height,
-        SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIDDEN |
-            SDL_WINDOW_HIGH_PIXEL_DENSITY);
+    if(Config->Headless == false)
+    {
+        Rr_IntVec2 WindowSize = Rr_GetDefaultWindowSize();
+
+        App.Window = SDL_CreateWindow(
+            Config->Title,
+            WindowSize.Width,
+            WindowSize.Height,
+            SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIDDEN |
+                SDL_WINDOW_HIGH_PIXEL_DENSITY);
+    }
     App.Arena = Rr_CreateDefaultArena();
-    App.SyncArena = Rr_CreateSyncArena();
+    App.LoadArena = Rr_CreateDefaultConcurrentArena();
     App.UserData = Config->UserData;
 
     Rr_SetScratchTLS(&App.ScratchArenaTLS);
 
-    Rr_InitScratch(RR_MAIN_THREAD_SCRATCH_ARENA_SIZE);
+    Rr_InitScratch(
+        RR_MAIN_THREAD_SCRATCH_ARENA_SIZE,
+        RR_SCRATCH_ARENA_COUNT,
+        0);
 
     Rr_InitFrameTime(&App.FrameTime, App.Window);
 
@@ -239,7 +259,10 @@ void Rr_Run(Rr_AppConfig *Config)
 
     Config->InitFunc(&App, App.UserData);
 
-    SDL_ShowWindow(App.Window);
+    if(App.Window != NULL)
+    {
+        SDL_ShowWindow(App.Window);
+    }
 
     while(SDL_GetAtomicInt(&App.ExitRequested) == false)
     {
@@ -271,16 +294,24 @@ void Rr_Run(Rr_AppConfig *Config)
     Rr_DestroyRenderer(&App, App.Renderer);
 
     Rr_DestroyArena(App.Arena);
-    Rr_DestroySyncArena(&App.SyncArena);
+    Rr_DestroyConcurrentArena(App.LoadArena);
 
     SDL_CleanupTLS();
 
     SDL_RemoveEventWatch((SDL_EventFilter)Rr_EventWatch, &App);
-    SDL_DestroyWindow(App.Window);
+    if(App.Window != NULL)
+    {
+        SDL_DestroyWindow(App.Window);
+    }
 
     SDL_Quit();
 }
 
+void Rr_RequestExit(Rr_App *App)
+{
+    SDL_SetAtomicInt(&App->ExitRequested, true);
+}
+
 void Rr_SetFrameLimiterEnabled(Rr_App *App, bool Enabled)
 {
     App->FrameTime.EnableFrameLimiter = Enabled;
@@ -48,7 +48,9 @@ struct Rr_App
     SDL_Window *Window;
     SDL_AtomicInt ExitRequested;
 
-    Rr_SyncArena SyncArena;
+    Rr_ConcurrentArena *LoadArena;
 
     Rr_Arena *Arena;
 };
+
+extern Rr_IntVec2 Rr_GetDefaultWindowSize(void);
@@ -1,54 +1,59 @@
 #include "Rr_Buffer.h"
 
+#include "Rr_Log.h"
 #include "Rr_Renderer.h"
 #include "Rr_UploadContext.h"
 
 #include <assert.h>
 
-Rr_Buffer *Rr_CreateBuffer(
-    Rr_Renderer *Renderer,
-    size_t Size,
-    Rr_BufferFlags Flags)
+static Rr_GPUMemoryCategory Rr_GetBufferMemoryCategory(
+    Rr_BufferFlags Flags,
+    size_t AllocatedIndex)
 {
-    Rr_Buffer *Buffer =
-        RR_GET_FREE_LIST_ITEM(&Renderer->Buffers, Renderer->Arena);
-    Buffer->Flags = Flags;
+    if(AllocatedIndex > 0)
+    {
+        return RR_GPU_MEMORY_CATEGORY_PER_FRAME_COPIES;
+    }
+    if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_STAGING_BIT) ||
+       RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_STAGING_INCOHERENT_BIT))
+    {
+        return RR_GPU_MEMORY_CATEGORY_STAGING;
+    }
+    return RR_GPU_MEMORY_CATEGORY_BUFFER;
+}
 
-    Buffer->Usage = 0;
+static VkBufferUsageFlags Rr_GetBufferUsage(Rr_BufferFlags Flags)
+{
+    VkBufferUsageFlags Usage = 0;
     if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_UNIFORM_BIT))
     {
-        Buffer->Usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+        Usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
     }
     if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_STORAGE_BIT))
     {
-        Buffer->Usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        Usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     }
     if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_VERTEX_BIT))
     {
-        Buffer->Usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        Usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
     }
     if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_INDEX_BIT))
     {
-        Buffer->Usage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        Usage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
     }
     if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_INDIRECT_BIT))
     {
-        Buffer->Usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        Usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
     }
-    Buffer->Usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    Buffer->Usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-
-    /* Fixing VMA issues with small buffers. */
-
-    Size = SDL_max(Size, 128);
-
-    VkBufferCreateInfo BufferCreateInfo = {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .pNext = NULL,
-        .size = Size,
-        .usage = Buffer->Usage,
-    };
+    Usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    Usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    return Usage;
+}
 
+static VmaAllocationCreateInfo Rr_GetBufferAllocationCreateInfo(
+    Rr_Renderer *Renderer,
+    Rr_BufferFlags Flags)
+{
     VmaAllocationCreateInfo AllocationInfo = { 0 };
     AllocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
 
@@ -80,22 +85,163 @@ Rr_Buffer *Rr_CreateBuffer(
         AllocationInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
     }
 
-    Buffer->AllocatedBufferCount = 1;
+    /* Staging buffers live only until their upload completes and the
+     * upload paths have no way to back out, so they stay outside the
+     * budget like the transient graph heaps. */
+
+    if(Renderer->EnforcesMemoryBudget &&
+       RR_HAS_BIT(
+           Flags,
+           (RR_BUFFER_FLAGS_STAGING_BIT |
+            RR_BUFFER_FLAGS_STAGING_INCOHERENT_BIT)) == false)
+    {
+        AllocationInfo.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+    }
+
+    return AllocationInfo;
+}
+
+static size_t Rr_GetBufferCopyCount(Rr_BufferFlags Flags)
+{
     if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_PER_FRAME_BIT))
     {
-        Buffer->AllocatedBufferCount = RR_FRAME_OVERLAP;
+        return RR_FRAME_OVERLAP;
     }
-    for(size_t Index = 0; Index < Buffer->AllocatedBufferCount; ++Index)
+    return 1;
+}
+
+static bool Rr_AllocateBuffer(
+    Rr_Renderer *Renderer,
+    VkBufferCreateInfo *BufferCreateInfo,
+    VmaAllocationCreateInfo *AllocationCreateInfo,
+    Rr_AllocatedBuffer *AllocatedBuffer)
+{
+    VkResult Result = vmaCreateBuffer(
+        Renderer->Allocator,
+        BufferCreateInfo,
+        AllocationCreateInfo,
+        &AllocatedBuffer->Handle,
+        &AllocatedBuffer->Allocation,
+        &AllocatedBuffer->AllocationInfo);
+    if(Result == VK_ERROR_OUT_OF_DEVICE_MEMORY &&
+       RR_HAS_BIT(
+           AllocationCreateInfo->flags,
+           VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT) &&
+       Rr_RelieveGPUMemoryPressure(Renderer, BufferCreateInfo->size))
     {
-        Rr_AllocatedBuffer *AllocatedBuffer = &Buffer->AllocatedBuffers[Index];
-        vmaCreateBuffer(
+        Result = vmaCreateBuffer(
             Renderer->Allocator,
-            &BufferCreateInfo,
-            &AllocationInfo,
+            BufferCreateInfo,
+            AllocationCreateInfo,
             &AllocatedBuffer->Handle,
             &AllocatedBuffer->Allocation,
             &AllocatedBuffer->AllocationInfo);
     }
+    if(Result != VK_SUCCESS)
+    {
+        RR_LOG(
+            "Failed to allocate buffer of %zu bytes.",
+            (size_t)BufferCreateInfo->size);
+        return false;
+    }
+
+    AllocatedBuffer->Offset = 0;
+
+    return true;
+}
+
+static void Rr_AddBindlessBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
+{
+    if(Renderer->UsesBindless == false ||
+       RR_HAS_BIT(Buffer->Flags, RR_BUFFER_FLAGS_STORAGE_BIT) == false)
+    {
+        return;
+    }
+
+    for(size_t Index = 0; Index < Buffer->AllocatedBufferCount; ++Index)
+    {
+        Rr_AllocatedBuffer *AllocatedBuffer = &Buffer->AllocatedBuffers[Index];
+        AllocatedBuffer->BindlessIndex = Rr_AllocateBindlessIndex(
+            &Renderer->Bindless,
+            RR_BINDLESS_BINDING_STORAGE_BUFFER);
+        if(AllocatedBuffer->BindlessIndex != RR_BINDLESS_INVALID_INDEX)
+        {
+            Rr_WriteBindlessBuffer(
+                &Renderer->Bindless,
+                &Renderer->Device,
+                AllocatedBuffer->BindlessIndex,
+                AllocatedBuffer->Handle,
+                AllocatedBuffer->Offset,
+                Buffer->Size);
+        }
+    }
+}
+
+static void Rr_RemoveBindlessBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
+{
+    if(Renderer->UsesBindless == false)
+    {
+        return;
+    }
+
+    for(size_t Index = 0; Index < Buffer->AllocatedBufferCount; ++Index)
+    {
+        Rr_ReleaseBindlessIndex(
+            &Renderer->Bindless,
+            RR_BINDLESS_BINDING_STORAGE_BUFFER,
+            Buffer->AllocatedBuffers[Index].BindlessIndex,
+            Renderer->FrameNumber);
+    }
+}
+
+Rr_Buffer *Rr_CreateBuffer(
+    Rr_Renderer *Renderer,
+    size_t Size,
+    Rr_BufferFlags Flags)
+{
+    Rr_Buffer *Buffer =
+        RR_ALLOC_POOL_ITEM(&Renderer->Buffers, Renderer->Arena);
+    Buffer->Flags = Flags;
+    Buffer->Size = Size;
+    Buffer->Usage = Rr_GetBufferUsage(Flags);
+
+    /* Fixing VMA issues with small buffers. */
+
+    Size = SDL_max(Size, 128);
+
+    VkBufferCreateInfo BufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = NULL,
+        .size = Size,
+        .usage = Buffer->Usage,
+    };
+
+    VmaAllocationCreateInfo AllocationInfo =
+        Rr_GetBufferAllocationCreateInfo(Renderer, Flags);
+
+    Buffer->AllocatedBufferCount = Rr_GetBufferCopyCount(Flags);
+    for(size_t Index = 0; Index < Buffer->AllocatedBufferCount; ++Index)
+    {
+        Rr_AllocatedBuffer *AllocatedBuffer = &Buffer->AllocatedBuffers[Index];
+        if(Rr_AllocateBuffer(
+               Renderer,
+               &BufferCreateInfo,
+               &AllocationInfo,
+               AllocatedBuffer) == false)
+        {
+            Buffer->AllocatedBufferCount = Index;
+            Rr_DestroyBuffer(Renderer, Buffer);
+            return NULL;
+        }
+
+        Rr_TrackGPUMemory(
+            Renderer,
+            Rr_GetBufferMemoryCategory(Flags, Index),
+            AllocatedBuffer->AllocationInfo.size,
+            true);
+    }
+
+    Rr_AddBindlessBuffer(Renderer, Buffer);
 
     return Buffer;
 }
@@ -107,16 +253,237 @@ void Rr_DestroyBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
         return;
     }
 
+    /* Pooled buffers only give their range back, the block stays
+     * alive until the pool is destroyed. */
+
+    Rr_RemoveBindlessBuffer(Renderer, Buffer);
+
+    if(Buffer->Pool != NULL)
+    {
+        vmaVirtualFree(Buffer->Block->VirtualBlock, Buffer->VirtualAllocation);
+        RR_FREE_POOL_ITEM(&Renderer->Buffers, Buffer);
+        return;
+    }
+
     for(size_t Index = 0; Index < Buffer->AllocatedBufferCount; ++Index)
     {
         Rr_AllocatedBuffer *AllocatedBuffer = &Buffer->AllocatedBuffers[Index];
+        Rr_TrackGPUMemory(
+            Renderer,
+            Rr_GetBufferMemoryCategory(Buffer->Flags, Index),
+            AllocatedBuffer->AllocationInfo.size,
+            false);
         vmaDestroyBuffer(
             Renderer->Allocator,
             AllocatedBuffer->Handle,
             AllocatedBuffer->Allocation);
     }
 
-    RR_RETURN_FREE_LIST_ITEM(&Renderer->Buffers, Buffer);
+    RR_FREE_POOL_ITEM(&Renderer->Buffers, Buffer);
+}
+
+Rr_BufferPool *Rr_CreateBufferPool(
+    Rr_Renderer *Renderer,
+    size_t BlockSize,
+    Rr_BufferFlags Flags)
+{
+    Rr_BufferPool *Pool =
+        RR_ALLOC_POOL_ITEM(&Renderer->BufferPools, Renderer->Arena);
+    Pool->Flags = Flags;
+    Pool->BlockSize = BlockSize != 0 ? BlockSize : RR_BUFFER_POOL_BLOCK_SIZE;
+    Pool->Arena = Rr_CreateDefaultArena();
+
+    /* Every range has to be usable as a dynamic offset or flushed on
+     * its own. */
+
+    VkPhysicalDeviceLimits *Limits =
+        &Renderer->PhysicalDevice.Properties.properties.limits;
+    Pool->Alignment = RR_SAFE_ALIGNMENT;
+    if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_UNIFORM_BIT))
+    {
+        Pool->Alignment =
+            RR_MAX(Pool->Alignment, Limits->minUniformBufferOffsetAlignment);
+    }
+    if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_STORAGE_BIT))
+    {
+        Pool->Alignment =
+            RR_MAX(Pool->Alignment, Limits->minStorageBufferOffsetAlignment);
+    }
+    if(RR_HAS_BIT(Flags, RR_BUFFER_FLAGS_STAGING_INCOHERENT_BIT))
+    {
+        Pool->Alignment = RR_MAX(Pool->Alignment, Limits->nonCoherentAtomSize);
+    }
+
+    return Pool;
+}
+
+void Rr_DestroyBufferPool(Rr_Renderer *Renderer, Rr_BufferPool *Pool)
+{
+    if(Pool == NULL)
+    {
+        return;
+    }
+
+    for(size_t Index = 0; Index < Pool->Blocks.Count; ++Index)
+    {
+        Rr_BufferPoolBlock *Block = RR_AT_SEGMENTED_SLICE(&Pool->Blocks, Index);
+        for(size_t CopyIndex = 0; CopyIndex < Block->AllocatedBufferCount;
+            ++CopyIndex)
+        {
+            Rr_AllocatedBuffer *AllocatedBuffer =
+                Block->AllocatedBuffers + CopyIndex;
+            Rr_TrackGPUMemory(
+                Renderer,
+                Rr_GetBufferMemoryCategory(Pool->Flags, CopyIndex),
+                AllocatedBuffer->AllocationInfo.size,
+                false);
+            vmaDestroyBuffer(
+                Renderer->Allocator,
+                AllocatedBuffer->Handle,
+                AllocatedBuffer->Allocation);
+        }
+        vmaDestroyVirtualBlock(Block->VirtualBlock);
+    }
+
+    Rr_DestroyArena(Pool->Arena);
+
+    RR_FREE_POOL_ITEM(&Renderer->BufferPools, Pool);
+}
+
+static Rr_BufferPoolBlock *Rr_CreateBufferPoolBlock(
+    Rr_Renderer *Renderer,
+    Rr_BufferPool *Pool,
+    size_t Size)
+{
+    Rr_BufferPoolBlock Block = {
+        .AllocatedBufferCount = Rr_GetBufferCopyCount(Pool->Flags),
+    };
+
+    VkBufferCreateInfo BufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = NULL,
+        .size = Size,
+        .usage = Rr_GetBufferUsage(Pool->Flags),
+    };
+
+    VmaAllocationCreateInfo AllocationInfo =
+        Rr_GetBufferAllocationCreateInfo(Renderer, Pool->Flags);
+
+    for(size_t Index = 0; Index < Block.AllocatedBufferCount; ++Index)
+    {
+        Rr_AllocatedBuffer *AllocatedBuffer = Block.AllocatedBuffers + Index;
+        if(Rr_AllocateBuffer(
+               Renderer,
+               &BufferCreateInfo,
+               &AllocationInfo,
+               AllocatedBuffer) == false)
+        {
+            for(size_t Created = 0; Created < Index; ++Created)
+            {
+                Rr_TrackGPUMemory(
+                    Renderer,
+                    Rr_GetBufferMemoryCategory(Pool->Flags, Created),
+                    Block.AllocatedBuffers[Created].AllocationInfo.size,
+                    false);
+                vmaDestroyBuffer(
+                    Renderer->Allocator,
+                    Block.AllocatedBuffers[Created].Handle,
+                    Block.AllocatedBuffers[Created].Allocation);
+            }
+            return NULL;
+        }
+
+        Rr_TrackGPUMemory(
+            Renderer,
+            Rr_GetBufferMemoryCategory(Pool->Flags, Index),
+            AllocatedBuffer->AllocationInfo.size,
+            true);
+    }
+
+    VmaVirtualBlockCreateInfo VirtualBlockCreateInfo = {
+        .size = Size,
+    };
+    vmaCreateVirtualBlock(&VirtualBlockCreateInfo, &Block.VirtualBlock);
+
+    Rr_BufferPoolBlock *NewBlock =
+        RR_PUSH_SEGMENTED_SLICE(&Pool->Blocks, Pool->Arena);
+    *NewBlock = Block;
+
+    return NewBlock;
+}
+
+Rr_Buffer *Rr_CreatePooledBuffer(
+    Rr_Renderer *Renderer,
+    Rr_BufferPool *Pool,
+    size_t Size)
+{
+    VmaVirtualAllocationCreateInfo VirtualAllocationCreateInfo = {
+        .size = Size,
+        .alignment = Pool->Alignment,
+    };
+    VmaVirtualAllocation VirtualAllocation;
+    VkDeviceSize Offset;
+
+    Rr_BufferPoolBlock *Block = NULL;
+    for(size_t Index = 0; Index < Pool->Blocks.Count; ++Index)
+    {
+        Rr_BufferPoolBlock *Candidate =
+            RR_AT_SEGMENTED_SLICE(&Pool->Blocks, Index);
+        if(vmaVirtualAllocate(
+               Candidate->VirtualBlock,
+               &VirtualAllocationCreateInfo,
+               &VirtualAllocation,
+               &Offset) == VK_SUCCESS)
+        {
+            Block = Candidate;
+            break;
+        }
+    }
+
+    if(Block == NULL)
+    {
+        Block = Rr_CreateBufferPoolBlock(
+            Renderer,
+            Pool,
+            RR_MAX(Pool->BlockSize, Size));
+        if(Block == NULL)
+        {
+            return NULL;
+        }
+        vmaVirtualAllocate(
+            Block->VirtualBlock,
+            &VirtualAllocationCreateInfo,
+            &VirtualAllocation,
+            &Offset);
+    }
+
+    Rr_Buffer *Buffer =
+        RR_ALLOC_POOL_ITEM(&Renderer->Buffers, Renderer->Arena);
+    Buffer->Flags = Pool->Flags;
+    Buffer->Usage = Rr_GetBufferUsage(Pool->Flags);
+    Buffer->Size = Size;
+    Buffer->Pool = Pool;
+    Buffer->Block = Block;
+    Buffer->VirtualAllocation = VirtualAllocation;
+
+    Buffer->AllocatedBufferCount = Block->AllocatedBufferCount;
+    for(size_t Index = 0; Index < Buffer->AllocatedBufferCount; ++Index)
+    {
+        Rr_AllocatedBuffer *AllocatedBuffer = Buffer->AllocatedBuffers + Index;
+        *AllocatedBuffer = Block->AllocatedBuffers[Index];
+        AllocatedBuffer->Offset = Offset;
+        AllocatedBuffer->AllocationInfo.offset += Offset;
+        AllocatedBuffer->AllocationInfo.size = Size;
+        if(AllocatedBuffer->AllocationInfo.pMappedData != NULL)
+        {
+            AllocatedBuffer->AllocationInfo.pMappedData =
+                (char *)AllocatedBuffer->AllocationInfo.pMappedData + Offset;
+        }
+    }
+
+    Rr_AddBindlessBuffer(Renderer, Buffer);
+
+    return Buffer;
 }
 
 void *Rr_GetMappedBufferData(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
@@ -136,7 +503,7 @@ void *Rr_MapBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
     }
     void *MappedData;
     vmaMapMemory(Renderer->Allocator, AllocatedBuffer->Allocation, &MappedData);
-    return MappedData;
+    return (char *)MappedData + AllocatedBuffer->Offset;
 }
 
 void Rr_UnmapBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
@@ -161,7 +528,7 @@ void Rr_FlushBufferRange(
     vmaFlushAllocation(
         Renderer->Allocator,
         AllocatedBuffer->Allocation,
-        Offset,
+        AllocatedBuffer->Offset + Offset,
         Size);
 }
 
@@ -211,9 +578,11 @@ void Rr_UploadStagingBuffer(
             0,
             NULL);
 
-        VkBufferCopy Copy = { .size = StagingSize,
-                              .srcOffset = StagingOffset,
-                              .dstOffset = 0 };
+        VkBufferCopy Copy = {
+            .size = StagingSize,
+            .srcOffset = AllocatedStagingBuffer->Offset + StagingOffset,
+            .dstOffset = AllocatedBuffer->Offset,
+        };
 
         Device->CmdCopyBuffer(
             CommandBuffer,
@@ -291,6 +660,10 @@ void Rr_UploadBuffer(
         Renderer,
         Data.Size,
         RR_BUFFER_FLAGS_STAGING_BIT | RR_BUFFER_FLAGS_MAPPED_BIT);
+    if(StagingBuffer == NULL)
+    {
+        RR_ABORT("Failed to allocate staging buffer!");
+    }
     *RR_PUSH_SLICE(&UploadContext->StagingBuffers, UploadContext->Arena) =
         StagingBuffer;
 
@@ -327,6 +700,10 @@ void Rr_UploadToDeviceBufferImmediate(
         Renderer,
         Data.Size,
         RR_BUFFER_FLAGS_STAGING_BIT | RR_BUFFER_FLAGS_MAPPED_BIT);
+    if(SrcBuffer == NULL)
+    {
+        RR_ABORT("Failed to allocate staging buffer!");
+    }
     Rr_AllocatedBuffer *SrcAllocatedBuffer =
         Rr_GetCurrentAllocatedBuffer(Renderer, SrcBuffer);
     memcpy(
@@ -334,16 +711,15 @@ void Rr_UploadToDeviceBufferImmediate(
         Data.Pointer,
         Data.Size);
 
-    VkBufferCopy BufferCopy = {
-        .dstOffset = 0,
-        .size = Data.Size,
-        .srcOffset = 0,
-    };
-
     for(size_t Index = 0; Index < DstBuffer->AllocatedBufferCount; ++Index)
     {
         Rr_AllocatedBuffer *DstAllocatedBuffer =
             &DstBuffer->AllocatedBuffers[Index];
+        VkBufferCopy BufferCopy = {
+            .dstOffset = DstAllocatedBuffer->Offset,
+            .size = Data.Size,
+            .srcOffset = SrcAllocatedBuffer->Offset,
+        };
         Device->CmdCopyBuffer(
             CommandBuffer,
             SrcAllocatedBuffer->Handle,
@@ -357,6 +733,11 @@ void Rr_UploadToDeviceBufferImmediate(
     Rr_DestroyBuffer(Renderer, SrcBuffer);
 }
 
+uint32_t Rr_GetBufferBindlessIndex(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
+{
+    return Rr_GetCurrentAllocatedBuffer(Renderer, Buffer)->BindlessIndex;
+}
+
 Rr_AllocatedBuffer *Rr_GetCurrentAllocatedBuffer(
     Rr_Renderer *Renderer,
     Rr_Buffer *Buffer)
@@ -11,14 +11,45 @@ struct Rr_AllocatedBuffer
     VkBuffer Handle;
     VmaAllocationInfo AllocationInfo;
     VmaAllocation Allocation;
+
+    /* Start of the buffer within Handle, nonzero for pooled buffers.
+     * Allocation and AllocationInfo then describe the whole block,
+     * except for pMappedData, offset and size. */
+    VkDeviceSize Offset;
+
+    /* Bindless index of storage buffers. */
+    uint32_t BindlessIndex;
+};
+
+typedef struct Rr_BufferPoolBlock Rr_BufferPoolBlock;
+struct Rr_BufferPoolBlock
+{
+    VmaVirtualBlock VirtualBlock;
+    size_t AllocatedBufferCount;
+    Rr_AllocatedBuffer AllocatedBuffers[RR_MAX_FRAME_OVERLAP];
+};
+
+struct Rr_BufferPool
+{
+    Rr_BufferFlags Flags;
+    size_t BlockSize;
+    size_t Alignment;
+    RR_SEGMENTED_SLICE(Rr_BufferPoolBlock) Blocks;
+    Rr_Arena *Arena;
 };
 
 struct Rr_Buffer
 {
     Rr_BufferFlags Flags;
     VkBufferUsageFlags Usage;
+    size_t Size;
     size_t AllocatedBufferCount;
     Rr_AllocatedBuffer AllocatedBuffers[RR_MAX_FRAME_OVERLAP];
+
+    /* Set for buffers suballocated from a pool. */
+    Rr_BufferPool *Pool;
+    Rr_BufferPoolBlock *Block;
+    VmaVirtualAllocation VirtualAllocation;
 };
 
 extern void Rr_UploadStagingBuffer(
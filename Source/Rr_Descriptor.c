@@ -3,8 +3,11 @@
 #include "Rr_Log.h"
 #include "Rr_Pipeline.h"
 
+#include <assert.h>
 #include <string.h>
 
+#include <xxHash/xxhash.h>
+
 static VkDescriptorType Rr_GetVulkanDescriptorType(Rr_PipelineBindingType Type)
 {
     switch(Type)
@@ -26,6 +29,20 @@ static VkDescriptorType Rr_GetVulkanDescriptorType(Rr_PipelineBindingType Type)
     }
 }
 
+static VkDescriptorType Rr_GetVulkanPushDescriptorType(
+    Rr_PipelineBindingType Type)
+{
+    switch(Type)
+    {
+        case RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER:
+            return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        case RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER:
+            return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        default:
+            return Rr_GetVulkanDescriptorType(Type);
+    }
+}
+
 static VkDescriptorPool Rr_CreateDescriptorPool(
     Rr_Device *Device,
     size_t SetCount,
@@ -109,6 +126,9 @@ void Rr_ResetDescriptorAllocator(
         *RR_PUSH_SLICE(&DescriptorAllocator->ReadyPools, NULL) = FullPool;
     }
     RR_EMPTY_SLICE(&DescriptorAllocator->FullPools);
+
+    Rr_ClearHashMap(&DescriptorAllocator->SetCache);
+    RR_EMPTY_SLICE(&DescriptorAllocator->SetCacheEntries);
 }
 
 void Rr_DestroyDescriptorAllocator(
@@ -395,7 +415,8 @@ void Rr_AddDescriptor(
     }
     Builder->Bindings[Builder->Count] = (VkDescriptorSetLayoutBinding){
         .binding = Binding,
-        .descriptorType = Rr_GetVulkanDescriptorType(Type),
+        .descriptorType = Builder->Push ? Rr_GetVulkanPushDescriptorType(Type)
+                                        : Rr_GetVulkanDescriptorType(Type),
         .descriptorCount = 1,
         .stageFlags = Rr_GetVulkanShaderStageFlags(ShaderStage)
     };
@@ -415,7 +436,8 @@ void Rr_AddDescriptorArray(
     }
     Builder->Bindings[Builder->Count] = (VkDescriptorSetLayoutBinding){
         .binding = Binding,
-        .descriptorType = Rr_GetVulkanDescriptorType(Type),
+        .descriptorType = Builder->Push ? Rr_GetVulkanPushDescriptorType(Type)
+                                        : Rr_GetVulkanDescriptorType(Type),
         .descriptorCount = Count,
         .stageFlags = Rr_GetVulkanShaderStageFlags(ShaderStage)
     };
@@ -433,7 +455,9 @@ VkDescriptorSetLayout Rr_BuildDescriptorLayout(
 {
     VkDescriptorSetLayoutCreateInfo Info = {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .flags = 0,
+        .flags = Builder->Push
+                     ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR
+                     : 0,
         .bindingCount = Builder->Count,
         .pBindings = Builder->Bindings,
     };
@@ -448,10 +472,73 @@ VkDescriptorSetLayout Rr_BuildDescriptorLayout(
     return DescriptorSetLayout;
 }
 
+VkDescriptorUpdateTemplate Rr_CreatePushDescriptorTemplate(
+    Rr_Device *Device,
+    Rr_PipelineBindingSet *Set,
+    VkDescriptorSetLayout Layout,
+    VkPipelineLayout PipelineLayout,
+    uint32_t SetIndex,
+    VkPipelineBindPoint PipelineBindPoint)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(NULL);
+
+    VkDescriptorUpdateTemplateEntry *Entries = RR_ALLOC_TYPE_COUNT(
+        Scratch.Arena,
+        VkDescriptorUpdateTemplateEntry,
+        Set->BindingCount);
+    for(size_t Index = 0; Index < Set->BindingCount; ++Index)
+    {
+        Rr_PipelineBinding *Binding = Set->Bindings + Index;
+
+        assert(Binding->Binding < RR_MAX_BINDINGS);
+
+        Entries[Index] = (VkDescriptorUpdateTemplateEntry){
+            .dstBinding = Binding->Binding,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = Rr_GetVulkanPushDescriptorType(Binding->Type),
+            .offset = Binding->Binding * sizeof(Rr_PushDescriptorInfo),
+            .stride = sizeof(Rr_PushDescriptorInfo),
+        };
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo Info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .descriptorUpdateEntryCount = Set->BindingCount,
+        .pDescriptorUpdateEntries = Entries,
+        .templateType =
+            VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR,
+        .descriptorSetLayout = Layout,
+        .pipelineBindPoint = PipelineBindPoint,
+        .pipelineLayout = PipelineLayout,
+        .set = SetIndex,
+    };
+
+    VkDescriptorUpdateTemplate Template;
+    Device->CreateDescriptorUpdateTemplate(
+        Device->Handle,
+        &Info,
+        NULL,
+        &Template);
+
+    Rr_DestroyScratch(Scratch);
+
+    return Template;
+}
+
 void Rr_InvalidateDescriptorState(
     Rr_DescriptorsState *State,
     Rr_PipelineLayout *PipelineLayout)
 {
+    /* Bindless layouts own no per-draw sets, whatever was bound
+     * before is disturbed by the global set anyway. */
+
+    if(PipelineLayout->Bindless)
+    {
+        memset(State, 0, sizeof(Rr_DescriptorsState));
+        return;
+    }
+
     bool Disturbed = false;
     for(size_t Index = 0; Index < PipelineLayout->SetLayoutCount; ++Index)
     {
@@ -504,6 +591,273 @@ static void Rr_ValidateNullSetBinding(
     }
 }
 
+static void Rr_GetDescriptorSetCacheKey(
+    Rr_DescriptorSetState *SetState,
+    Rr_DescriptorSetCacheKey *Key)
+{
+    /* Built field by field so union padding never reaches the hash. */
+
+    memset(Key, 0, sizeof(Rr_DescriptorSetCacheKey));
+    Key->Layout = SetState->Layout;
+    Key->UsedBindings = SetState->Flags & ((1 << RR_MAX_BINDINGS) - 1);
+
+    for(size_t BindingIndex = 0; BindingIndex < RR_MAX_BINDINGS;
+        ++BindingIndex)
+    {
+        if(RR_HAS_BIT(Key->UsedBindings, (1 << BindingIndex)) != true)
+        {
+            continue;
+        }
+
+        Rr_DescriptorSetBinding *Binding = SetState->Bindings + BindingIndex;
+        Rr_DescriptorSetBinding *KeyBinding = Key->Bindings + BindingIndex;
+        KeyBinding->Type = Binding->Type;
+        switch(Binding->Type)
+        {
+            case RR_PIPELINE_BINDING_TYPE_SAMPLER:
+            {
+                KeyBinding->Sampler = Binding->Sampler;
+            }
+            break;
+            case RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER:
+            case RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER:
+            {
+                KeyBinding->Buffer.Handle = Binding->Buffer.Handle;
+                KeyBinding->Buffer.Size = Binding->Buffer.Size;
+            }
+            break;
+            default:
+            {
+                KeyBinding->Image.View = Binding->Image.View;
+                KeyBinding->Image.Sampler = Binding->Image.Sampler;
+                KeyBinding->Image.Layout = Binding->Image.Layout;
+            }
+            break;
+        }
+    }
+}
+
+static VkDescriptorSet Rr_WriteDescriptorSet(
+    Rr_DescriptorSetState *SetState,
+    Rr_DescriptorAllocator *DescriptorAllocator,
+    Rr_PipelineLayout *PipelineLayout,
+    size_t SetIndex,
+    Rr_Device *Device)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(DescriptorAllocator->Arena);
+
+    Rr_DescriptorWriter *Writer =
+        Rr_CreateDescriptorWriter(0, 0, 0, Scratch.Arena);
+
+    for(size_t BindingIndex = 0; BindingIndex < RR_MAX_BINDINGS;
+        ++BindingIndex)
+    {
+        Rr_DescriptorSetBinding *Binding = SetState->Bindings + BindingIndex;
+
+        if(RR_HAS_BIT(SetState->Flags, (1 << BindingIndex)) != true)
+        {
+#if defined(RR_DEBUG)
+            Rr_ValidateNullSetBinding(
+                &PipelineLayout->SetLayouts[SetIndex]->Set,
+                BindingIndex);
+#endif
+            continue;
+        }
+
+        switch(Binding->Type)
+        {
+            case RR_PIPELINE_BINDING_TYPE_SAMPLER:
+            {
+                Rr_WriteSamplerDescriptor(
+                    Writer,
+                    BindingIndex,
+                    0,
+                    Binding->Sampler);
+            }
+            break;
+            case RR_PIPELINE_BINDING_TYPE_SAMPLED_IMAGE:
+            {
+                Rr_WriteImageDescriptor(
+                    Writer,
+                    BindingIndex,
+                    0,
+                    Binding->Image.View,
+                    Binding->Image.Layout,
+                    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE);
+            }
+            break;
+            case RR_PIPELINE_BINDING_TYPE_COMBINED_IMAGE_SAMPLER:
+            {
+                Rr_WriteCombinedImageSamplerDescriptor(
+                    Writer,
+                    BindingIndex,
+                    0,
+                    Binding->Image.View,
+                    Binding->Image.Sampler,
+                    Binding->Image.Layout);
+            }
+            break;
+            case RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER:
+            case RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER:
+            {
+                Rr_WriteBufferDescriptor(
+                    Writer,
+                    BindingIndex,
+                    Binding->Buffer.Handle,
+                    Binding->Buffer.Size,
+                    0, /* We rely on dynamic offsets! */
+                    Rr_GetVulkanDescriptorType(Binding->Type),
+                    Scratch.Arena);
+            }
+            break;
+            case RR_PIPELINE_BINDING_TYPE_STORAGE_IMAGE:
+            {
+                Rr_WriteImageDescriptor(
+                    Writer,
+                    BindingIndex,
+                    0,
+                    Binding->Image.View,
+                    Binding->Image.Layout,
+                    VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            }
+            break;
+            default:
+            {
+                RR_ABORT("Not implemented!");
+            }
+            break;
+        }
+    }
+
+    VkDescriptorSet DescriptorSet = Rr_AllocateDescriptorSet(
+        DescriptorAllocator,
+        Device,
+        PipelineLayout->SetLayouts[SetIndex]->Handle);
+
+    Rr_UpdateDescriptorSet(Writer, Device, DescriptorSet);
+
+    Rr_DestroyScratch(Scratch);
+
+    return DescriptorSet;
+}
+
+static VkDescriptorSet Rr_GetDescriptorSet(
+    Rr_DescriptorSetState *SetState,
+    Rr_DescriptorAllocator *DescriptorAllocator,
+    Rr_PipelineLayout *PipelineLayout,
+    size_t SetIndex,
+    Rr_Device *Device)
+{
+    Rr_DescriptorSetCacheKey Key;
+    Rr_GetDescriptorSetCacheKey(SetState, &Key);
+    uint64_t Hash = XXH3_64bits(&Key, sizeof(Rr_DescriptorSetCacheKey));
+
+    /* Values are entry indices plus one, entries may move when the
+     * slice grows. */
+
+    void **Value = Rr_UpsertHashMap(
+        &DescriptorAllocator->SetCache,
+        Hash,
+        DescriptorAllocator->Arena);
+    if(*Value != NULL)
+    {
+        Rr_DescriptorSetCacheEntry *Entry =
+            DescriptorAllocator->SetCacheEntries.Data +
+            ((uintptr_t)*Value - 1);
+        if(memcmp(&Entry->Key, &Key, sizeof(Rr_DescriptorSetCacheKey)) == 0)
+        {
+            return Entry->Set;
+        }
+    }
+
+    VkDescriptorSet DescriptorSet = Rr_WriteDescriptorSet(
+        SetState,
+        DescriptorAllocator,
+        PipelineLayout,
+        SetIndex,
+        Device);
+
+    /* On a hash collision the newer set replaces the cached one. */
+
+    Rr_DescriptorSetCacheEntry *Entry = RR_PUSH_SLICE(
+        &DescriptorAllocator->SetCacheEntries,
+        DescriptorAllocator->Arena);
+    Entry->Key = Key;
+    Entry->Set = DescriptorSet;
+    *Value = (void *)(uintptr_t)DescriptorAllocator->SetCacheEntries.Count;
+
+    return DescriptorSet;
+}
+
+static void Rr_PushDescriptorSet(
+    Rr_DescriptorSetState *SetState,
+    Rr_PipelineLayout *PipelineLayout,
+    size_t SetIndex,
+    Rr_Device *Device,
+    VkCommandBuffer CommandBuffer,
+    VkPipelineBindPoint PipelineBindPoint)
+{
+    VkDescriptorUpdateTemplate Template =
+        PipelineBindPoint == VK_PIPELINE_BIND_POINT_COMPUTE
+            ? PipelineLayout->ComputePushTemplate
+            : PipelineLayout->GraphicsPushTemplate;
+    assert(Template != VK_NULL_HANDLE);
+
+    Rr_PushDescriptorInfo Infos[RR_MAX_BINDINGS] = { 0 };
+
+    for(size_t BindingIndex = 0; BindingIndex < RR_MAX_BINDINGS;
+        ++BindingIndex)
+    {
+        Rr_DescriptorSetBinding *Binding = SetState->Bindings + BindingIndex;
+        Rr_PushDescriptorInfo *Info = Infos + BindingIndex;
+
+        if(RR_HAS_BIT(SetState->Flags, (1 << BindingIndex)) != true)
+        {
+#if defined(RR_DEBUG)
+            Rr_ValidateNullSetBinding(
+                &PipelineLayout->SetLayouts[SetIndex]->Set,
+                BindingIndex);
+#endif
+            continue;
+        }
+
+        switch(Binding->Type)
+        {
+            case RR_PIPELINE_BINDING_TYPE_SAMPLER:
+            {
+                Info->Image.sampler = Binding->Sampler;
+            }
+            break;
+            case RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER:
+            case RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER:
+            {
+                Info->Buffer = (VkDescriptorBufferInfo){
+                    .buffer = Binding->Buffer.Handle,
+                    .offset = Binding->Buffer.Offset,
+                    .range = Binding->Buffer.Size,
+                };
+            }
+            break;
+            default:
+            {
+                Info->Image = (VkDescriptorImageInfo){
+                    .sampler = Binding->Image.Sampler,
+                    .imageView = Binding->Image.View,
+                    .imageLayout = Binding->Image.Layout,
+                };
+            }
+            break;
+        }
+    }
+
+    Device->CmdPushDescriptorSetWithTemplateKHR(
+        CommandBuffer,
+        Template,
+        PipelineLayout->Handle,
+        SetIndex,
+        Infos);
+}
+
 void Rr_ApplyDescriptorsState(
     Rr_DescriptorsState *State,
     Rr_DescriptorAllocator *DescriptorAllocator,
@@ -517,12 +871,6 @@ void Rr_ApplyDescriptorsState(
         return;
     }
 
-    Rr_Scratch Scratch = Rr_GetScratch(NULL);
-
-    Rr_DescriptorWriter *Writer =
-        Rr_CreateDescriptorWriter(0, 0, 0, Scratch.Arena);
-
-    bool FirstSetSet = false;
     bool Disturbed = false;
     uint32_t FirstSet = 0;
     uint32_t DescriptorSetCount = 0;
@@ -530,7 +878,8 @@ void Rr_ApplyDescriptorsState(
     size_t DynamicOffsetCount = 0;
     uint32_t DynamicOffsets[RR_MAX_BINDINGS * RR_MAX_SETS];
 
-    for(size_t SetIndex = 0; SetIndex < RR_MAX_SETS; ++SetIndex)
+    for(size_t SetIndex = 0; SetIndex < PipelineLayout->SetLayoutCount;
+        ++SetIndex)
     {
         Rr_DescriptorSetState *SetState = State->SetStates + SetIndex;
 
@@ -541,140 +890,382 @@ void Rr_ApplyDescriptorsState(
         if(Disturbed || Dirty)
         {
             Disturbed = true;
-            if(FirstSetSet == false)
-            {
-                FirstSet = SetIndex;
-                FirstSetSet = true;
-            }
         }
         else
         {
             continue;
         }
 
+        /* Push sets split the bound range, sets written so far are
+         * bound first. */
+
+        if(PipelineLayout->SetLayouts[SetIndex]->Push)
+        {
+            if(DescriptorSetCount > 0)
+            {
+                Device->CmdBindDescriptorSets(
+                    CommandBuffer,
+                    PipelineBindPoint,
+                    PipelineLayout->Handle,
+                    FirstSet,
+                    DescriptorSetCount,
+                    DescriptorSets,
+                    DynamicOffsetCount,
+                    DynamicOffsets);
+                DescriptorSetCount = 0;
+                DynamicOffsetCount = 0;
+            }
+
+            Rr_PushDescriptorSet(
+                SetState,
+                PipelineLayout,
+                SetIndex,
+                Device,
+                CommandBuffer,
+                PipelineBindPoint);
+            continue;
+        }
+
+        if(DescriptorSetCount == 0)
+        {
+            FirstSet = SetIndex;
+        }
+
         for(size_t BindingIndex = 0; BindingIndex < RR_MAX_BINDINGS;
             ++BindingIndex)
         {
             Rr_DescriptorSetBinding *Binding =
                 SetState->Bindings + BindingIndex;
 
-            if(RR_HAS_BIT(SetState->Flags, (1 << BindingIndex)) != true)
+            if(RR_HAS_BIT(SetState->Flags, (1 << BindingIndex)) == true &&
+               (Binding->Type == RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER ||
+                Binding->Type == RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER))
             {
-#if defined(RR_DEBUG)
-                Rr_ValidateNullSetBinding(
-                    &PipelineLayout->SetLayouts[SetIndex]->Set,
-                    BindingIndex);
-#endif
-                continue;
-            }
-
-            switch(Binding->Type)
-            {
-                case RR_PIPELINE_BINDING_TYPE_SAMPLER:
-                {
-                    Rr_WriteSamplerDescriptor(
-                        Writer,
-                        BindingIndex,
-                        0,
-                        Binding->Sampler);
-                }
-                break;
-                case RR_PIPELINE_BINDING_TYPE_SAMPLED_IMAGE:
-                {
-                    Rr_WriteImageDescriptor(
-                        Writer,
-                        BindingIndex,
-                        0,
-                        Binding->Image.View,
-                        Binding->Image.Layout,
-                        VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE);
-                }
-                break;
-                case RR_PIPELINE_BINDING_TYPE_COMBINED_IMAGE_SAMPLER:
-                {
-                    Rr_WriteCombinedImageSamplerDescriptor(
-                        Writer,
-                        BindingIndex,
-                        0,
-                        Binding->Image.View,
-                        Binding->Image.Sampler,
-                        Binding->Image.Layout);
-                }
-                break;
-                case RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER:
-                {
-                    Rr_WriteBufferDescriptor(
-                        Writer,
-                        BindingIndex,
-                        Binding->Buffer.Handle,
-                        Binding->Buffer.Size,
-                        0, /* We rely on dynamic offsets! */
-                        Rr_GetVulkanDescriptorType(Binding->Type),
-                        Scratch.Arena);
-                    DynamicOffsets[DynamicOffsetCount] = Binding->Buffer.Offset;
-                    DynamicOffsetCount++;
-                }
-                break;
-                case RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER:
-                {
-                    Rr_WriteBufferDescriptor(
-                        Writer,
-                        BindingIndex,
-                        Binding->Buffer.Handle,
-                        Binding->Buffer.Size,
-                        0, /* We rely on dynamic offsets! */
-                        Rr_GetVulkanDescriptorType(Binding->Type),
-                        Scratch.Arena);
-                    DynamicOffsets[DynamicOffsetCount] = Binding->Buffer.Offset;
-                    DynamicOffsetCount++;
-                }
-                break;
-                case RR_PIPELINE_BINDING_TYPE_STORAGE_IMAGE:
-                {
-                    Rr_WriteImageDescriptor(
-                        Writer,
-                        BindingIndex,
-                        0,
-                        Binding->Image.View,
-                        Binding->Image.Layout,
-                        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
-                }
-                break;
-                default:
-                {
-                    RR_ABORT("Not implemented!");
-                }
-                break;
+                DynamicOffsets[DynamicOffsetCount] = Binding->Buffer.Offset;
+                DynamicOffsetCount++;
             }
         }
 
-        VkDescriptorSet DescriptorSet = Rr_AllocateDescriptorSet(
+        DescriptorSets[DescriptorSetCount++] = Rr_GetDescriptorSet(
+            SetState,
             DescriptorAllocator,
-            Device,
-            PipelineLayout->SetLayouts[SetIndex]->Handle);
+            PipelineLayout,
+            SetIndex,
+            Device);
+    }
+
+    if(DescriptorSetCount > 0)
+    {
+        Device->CmdBindDescriptorSets(
+            CommandBuffer,
+            PipelineBindPoint,
+            PipelineLayout->Handle,
+            FirstSet,
+            DescriptorSetCount,
+            DescriptorSets,
+            DynamicOffsetCount,
+            DynamicOffsets);
+    }
+
+    State->Dirty = false;
+}
+
+static const VkDescriptorType Rr_BindlessDescriptorTypes[] = {
+    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+    VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+    VK_DESCRIPTOR_TYPE_SAMPLER,
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+};
+
+static void Rr_GetBindlessCapacities(
+    Rr_PhysicalDevice *PhysicalDevice,
+    uint32_t *Capacities)
+{
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT *Properties =
+        &PhysicalDevice->DescriptorIndexingProperties;
+
+    Capacities[RR_BINDLESS_BINDING_SAMPLED_IMAGE] = RR_MIN(
+        RR_BINDLESS_SAMPLED_IMAGE_COUNT,
+        RR_MIN(
+            Properties->maxDescriptorSetUpdateAfterBindSampledImages,
+            Properties->maxPerStageDescriptorUpdateAfterBindSampledImages));
+    Capacities[RR_BINDLESS_BINDING_STORAGE_IMAGE] = RR_MIN(
+        RR_BINDLESS_STORAGE_IMAGE_COUNT,
+        RR_MIN(
+            Properties->maxDescriptorSetUpdateAfterBindStorageImages,
+            Properties->maxPerStageDescriptorUpdateAfterBindStorageImages));
+    Capacities[RR_BINDLESS_BINDING_SAMPLER] = RR_MIN(
+        RR_BINDLESS_SAMPLER_COUNT,
+        RR_MIN(
+            Properties->maxDescriptorSetUpdateAfterBindSamplers,
+            Properties->maxPerStageDescriptorUpdateAfterBindSamplers));
+    Capacities[RR_BINDLESS_BINDING_STORAGE_BUFFER] = RR_MIN(
+        RR_BINDLESS_STORAGE_BUFFER_COUNT,
+        RR_MIN(
+            Properties->maxDescriptorSetUpdateAfterBindStorageBuffers,
+            Properties->maxPerStageDescriptorUpdateAfterBindStorageBuffers));
+}
+
+bool Rr_InitBindlessSet(
+    Rr_BindlessSet *Set,
+    Rr_PhysicalDevice *PhysicalDevice,
+    Rr_Device *Device)
+{
+    *Set = (Rr_BindlessSet){ 0 };
+
+    Rr_GetBindlessCapacities(PhysicalDevice, Set->Capacities);
+
+    VkDescriptorSetLayoutBinding Bindings[RR_BINDLESS_BINDING_COUNT];
+    VkDescriptorBindingFlagsEXT BindingFlags[RR_BINDLESS_BINDING_COUNT];
+    VkDescriptorPoolSize PoolSizes[RR_BINDLESS_BINDING_COUNT];
+    for(size_t Index = 0; Index < RR_BINDLESS_BINDING_COUNT; ++Index)
+    {
+        Bindings[Index] = (VkDescriptorSetLayoutBinding){
+            .binding = Index,
+            .descriptorType = Rr_BindlessDescriptorTypes[Index],
+            .descriptorCount = Set->Capacities[Index],
+            .stageFlags = VK_SHADER_STAGE_ALL,
+        };
+        BindingFlags[Index] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+                              VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+        PoolSizes[Index] = (VkDescriptorPoolSize){
+            .type = Rr_BindlessDescriptorTypes[Index],
+            .descriptorCount = Set->Capacities[Index],
+        };
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT BindingFlagsInfo = {
+        .sType =
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT,
+        .bindingCount = RR_BINDLESS_BINDING_COUNT,
+        .pBindingFlags = BindingFlags,
+    };
+    VkDescriptorSetLayoutCreateInfo LayoutInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &BindingFlagsInfo,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT,
+        .bindingCount = RR_BINDLESS_BINDING_COUNT,
+        .pBindings = Bindings,
+    };
+    if(Device->CreateDescriptorSetLayout(
+           Device->Handle,
+           &LayoutInfo,
+           NULL,
+           &Set->Layout) != VK_SUCCESS)
+    {
+        RR_LOG("Failed to create bindless descriptor set layout.");
+        return false;
+    }
+
+    VkDescriptorPoolCreateInfo PoolInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT,
+        .maxSets = 1,
+        .poolSizeCount = RR_BINDLESS_BINDING_COUNT,
+        .pPoolSizes = PoolSizes,
+    };
+    Device->CreateDescriptorPool(Device->Handle, &PoolInfo, NULL, &Set->Pool);
+
+    VkDescriptorSetAllocateInfo AllocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = Set->Pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &Set->Layout,
+    };
+    if(Device->AllocateDescriptorSets(
+           Device->Handle,
+           &AllocateInfo,
+           &Set->Handle) != VK_SUCCESS)
+    {
+        RR_LOG("Failed to allocate bindless descriptor set.");
+        Device->DestroyDescriptorPool(Device->Handle, Set->Pool, NULL);
+        Device->DestroyDescriptorSetLayout(Device->Handle, Set->Layout, NULL);
+        *Set = (Rr_BindlessSet){ 0 };
+        return false;
+    }
+
+    for(size_t Index = 0; Index < RR_BINDLESS_BINDING_COUNT; ++Index)
+    {
+        Set->Counts[Index] = 1;
+    }
+    Set->Arena = Rr_CreateDefaultArena();
+
+    return true;
+}
+
+void Rr_CleanupBindlessSet(Rr_BindlessSet *Set, Rr_Device *Device)
+{
+    if(Set->Handle == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    Device->DestroyDescriptorPool(Device->Handle, Set->Pool, NULL);
+    Device->DestroyDescriptorSetLayout(Device->Handle, Set->Layout, NULL);
+    Rr_DestroyArena(Set->Arena);
+
+    *Set = (Rr_BindlessSet){ 0 };
+}
+
+uint32_t Rr_AllocateBindlessIndex(
+    Rr_BindlessSet *Set,
+    Rr_BindlessBinding Binding)
+{
+    uint32_t Index = 0;
+
+    Rr_LockSpinLock(&Set->Lock);
+
+    if(Set->FreeIndices[Binding].Count > 0)
+    {
+        Index = Set->FreeIndices[Binding]
+                    .Data[Set->FreeIndices[Binding].Count - 1];
+        RR_POP_SLICE(&Set->FreeIndices[Binding]);
+    }
+    else if(Set->Counts[Binding] < Set->Capacities[Binding])
+    {
+        Index = Set->Counts[Binding]++;
+    }
+
+    Rr_UnlockSpinLock(&Set->Lock);
+
+    if(Index == 0)
+    {
+        RR_LOG("Bindless binding %d is full.", Binding);
+    }
 
-        Rr_UpdateDescriptorSet(Writer, Device, DescriptorSet);
-        Rr_ResetDescriptorWriter(Writer);
+    return Index;
+}
+
+void Rr_ReleaseBindlessIndex(
+    Rr_BindlessSet *Set,
+    Rr_BindlessBinding Binding,
+    uint32_t Index,
+    size_t FrameNumber)
+{
+    if(Index == 0)
+    {
+        return;
+    }
 
-        DescriptorSets[DescriptorSetCount++] = DescriptorSet;
+    Rr_LockSpinLock(&Set->Lock);
 
-        bool LastSet = SetIndex == PipelineLayout->SetLayoutCount - 1;
-        if(LastSet && DescriptorSetCount > 0)
+    *RR_PUSH_SLICE(&Set->RetiredIndices, Set->Arena) =
+        (Rr_RetiredBindlessIndex){
+            .Index = Index,
+            .Binding = Binding,
+            .FrameNumber = FrameNumber,
+        };
+
+    Rr_UnlockSpinLock(&Set->Lock);
+}
+
+void Rr_RecycleBindlessIndices(Rr_BindlessSet *Set, size_t FrameNumber)
+{
+    Rr_LockSpinLock(&Set->Lock);
+
+    size_t Kept = 0;
+    for(size_t Index = 0; Index < Set->RetiredIndices.Count; ++Index)
+    {
+        Rr_RetiredBindlessIndex *Retired = Set->RetiredIndices.Data + Index;
+        if(FrameNumber >= Retired->FrameNumber + RR_FRAME_OVERLAP)
         {
-            Device->CmdBindDescriptorSets(
-                CommandBuffer,
-                PipelineBindPoint,
-                PipelineLayout->Handle,
-                FirstSet,
-                DescriptorSetCount,
-                DescriptorSets,
-                DynamicOffsetCount,
-                DynamicOffsets);
-            break;
+            *RR_PUSH_SLICE(&Set->FreeIndices[Retired->Binding], Set->Arena) =
+                Retired->Index;
+        }
+        else
+        {
+            Set->RetiredIndices.Data[Kept++] = *Retired;
         }
     }
+    Set->RetiredIndices.Count = Kept;
 
-    State->Dirty = false;
+    Rr_UnlockSpinLock(&Set->Lock);
+}
 
-    Rr_DestroyScratch(Scratch);
+static void Rr_WriteBindlessDescriptor(
+    Rr_BindlessSet *Set,
+    Rr_Device *Device,
+    VkWriteDescriptorSet *Write)
+{
+    /* Writes to one set must not race, even on distinct elements. */
+
+    Rr_LockSpinLock(&Set->Lock);
+    Device->UpdateDescriptorSets(Device->Handle, 1, Write, 0, NULL);
+    Rr_UnlockSpinLock(&Set->Lock);
+}
+
+void Rr_WriteBindlessImage(
+    Rr_BindlessSet *Set,
+    Rr_Device *Device,
+    Rr_BindlessBinding Binding,
+    uint32_t Index,
+    VkImageView View,
+    VkImageLayout Layout)
+{
+    VkDescriptorImageInfo ImageInfo = {
+        .imageView = View,
+        .imageLayout = Layout,
+    };
+    Rr_WriteBindlessDescriptor(
+        Set,
+        Device,
+        &(VkWriteDescriptorSet){
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = Set->Handle,
+            .dstBinding = Binding,
+            .dstArrayElement = Index,
+            .descriptorCount = 1,
+            .descriptorType = Rr_BindlessDescriptorTypes[Binding],
+            .pImageInfo = &ImageInfo,
+        });
+}
+
+void Rr_WriteBindlessSampler(
+    Rr_BindlessSet *Set,
+    Rr_Device *Device,
+    uint32_t Index,
+    VkSampler Sampler)
+{
+    VkDescriptorImageInfo ImageInfo = {
+        .sampler = Sampler,
+    };
+    Rr_WriteBindlessDescriptor(
+        Set,
+        Device,
+        &(VkWriteDescriptorSet){
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = Set->Handle,
+            .dstBinding = RR_BINDLESS_BINDING_SAMPLER,
+            .dstArrayElement = Index,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+            .pImageInfo = &ImageInfo,
+        });
+}
+
+void Rr_WriteBindlessBuffer(
+    Rr_BindlessSet *Set,
+    Rr_Device *Device,
+    uint32_t Index,
+    VkBuffer Buffer,
+    size_t Offset,
+    size_t Size)
+{
+    VkDescriptorBufferInfo BufferInfo = {
+        .buffer = Buffer,
+        .offset = Offset,
+        .range = Size,
+    };
+    Rr_WriteBindlessDescriptor(
+        Set,
+        Device,
+        &(VkWriteDescriptorSet){
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = Set->Handle,
+            .dstBinding = RR_BINDLESS_BINDING_STORAGE_BUFFER,
+            .dstArrayElement = Index,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &BufferInfo,
+        });
 }
@@ -4,6 +4,7 @@
 #include "Rr_Vulkan.h"
 
 #include <Rr/Rr_Pipeline.h>
+#include <Rr/Rr_Platform.h>
 
 #define RR_MAX_BINDINGS 16
 #define RR_MAX_SETS     4
@@ -15,6 +16,12 @@ struct Rr_DescriptorPoolSizeRatio
     float Ratio;
 };
 
+typedef struct Rr_DescriptorSetCacheEntry Rr_DescriptorSetCacheEntry;
+
+/* Sets written since the last reset are cached by their contents, so
+ * rebinding identical resources reuses the set. The cache is dropped
+ * together with the pools on reset. */
+
 typedef struct Rr_DescriptorAllocator Rr_DescriptorAllocator;
 struct Rr_DescriptorAllocator
 {
@@ -23,6 +30,8 @@ struct Rr_DescriptorAllocator
     RR_SLICE(VkDescriptorPool) FullPools;
     RR_SLICE(VkDescriptorPool) ReadyPools;
     size_t SetsPerPool;
+    Rr_HashMap SetCache;
+    RR_SLICE(Rr_DescriptorSetCacheEntry) SetCacheEntries;
 };
 
 typedef enum Rr_DescriptorWriterEntryType
@@ -122,6 +131,7 @@ struct Rr_DescriptorLayoutBuilder
 {
     VkDescriptorSetLayoutBinding Bindings[RR_MAX_SETS];
     uint32_t Count;
+    bool Push;
 };
 
 extern void Rr_AddDescriptor(
@@ -143,6 +153,24 @@ extern VkDescriptorSetLayout Rr_BuildDescriptorLayout(
     Rr_DescriptorLayoutBuilder *Builder,
     Rr_Device *Device);
 
+/* Push sets use plain buffer descriptors, dynamic ones can't be
+ * pushed. Template data holds one info per binding number. */
+
+typedef union Rr_PushDescriptorInfo Rr_PushDescriptorInfo;
+union Rr_PushDescriptorInfo
+{
+    VkDescriptorImageInfo Image;
+    VkDescriptorBufferInfo Buffer;
+};
+
+extern VkDescriptorUpdateTemplate Rr_CreatePushDescriptorTemplate(
+    Rr_Device *Device,
+    Rr_PipelineBindingSet *Set,
+    VkDescriptorSetLayout Layout,
+    VkPipelineLayout PipelineLayout,
+    uint32_t SetIndex,
+    VkPipelineBindPoint PipelineBindPoint);
+
 /* */
 
 typedef struct Rr_DescriptorSetImageBinding Rr_DescriptorSetImageBinding;
@@ -190,6 +218,23 @@ struct Rr_DescriptorSetState
                                          flags. */
 };
 
+/* Buffer offsets are left out of the key, they are passed as dynamic
+ * offsets on bind. */
+
+typedef struct Rr_DescriptorSetCacheKey Rr_DescriptorSetCacheKey;
+struct Rr_DescriptorSetCacheKey
+{
+    Rr_DescriptorSetBinding Bindings[RR_MAX_BINDINGS];
+    VkDescriptorSetLayout Layout;
+    uint32_t UsedBindings;
+};
+
+struct Rr_DescriptorSetCacheEntry
+{
+    Rr_DescriptorSetCacheKey Key;
+    VkDescriptorSet Set;
+};
+
 typedef struct Rr_DescriptorsState Rr_DescriptorsState;
 struct Rr_DescriptorsState
 {
@@ -214,3 +259,82 @@ extern void Rr_ApplyDescriptorsState(
     Rr_Device *Device,
     VkCommandBuffer CommandBuffer,
     VkPipelineBindPoint PipelineBindPoint);
+
+/* Global update-after-bind set for the bindless mode. Each binding is
+ * a partially bound array, index zero is never handed out so zeroed
+ * resources read as having no index. Released indices are reused only
+ * once every frame that could still reference them has finished. */
+
+typedef enum Rr_BindlessBinding
+{
+    RR_BINDLESS_BINDING_SAMPLED_IMAGE,
+    RR_BINDLESS_BINDING_STORAGE_IMAGE,
+    RR_BINDLESS_BINDING_SAMPLER,
+    RR_BINDLESS_BINDING_STORAGE_BUFFER,
+    RR_BINDLESS_BINDING_COUNT,
+} Rr_BindlessBinding;
+
+typedef struct Rr_RetiredBindlessIndex Rr_RetiredBindlessIndex;
+struct Rr_RetiredBindlessIndex
+{
+    uint32_t Index;
+    Rr_BindlessBinding Binding;
+    size_t FrameNumber;
+};
+
+typedef struct Rr_BindlessSet Rr_BindlessSet;
+struct Rr_BindlessSet
+{
+    VkDescriptorPool Pool;
+    VkDescriptorSetLayout Layout;
+    VkDescriptorSet Handle;
+    uint32_t Capacities[RR_BINDLESS_BINDING_COUNT];
+    uint32_t Counts[RR_BINDLESS_BINDING_COUNT];
+    RR_SLICE(uint32_t) FreeIndices[RR_BINDLESS_BINDING_COUNT];
+    RR_SLICE(Rr_RetiredBindlessIndex) RetiredIndices;
+    Rr_SpinLock Lock;
+    Rr_Arena *Arena;
+};
+
+extern bool Rr_InitBindlessSet(
+    Rr_BindlessSet *Set,
+    Rr_PhysicalDevice *PhysicalDevice,
+    Rr_Device *Device);
+
+extern void Rr_CleanupBindlessSet(Rr_BindlessSet *Set, Rr_Device *Device);
+
+extern uint32_t Rr_AllocateBindlessIndex(
+    Rr_BindlessSet *Set,
+    Rr_BindlessBinding Binding);
+
+extern void Rr_ReleaseBindlessIndex(
+    Rr_BindlessSet *Set,
+    Rr_BindlessBinding Binding,
+    uint32_t Index,
+    size_t FrameNumber);
+
+extern void Rr_RecycleBindlessIndices(
+    Rr_BindlessSet *Set,
+    size_t FrameNumber);
+
+extern void Rr_WriteBindlessImage(
+    Rr_BindlessSet *Set,
+    Rr_Device *Device,
+    Rr_BindlessBinding Binding,
+    uint32_t Index,
+    VkImageView View,
+    VkImageLayout Layout);
+
+extern void Rr_WriteBindlessSampler(
+    Rr_BindlessSet *Set,
+    Rr_Device *Device,
+    uint32_t Index,
+    VkSampler Sampler);
+
+extern void Rr_WriteBindlessBuffer(
+    Rr_BindlessSet *Set,
+    Rr_Device *Device,
+    uint32_t Index,
+    VkBuffer Buffer,
+    size_t Offset,
+    size_t Size);
@@ -432,6 +432,12 @@ Rr_GLTFAsset *Rr_CreateGLTFAsset(
         Renderer,
         StagingDataSize,
         RR_BUFFER_FLAGS_STAGING_INCOHERENT_BIT | RR_BUFFER_FLAGS_MAPPED_BIT);
+    if(StagingBuffer == NULL)
+    {
+        cgltf_free(Data);
+        Rr_DestroyScratch(Scratch);
+        return NULL;
+    }
     *RR_PUSH_SLICE(&UploadContext->StagingBuffers, UploadContext->Arena) =
         StagingBuffer;
     char *StagingData = Rr_GetMappedBufferData(Renderer, StagingBuffer);
@@ -596,6 +602,12 @@ Rr_GLTFAsset *Rr_CreateGLTFAsset(
         Renderer,
         StagingDataSize,
         RR_BUFFER_FLAGS_INDEX_BIT | RR_BUFFER_FLAGS_VERTEX_BIT);
+    if(GLTFAsset->Buffer == NULL)
+    {
+        cgltf_free(Data);
+        Rr_DestroyScratch(Scratch);
+        return NULL;
+    }
     *RR_PUSH_SLICE(&GLTFContext->Buffers, GLTFContext->Arena) =
         GLTFAsset->Buffer;
 
@@ -6,6 +6,8 @@
 #include "Rr_Log.h"
 #include "Rr_Renderer.h"
 
+#include <xxHash/xxhash.h>
+
 #include <assert.h>
 
 static Rr_AllocatedBuffer *Rr_GetGraphBuffer(
@@ -34,25 +36,38 @@ static void Rr_ExecuteTransferNode(
     {
         Rr_Transfer *Transfer = Node->Transfers.Data + Index;
 
-        VkBuffer SrcBuffer =
-            Rr_GetGraphBuffer(Graph, Transfer->SrcBuffer)->Handle;
-        VkBuffer DstBuffer =
-            Rr_GetGraphBuffer(Graph, Transfer->DstBuffer)->Handle;
+        Rr_AllocatedBuffer *SrcBuffer =
+            Rr_GetGraphBuffer(Graph, Transfer->SrcBuffer);
+        Rr_AllocatedBuffer *DstBuffer =
+            Rr_GetGraphBuffer(Graph, Transfer->DstBuffer);
 
-        VkBufferCopy Copy = { .size = Transfer->Size,
-                              .srcOffset = Transfer->SrcOffset,
-                              .dstOffset = Transfer->DstOffset };
+        VkBufferCopy Copy = {
+            .size = Transfer->Size,
+            .srcOffset = SrcBuffer->Offset + Transfer->SrcOffset,
+            .dstOffset = DstBuffer->Offset + Transfer->DstOffset,
+        };
 
-        Device->CmdCopyBuffer(CommandBuffer, SrcBuffer, DstBuffer, 1, &Copy);
+        Device->CmdCopyBuffer(
+            CommandBuffer,
+            SrcBuffer->Handle,
+            DstBuffer->Handle,
+            1,
+            &Copy);
     }
 }
 
-static inline bool Rr_ClampBlitRect(Rr_IntVec4 *Rect, VkExtent3D *Extent)
+static inline bool Rr_ClampBlitRect(
+    Rr_IntVec4 *Rect,
+    VkExtent3D *Extent,
+    uint32_t MipLevel)
 {
-    Rect->X = RR_CLAMP(0, Rect->X, (int)Extent->width);
-    Rect->Y = RR_CLAMP(0, Rect->Y, (int)Extent->height);
-    Rect->Width = RR_CLAMP(0, Rect->Width, (int)Extent->width - Rect->X);
-    Rect->Height = RR_CLAMP(0, Rect->Height, (int)Extent->height - Rect->Y);
+    int Width = (int)RR_MAX(Extent->width >> MipLevel, 1);
+    int Height = (int)RR_MAX(Extent->height >> MipLevel, 1);
+
+    Rect->X = RR_CLAMP(0, Rect->X, Width);
+    Rect->Y = RR_CLAMP(0, Rect->Y, Height);
+    Rect->Width = RR_CLAMP(0, Rect->Width, Width - Rect->X);
+    Rect->Height = RR_CLAMP(0, Rect->Height, Height - Rect->Y);
 
     return Rect->Width > 0 && Rect->Height > 0;
 }
@@ -71,43 +86,106 @@ static void Rr_ExecuteBlitNode(
     Rr_AllocatedImage *DstImage =
         Rr_GetGraphImage(Frame->Graph, Node->DstImageHandle);
 
-    if(Rr_ClampBlitRect(&Node->SrcRect, &SrcImage->Container->Extent) &&
-       Rr_ClampBlitRect(&Node->DstRect, &DstImage->Container->Extent))
+    if(Rr_ClampBlitRect(
+           &Node->SrcRect,
+           &SrcImage->Container->Extent,
+           Node->SrcMipLevel) &&
+       Rr_ClampBlitRect(
+           &Node->DstRect,
+           &DstImage->Container->Extent,
+           Node->DstMipLevel))
     {
         Rr_BlitColorImage(
             Device,
             CommandBuffer,
             SrcImage->Handle,
+            Node->SrcMipLevel,
             DstImage->Handle,
+            Node->DstMipLevel,
             Node->SrcRect,
             Node->DstRect,
             Node->AspectMask);
     }
 }
 
+static void Rr_BindBindlessSet(
+    Rr_Renderer *Renderer,
+    Rr_PipelineLayout *PipelineLayout,
+    VkCommandBuffer CommandBuffer,
+    VkPipelineBindPoint PipelineBindPoint)
+{
+    if(PipelineLayout->Bindless == false)
+    {
+        return;
+    }
+
+    Renderer->Device.CmdBindDescriptorSets(
+        CommandBuffer,
+        PipelineBindPoint,
+        PipelineLayout->Handle,
+        0,
+        1,
+        &Renderer->Bindless.Handle,
+        0,
+        NULL);
+}
+
+static void Rr_PushNodeConstants(
+    Rr_Renderer *Renderer,
+    Rr_PipelineLayout *PipelineLayout,
+    Rr_PushConstantsArgs *Args,
+    VkCommandBuffer CommandBuffer)
+{
+    if(Args->Offset + Args->Size > PipelineLayout->PushConstantSize)
+    {
+        RR_LOG("Push constants exceed the pipeline layout range.");
+        return;
+    }
+
+    Renderer->Device.CmdPushConstants(
+        CommandBuffer,
+        PipelineLayout->Handle,
+        VK_SHADER_STAGE_ALL,
+        Args->Offset,
+        Args->Size,
+        Args + 1);
+}
+
 static void Rr_ExecuteComputeNode(
     Rr_Renderer *Renderer,
     Rr_Graph *Graph,
     Rr_ComputeNode *Node,
+    Rr_DescriptorAllocator *DescriptorAllocator,
     VkCommandBuffer CommandBuffer)
 {
-    Rr_Scratch Scratch = Rr_GetScratch(NULL);
-
     Rr_Device *Device = &Renderer->Device;
-    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
 
     Rr_ComputePipeline *Pipeline = NULL;
     Rr_DescriptorsState DescriptorsState = { 0 };
 
-    for(Rr_NodeFunction *Function = Node->Encoded.EncodedFirst;
-        Function != NULL;
-        Function = Function->Next)
+    Rr_NodeFunction *FunctionsEnd =
+        (Rr_NodeFunction *)(Node->Encoded.Stream.Data +
+                            Node->Encoded.Stream.Count);
+    for(Rr_NodeFunction *Function =
+            (Rr_NodeFunction *)Node->Encoded.Stream.Data;
+        Function < FunctionsEnd;
+        Function = Rr_GetNextNodeFunction(Function))
     {
+        void *FunctionArgs = Rr_GetNodeFunctionArgs(Function);
         switch(Function->Type)
         {
             case RR_NODE_FUNCTION_TYPE_BIND_COMPUTE_PIPELINE:
             {
-                Pipeline = *(Rr_ComputePipeline **)Function->Args;
+                Pipeline = *(Rr_ComputePipeline **)FunctionArgs;
+
+                /* Still compiling, dispatches are dropped until the
+                 * next bind. */
+
+                if(Rr_IsComputePipelineReady(Pipeline) == false)
+                {
+                    Pipeline = NULL;
+                    break;
+                }
                 Device->CmdBindPipeline(
                     CommandBuffer,
                     VK_PIPELINE_BIND_POINT_COMPUTE,
@@ -115,18 +193,40 @@ static void Rr_ExecuteComputeNode(
                 Rr_InvalidateDescriptorState(
                     &DescriptorsState,
                     Pipeline->Layout);
+                Rr_BindBindlessSet(
+                    Renderer,
+                    Pipeline->Layout,
+                    CommandBuffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE);
+            }
+            break;
+            case RR_NODE_FUNCTION_TYPE_PUSH_CONSTANTS:
+            {
+                if(Pipeline == NULL)
+                {
+                    break;
+                }
+                Rr_PushNodeConstants(
+                    Renderer,
+                    Pipeline->Layout,
+                    FunctionArgs,
+                    CommandBuffer);
             }
             break;
             case RR_NODE_FUNCTION_TYPE_DISPATCH:
             {
+                if(Pipeline == NULL)
+                {
+                    break;
+                }
                 Rr_ApplyDescriptorsState(
                     &DescriptorsState,
-                    &Frame->DescriptorAllocator,
+                    DescriptorAllocator,
                     Pipeline->Layout,
                     Device,
                     CommandBuffer,
                     VK_PIPELINE_BIND_POINT_COMPUTE);
-                Rr_DispatchArgs *Args = Function->Args;
+                Rr_DispatchArgs *Args = FunctionArgs;
                 Device->CmdDispatch(
                     CommandBuffer,
                     Args->GroupCountX,
@@ -136,7 +236,7 @@ static void Rr_ExecuteComputeNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_SAMPLER:
             {
-                Rr_BindSamplerArgs *Args = Function->Args;
+                Rr_BindSamplerArgs *Args = FunctionArgs;
                 Rr_UpdateDescriptorsState(
                     &DescriptorsState,
                     Args->Set,
@@ -149,7 +249,7 @@ static void Rr_ExecuteComputeNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_SAMPLED_IMAGE:
             {
-                Rr_BindSampledImageArgs *Args = Function->Args;
+                Rr_BindSampledImageArgs *Args = FunctionArgs;
                 VkImageView ImageView =
                     Rr_GetGraphImage(Graph, Args->ImageHandle)->View;
                 Rr_UpdateDescriptorsState(
@@ -168,7 +268,7 @@ static void Rr_ExecuteComputeNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_COMBINED_IMAGE_SAMPLER:
             {
-                Rr_BindCombinedImageSamplerArgs *Args = Function->Args;
+                Rr_BindCombinedImageSamplerArgs *Args = FunctionArgs;
                 VkImageView ImageView =
                     Rr_GetGraphImage(Graph, Args->ImageHandle)->View;
                 Rr_UpdateDescriptorsState(
@@ -188,7 +288,9 @@ static void Rr_ExecuteComputeNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_UNIFORM_BUFFER:
             {
-                Rr_BindUniformBufferArgs *Args = Function->Args;
+                Rr_BindUniformBufferArgs *Args = FunctionArgs;
+                Rr_AllocatedBuffer *AllocatedBuffer =
+                    Rr_GetGraphBuffer(Graph, Args->BufferHandle);
                 Rr_UpdateDescriptorsState(
                     &DescriptorsState,
                     Args->Set,
@@ -197,19 +299,19 @@ static void Rr_ExecuteComputeNode(
                         .Type = RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER,
                         .Buffer =
                             {
-                                .Handle = Rr_GetGraphBuffer(
-                                              Graph,
-                                              Args->BufferHandle)
-                                              ->Handle,
+                                .Handle = AllocatedBuffer->Handle,
                                 .Size = Args->Size,
-                                .Offset = Args->Offset,
+                                .Offset =
+                                    AllocatedBuffer->Offset + Args->Offset,
                             },
                     });
             }
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_STORAGE_BUFFER:
             {
-                Rr_BindStorageBufferArgs *Args = Function->Args;
+                Rr_BindStorageBufferArgs *Args = FunctionArgs;
+                Rr_AllocatedBuffer *AllocatedBuffer =
+                    Rr_GetGraphBuffer(Graph, Args->BufferHandle);
                 Rr_UpdateDescriptorsState(
                     &DescriptorsState,
                     Args->Set,
@@ -218,19 +320,17 @@ static void Rr_ExecuteComputeNode(
                         .Type = RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER,
                         .Buffer =
                             {
-                                .Handle = Rr_GetGraphBuffer(
-                                              Graph,
-                                              Args->BufferHandle)
-                                              ->Handle,
+                                .Handle = AllocatedBuffer->Handle,
                                 .Size = Args->Size,
-                                .Offset = Args->Offset,
+                                .Offset =
+                                    AllocatedBuffer->Offset + Args->Offset,
                             },
                     });
             }
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_STORAGE_IMAGE:
             {
-                Rr_BindStorageImageArgs *Args = Function->Args;
+                Rr_BindStorageImageArgs *Args = FunctionArgs;
                 VkImageView ImageView =
                     Rr_GetGraphImage(Graph, Args->ImageHandle)->View;
                 Rr_UpdateDescriptorsState(
@@ -253,20 +353,25 @@ static void Rr_ExecuteComputeNode(
             break;
         }
     }
-
-    Rr_DestroyScratch(Scratch);
 }
 
-static void Rr_ExecuteGraphicsNode(
+typedef struct Rr_GraphicsNodePass Rr_GraphicsNodePass;
+struct Rr_GraphicsNodePass
+{
+    VkRenderPassBeginInfo BeginInfo;
+    Rr_IntVec4 Viewport;
+};
+
+/* Resolves render pass and framebuffer of a graphics node.
+ * Touches renderer caches so it must run on the main thread. */
+
+static Rr_GraphicsNodePass Rr_PrepareGraphicsNodePass(
     Rr_Renderer *Renderer,
     Rr_Graph *Graph,
     Rr_GraphicsNode *Node,
-    VkCommandBuffer CommandBuffer)
+    Rr_Arena *Arena)
 {
-    Rr_Scratch Scratch = Rr_GetScratch(NULL);
-
-    Rr_Device *Device = &Renderer->Device;
-    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
 
     Rr_IntVec4 Viewport = { 0 };
     Viewport.Width = INT32_MAX;
@@ -284,7 +389,7 @@ static void Rr_ExecuteGraphicsNode(
     VkImageView *ImageViews =
         RR_ALLOC_TYPE_COUNT(Scratch.Arena, VkImageView, AttachmentCount);
     VkClearValue *ClearValues =
-        RR_ALLOC_TYPE_COUNT(Scratch.Arena, VkClearValue, AttachmentCount);
+        RR_ALLOC_TYPE_COUNT(Arena, VkClearValue, AttachmentCount);
     for(uint32_t Index = 0; Index < Node->ColorTargetCount; ++Index)
     {
         Rr_ColorTarget *ColorTarget = &Node->ColorTargets[Index];
@@ -329,7 +434,7 @@ static void Rr_ExecuteGraphicsNode(
             (int32_t)DepthImage->Container->Extent.height);
     }
 
-    /* Begin render pass. */
+    /* Resolve render pass and framebuffer. */
 
     Rr_RenderPassInfo RenderPassInfo = {
         .AttachmentCount = AttachmentCount,
@@ -346,7 +451,10 @@ static void Rr_ExecuteGraphicsNode(
             .height = Viewport.Height,
             .depth = 1,
         });
-    VkRenderPassBeginInfo RenderPassBeginInfo = {
+
+    Rr_GraphicsNodePass Pass = { 0 };
+    Pass.Viewport = Viewport;
+    Pass.BeginInfo = (VkRenderPassBeginInfo){
         .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
         .pNext = NULL,
         .framebuffer = Framebuffer,
@@ -365,10 +473,24 @@ static void Rr_ExecuteGraphicsNode(
         .clearValueCount = AttachmentCount,
         .pClearValues = ClearValues,
     };
-    Device->CmdBeginRenderPass(
-        CommandBuffer,
-        &RenderPassBeginInfo,
-        VK_SUBPASS_CONTENTS_INLINE);
+
+    Rr_DestroyScratch(Scratch);
+
+    return Pass;
+}
+
+/* Records dynamic states and encoded functions of a graphics node.
+ * Expects the render pass to be already started. */
+
+static void Rr_RecordGraphicsNode(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_GraphicsNode *Node,
+    Rr_IntVec4 Viewport,
+    Rr_DescriptorAllocator *DescriptorAllocator,
+    VkCommandBuffer CommandBuffer)
+{
+    Rr_Device *Device = &Renderer->Device;
 
     /* Set dynamic states. */
 
@@ -399,22 +521,31 @@ static void Rr_ExecuteGraphicsNode(
     Rr_GraphicsPipeline *GraphicsPipeline = NULL;
     Rr_DescriptorsState DescriptorsState = { 0 };
 
-    for(Rr_NodeFunction *Function = Node->Encoded.EncodedFirst;
-        Function != NULL;
-        Function = Function->Next)
+    Rr_NodeFunction *FunctionsEnd =
+        (Rr_NodeFunction *)(Node->Encoded.Stream.Data +
+                            Node->Encoded.Stream.Count);
+    for(Rr_NodeFunction *Function =
+            (Rr_NodeFunction *)Node->Encoded.Stream.Data;
+        Function < FunctionsEnd;
+        Function = Rr_GetNextNodeFunction(Function))
     {
+        void *FunctionArgs = Rr_GetNodeFunctionArgs(Function);
         switch(Function->Type)
         {
             case RR_NODE_FUNCTION_TYPE_DRAW:
             {
+                if(GraphicsPipeline == NULL)
+                {
+                    break;
+                }
                 Rr_ApplyDescriptorsState(
                     &DescriptorsState,
-                    &Frame->DescriptorAllocator,
+                    DescriptorAllocator,
                     GraphicsPipeline->Layout,
                     Device,
                     CommandBuffer,
                     VK_PIPELINE_BIND_POINT_GRAPHICS);
-                Rr_DrawArgs *Args = (Rr_DrawArgs *)Function->Args;
+                Rr_DrawArgs *Args = (Rr_DrawArgs *)FunctionArgs;
                 Device->CmdDraw(
                     CommandBuffer,
                     Args->VertexCount,
@@ -425,33 +556,43 @@ static void Rr_ExecuteGraphicsNode(
             break;
             case RR_NODE_FUNCTION_TYPE_DRAW_INDIRECT:
             {
+                if(GraphicsPipeline == NULL)
+                {
+                    break;
+                }
                 Rr_ApplyDescriptorsState(
                     &DescriptorsState,
-                    &Frame->DescriptorAllocator,
+                    DescriptorAllocator,
                     GraphicsPipeline->Layout,
                     Device,
                     CommandBuffer,
                     VK_PIPELINE_BIND_POINT_GRAPHICS);
                 Rr_DrawIndirectArgs *Args =
-                    (Rr_DrawIndirectArgs *)Function->Args;
+                    (Rr_DrawIndirectArgs *)FunctionArgs;
+                Rr_AllocatedBuffer *AllocatedBuffer =
+                    Rr_GetGraphBuffer(Graph, Args->BufferHandle);
                 Device->CmdDrawIndirect(
                     CommandBuffer,
-                    Rr_GetGraphBuffer(Graph, Args->BufferHandle)->Handle,
-                    Args->Offset,
+                    AllocatedBuffer->Handle,
+                    AllocatedBuffer->Offset + Args->Offset,
                     Args->Count,
                     Args->Stride);
             }
             break;
             case RR_NODE_FUNCTION_TYPE_DRAW_INDEXED:
             {
+                if(GraphicsPipeline == NULL)
+                {
+                    break;
+                }
                 Rr_ApplyDescriptorsState(
                     &DescriptorsState,
-                    &Frame->DescriptorAllocator,
+                    DescriptorAllocator,
                     GraphicsPipeline->Layout,
                     Device,
                     CommandBuffer,
                     VK_PIPELINE_BIND_POINT_GRAPHICS);
-                Rr_DrawIndexedArgs *Args = (Rr_DrawIndexedArgs *)Function->Args;
+                Rr_DrawIndexedArgs *Args = (Rr_DrawIndexedArgs *)FunctionArgs;
                 Device->CmdDrawIndexed(
                     CommandBuffer,
                     Args->IndexCount,
@@ -463,28 +604,37 @@ static void Rr_ExecuteGraphicsNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_INDEX_BUFFER:
             {
-                Rr_BindIndexBufferArgs *Args = Function->Args;
+                Rr_BindIndexBufferArgs *Args = FunctionArgs;
+                Rr_AllocatedBuffer *AllocatedBuffer =
+                    Rr_GetGraphBuffer(Graph, Args->BufferHandle);
                 Device->CmdBindIndexBuffer(
                     CommandBuffer,
-                    Rr_GetGraphBuffer(Graph, Args->BufferHandle)->Handle,
-                    Args->Offset,
+                    AllocatedBuffer->Handle,
+                    AllocatedBuffer->Offset + Args->Offset,
                     Args->Type);
             }
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_VERTEX_BUFFER:
             {
-                Rr_BindBufferArgs *Args = Function->Args;
+                Rr_BindBufferArgs *Args = FunctionArgs;
+                Rr_AllocatedBuffer *AllocatedBuffer =
+                    Rr_GetGraphBuffer(Graph, Args->BufferHandle);
                 Device->CmdBindVertexBuffers(
                     CommandBuffer,
                     Args->Slot,
                     1,
-                    &Rr_GetGraphBuffer(Graph, Args->BufferHandle)->Handle,
-                    &(VkDeviceSize){ Args->Offset });
+                    &AllocatedBuffer->Handle,
+                    &(VkDeviceSize){ AllocatedBuffer->Offset + Args->Offset });
             }
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_GRAPHICS_PIPELINE:
             {
-                GraphicsPipeline = *(Rr_GraphicsPipeline **)Function->Args;
+                GraphicsPipeline = *(Rr_GraphicsPipeline **)FunctionArgs;
+                if(Rr_IsGraphicsPipelineReady(GraphicsPipeline) == false)
+                {
+                    GraphicsPipeline = NULL;
+                    break;
+                }
                 Device->CmdBindPipeline(
                     CommandBuffer,
                     VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -492,11 +642,29 @@ static void Rr_ExecuteGraphicsNode(
                 Rr_InvalidateDescriptorState(
                     &DescriptorsState,
                     GraphicsPipeline->Layout);
+                Rr_BindBindlessSet(
+                    Renderer,
+                    GraphicsPipeline->Layout,
+                    CommandBuffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS);
+            }
+            break;
+            case RR_NODE_FUNCTION_TYPE_PUSH_CONSTANTS:
+            {
+                if(GraphicsPipeline == NULL)
+                {
+                    break;
+                }
+                Rr_PushNodeConstants(
+                    Renderer,
+                    GraphicsPipeline->Layout,
+                    FunctionArgs,
+                    CommandBuffer);
             }
             break;
             case RR_NODE_FUNCTION_TYPE_SET_VIEWPORT:
             {
-                Rr_Vec4 *Viewport = Function->Args;
+                Rr_Vec4 *Viewport = FunctionArgs;
                 Device->CmdSetViewport(
                     CommandBuffer,
                     0,
@@ -513,7 +681,7 @@ static void Rr_ExecuteGraphicsNode(
             break;
             case RR_NODE_FUNCTION_TYPE_SET_SCISSOR:
             {
-                Rr_IntVec4 *Scissor = Function->Args;
+                Rr_IntVec4 *Scissor = FunctionArgs;
                 Device->CmdSetScissor(
                     CommandBuffer,
                     0,
@@ -528,7 +696,7 @@ static void Rr_ExecuteGraphicsNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_SAMPLER:
             {
-                Rr_BindSamplerArgs *Args = Function->Args;
+                Rr_BindSamplerArgs *Args = FunctionArgs;
                 Rr_UpdateDescriptorsState(
                     &DescriptorsState,
                     Args->Set,
@@ -541,7 +709,7 @@ static void Rr_ExecuteGraphicsNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_SAMPLED_IMAGE:
             {
-                Rr_BindSampledImageArgs *Args = Function->Args;
+                Rr_BindSampledImageArgs *Args = FunctionArgs;
                 VkImageView ImageView =
                     Rr_GetGraphImage(Graph, Args->ImageHandle)->View;
                 Rr_UpdateDescriptorsState(
@@ -560,7 +728,7 @@ static void Rr_ExecuteGraphicsNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_COMBINED_IMAGE_SAMPLER:
             {
-                Rr_BindCombinedImageSamplerArgs *Args = Function->Args;
+                Rr_BindCombinedImageSamplerArgs *Args = FunctionArgs;
                 VkImageView ImageView =
                     Rr_GetGraphImage(Graph, Args->ImageHandle)->View;
                 Rr_UpdateDescriptorsState(
@@ -580,7 +748,9 @@ static void Rr_ExecuteGraphicsNode(
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_UNIFORM_BUFFER:
             {
-                Rr_BindUniformBufferArgs *Args = Function->Args;
+                Rr_BindUniformBufferArgs *Args = FunctionArgs;
+                Rr_AllocatedBuffer *AllocatedBuffer =
+                    Rr_GetGraphBuffer(Graph, Args->BufferHandle);
                 Rr_UpdateDescriptorsState(
                     &DescriptorsState,
                     Args->Set,
@@ -589,19 +759,19 @@ static void Rr_ExecuteGraphicsNode(
                         .Type = RR_PIPELINE_BINDING_TYPE_UNIFORM_BUFFER,
                         .Buffer =
                             {
-                                .Handle = Rr_GetGraphBuffer(
-                                              Graph,
-                                              Args->BufferHandle)
-                                              ->Handle,
+                                .Handle = AllocatedBuffer->Handle,
                                 .Size = Args->Size,
-                                .Offset = Args->Offset,
+                                .Offset =
+                                    AllocatedBuffer->Offset + Args->Offset,
                             },
                     });
             }
             break;
             case RR_NODE_FUNCTION_TYPE_BIND_STORAGE_BUFFER:
             {
-                Rr_BindStorageBufferArgs *Args = Function->Args;
+                Rr_BindStorageBufferArgs *Args = FunctionArgs;
+                Rr_AllocatedBuffer *AllocatedBuffer =
+                    Rr_GetGraphBuffer(Graph, Args->BufferHandle);
                 Rr_UpdateDescriptorsState(
                     &DescriptorsState,
                     Args->Set,
@@ -610,12 +780,10 @@ static void Rr_ExecuteGraphicsNode(
                         .Type = RR_PIPELINE_BINDING_TYPE_STORAGE_BUFFER,
                         .Buffer =
                             {
-                                .Handle = Rr_GetGraphBuffer(
-                                              Graph,
-                                              Args->BufferHandle)
-                                              ->Handle,
+                                .Handle = AllocatedBuffer->Handle,
                                 .Size = Args->Size,
-                                .Offset = Args->Offset,
+                                .Offset =
+                                    AllocatedBuffer->Offset + Args->Offset,
                             },
                     });
             }
@@ -626,6 +794,36 @@ static void Rr_ExecuteGraphicsNode(
             break;
         }
     }
+}
+
+static void Rr_ExecuteGraphicsNode(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_GraphicsNode *Node,
+    VkCommandBuffer CommandBuffer)
+{
+    Rr_Device *Device = &Renderer->Device;
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+
+    /* Descriptor pools may grow while the pass is recorded. */
+
+    Rr_Scratch Scratch = Rr_GetScratch(Frame->DescriptorAllocator.Arena);
+
+    Rr_GraphicsNodePass Pass =
+        Rr_PrepareGraphicsNodePass(Renderer, Graph, Node, Scratch.Arena);
+
+    Device->CmdBeginRenderPass(
+        CommandBuffer,
+        &Pass.BeginInfo,
+        VK_SUBPASS_CONTENTS_INLINE);
+
+    Rr_RecordGraphicsNode(
+        Renderer,
+        Graph,
+        Node,
+        Pass.Viewport,
+        &Frame->DescriptorAllocator,
+        CommandBuffer);
 
     Device->CmdEndRenderPass(CommandBuffer);
 
@@ -650,16 +848,51 @@ Rr_GraphNode *Rr_AddGraphNode(
     return GraphNode;
 }
 
+/* Treat any image read as a write for now due to layout transitions. */
+
+static inline bool Rr_IsWritingDependency(Rr_SyncState *State)
+{
+    return State->Specific.Layout != VK_IMAGE_LAYOUT_UNDEFINED ||
+           RR_HAS_BIT(State->AccessMask, RR_VULKAN_WRITES);
+}
+
+static inline bool Rr_AreResourcesOverlapping(
+    Rr_Graph *Graph,
+    size_t IndexA,
+    size_t IndexB)
+{
+    Rr_GraphResource *A = Graph->Resources.Data + IndexA;
+    Rr_GraphResource *B = Graph->Resources.Data + IndexB;
+
+    return A->ParentIndex == B->ParentIndex &&
+           A->Range.Begin < B->Range.End && B->Range.Begin < A->Range.End;
+}
+
 static inline bool Rr_AddNodeDependency(
     Rr_GraphNode *Node,
     Rr_GraphHandle *Handle,
     Rr_SyncState *State)
 {
+    Rr_Graph *Graph = Node->Graph;
+    Rr_Arena *Arena = Node->Graph->Arena;
+
     for(size_t Index = 0; Index < Node->Dependencies.Count; ++Index)
     {
         Rr_NodeDependency *Dependency = Node->Dependencies.Data + Index;
 
-        if(Dependency->Handle.Values.Index == Handle->Values.Index)
+        if(Dependency->Handle.Values.Index != Handle->Values.Index)
+        {
+            if(Rr_AreResourcesOverlapping(
+                   Graph,
+                   Dependency->Handle.Values.Index,
+                   Handle->Values.Index) &&
+               (Rr_IsWritingDependency(State) ||
+                Rr_IsWritingDependency(&Dependency->State)))
+            {
+                goto CantWriteOverlapping;
+            }
+        }
+        else
         {
             if(RR_HAS_BIT(State->AccessMask, RR_VULKAN_WRITES))
             {
@@ -684,9 +917,6 @@ static inline bool Rr_AddNodeDependency(
         }
     }
 
-    Rr_Graph *Graph = Node->Graph;
-    Rr_Arena *Arena = Node->Graph->Arena;
-
     if(Handle->Values.Index == Graph->SwapchainImageResourceIndex)
     {
         Node->UsesLateCommandBuffer = true;
@@ -697,10 +927,7 @@ static inline bool Rr_AddNodeDependency(
     Rr_GraphNode **NodeInMap =
         RR_UPSERT(&Graph->ResourceWriteToNode, Handle->Hash, Arena);
 
-    /* Treat any image read as a write for now due to layout transitions. */
-
-    if(State->Specific.Layout != VK_IMAGE_LAYOUT_UNDEFINED ||
-       RR_HAS_BIT(State->AccessMask, RR_VULKAN_WRITES))
+    if(Rr_IsWritingDependency(State))
     {
         if(*NodeInMap == NULL)
         {
@@ -754,8 +981,25 @@ OtherNodeWrites:
         Node->Name);
 
     return false;
+
+CantWriteOverlapping:
+
+    RR_LOG(
+        "Node \"%s\": trying to write overlapping ranges of a resource!",
+        Node->Name);
+
+    return false;
 }
 
+typedef struct Rr_AliasAccess Rr_AliasAccess;
+struct Rr_AliasAccess
+{
+    size_t NodeIndex;
+    Rr_NodeDependency *Dependency;
+};
+
+typedef RR_SLICE(Rr_AliasAccess) Rr_AliasAccessSlice;
+
 static void Rr_CreateGraphAdjacencyList(
     Rr_Graph *Graph,
     Rr_IndexSlice *AdjacencyList,
@@ -807,6 +1051,58 @@ static void Rr_CreateGraphAdjacencyList(
             }
         }
     }
+
+    /* Ranges of the same resource are versioned separately. Overlapping
+     * accesses to different ranges follow recording order when at least
+     * one of them writes. */
+
+    Rr_AliasAccessSlice *Accesses = RR_ALLOC_TYPE_COUNT(
+        Arena,
+        Rr_AliasAccessSlice,
+        Graph->Resources.Count);
+
+    for(size_t Index = 0; Index < Graph->Nodes.Count; ++Index)
+    {
+        Rr_GraphNode *Node = Graph->Nodes.Data[Index];
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
+        {
+            Rr_NodeDependency *Dependency = Node->Dependencies.Data + DepIndex;
+            size_t ParentIndex =
+                Graph->Resources.Data[Dependency->Handle.Values.Index]
+                    .ParentIndex;
+            if(Graph->Resources.Data[ParentIndex].HasAliases == false)
+            {
+                continue;
+            }
+
+            Rr_AliasAccessSlice *ParentAccesses = Accesses + ParentIndex;
+            for(size_t AccessIndex = 0; AccessIndex < ParentAccesses->Count;
+                ++AccessIndex)
+            {
+                Rr_AliasAccess *Access = ParentAccesses->Data + AccessIndex;
+                if(Access->NodeIndex != Index &&
+                   Access->Dependency->Handle.Values.Index !=
+                       Dependency->Handle.Values.Index &&
+                   Rr_AreResourcesOverlapping(
+                       Graph,
+                       Access->Dependency->Handle.Values.Index,
+                       Dependency->Handle.Values.Index) &&
+                   (Rr_IsWritingDependency(&Access->Dependency->State) ||
+                    Rr_IsWritingDependency(&Dependency->State)))
+                {
+                    *RR_PUSH_SLICE(&AdjacencyList[Index], Arena) =
+                        Access->NodeIndex;
+                }
+            }
+
+            *RR_PUSH_SLICE(ParentAccesses, Arena) = (Rr_AliasAccess){
+                .NodeIndex = Index,
+                .Dependency = Dependency,
+            };
+        }
+    }
 }
 
 static void Rr_SortGraph(
@@ -872,96 +1168,414 @@ static void Rr_PrintAdjacencyList(
     }
 }
 
-static void Rr_ProcessGraphNodes(
-    Rr_Graph *Graph,
-    Rr_NodeSlice *SortedNodes,
-    Rr_Arena *Arena)
+static bool Rr_IsSinkResource(Rr_Graph *Graph, size_t ResourceIndex)
 {
-    if(Graph->Nodes.Count == 0)
-    {
-        RR_LOG("Graph doesn't contain any nodes!");
+    ResourceIndex = Graph->Resources.Data[ResourceIndex].ParentIndex;
+    Rr_GraphResource *Resource = Graph->Resources.Data + ResourceIndex;
 
-        return;
+    if(ResourceIndex == Graph->SwapchainImageResourceIndex ||
+       Resource->IsExported)
+    {
+        return true;
     }
 
-    Rr_Scratch Scratch = Rr_GetScratch(Arena);
-
-    /* Adjacency list maps a node to a set of nodes that must
-     * be executed before it. */
-
-    Rr_IndexSlice *AdjacencyList =
-        RR_ALLOC_TYPE_COUNT(Scratch.Arena, Rr_IndexSlice, Graph->Nodes.Count);
-    Rr_CreateGraphAdjacencyList(Graph, AdjacencyList, Scratch.Arena);
-
-    // Rr_PrintAdjacencyList(Graph->Nodes.Data, AdjacencyList,
-    // Graph->Nodes.Count);
-
-    /* Topological sort. */
-
-    int *SortState = RR_ALLOC(Scratch.Arena, sizeof(int) * Graph->Nodes.Count);
-    for(size_t Index = 0; Index < Graph->Nodes.Count; ++Index)
+    if(Resource->IsImage)
     {
-        Rr_GraphNode *Node = Graph->Nodes.Data[Index];
-        if(Node != NULL)
-        {
-            Rr_SortGraph(
-                Node->OriginalIndex,
-                AdjacencyList,
-                SortState,
-                Graph->Nodes.Data,
-                SortedNodes);
-        }
+        Rr_Image *Image = Resource->Container;
+        return RR_HAS_BIT(Image->Flags, RR_IMAGE_FLAGS_READBACK_BIT);
     }
+    else
+    {
+        Rr_Buffer *Buffer = Resource->Container;
+        return RR_HAS_BIT(Buffer->Flags, RR_BUFFER_FLAGS_READBACK_BIT);
+    }
+}
 
-    /* Split nodes between early and late command buffers. */
-    /* @TODO: Probably shouldn't require its own pass? */
-    /* @TODO: Some early nodes still get batched for late execution. */
-
-    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+static bool Rr_IsWritingOverlappingRange(
+    Rr_Graph *Graph,
+    Rr_GraphNode *Writer,
+    Rr_GraphNode *Node)
+{
+    for(size_t WriteIndex = 0; WriteIndex < Writer->Dependencies.Count;
+        ++WriteIndex)
     {
-        Rr_GraphNode *Node = SortedNodes->Data[Index];
-        if(Node->UsesLateCommandBuffer)
+        Rr_NodeDependency *Write = Writer->Dependencies.Data + WriteIndex;
+        if(Rr_IsWritingDependency(&Write->State) == false)
         {
             continue;
         }
-        Rr_IndexSlice *Dependencies = &AdjacencyList[Node->OriginalIndex];
-        for(size_t DependencyIndex = 0; DependencyIndex < Dependencies->Count;
-            ++DependencyIndex)
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
         {
-            Rr_GraphNode *Dependency =
-                Graph->Nodes.Data[Dependencies->Data[DependencyIndex]];
-            Node->UsesLateCommandBuffer |= Dependency->UsesLateCommandBuffer;
+            Rr_NodeDependency *Dependency = Node->Dependencies.Data + DepIndex;
+            if(Write->Handle.Values.Index != Dependency->Handle.Values.Index &&
+               Rr_AreResourcesOverlapping(
+                   Graph,
+                   Write->Handle.Values.Index,
+                   Dependency->Handle.Values.Index))
+            {
+                return true;
+            }
         }
     }
 
-    // Rr_PrintAdjacencyList(Graph->Nodes.Data, AdjacencyList,
-    // Graph->Nodes.Count);
+    return false;
+}
 
-    /* Longest path search will determine dependency level for each node.
-     * Nodes within same dependency level are meant to be batched together. */
+static void Rr_CullGraphNodes(
+    Rr_Graph *Graph,
+    Rr_IndexSlice *AdjacencyList,
+    Rr_NodeSlice *SortedNodes)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(NULL);
 
-    Rr_GraphNode **Reversed =
-        RR_ALLOC_TYPE_COUNT(Scratch.Arena, Rr_GraphNode *, SortedNodes->Count);
-    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
-    {
-        Reversed[Index] = SortedNodes->Data[SortedNodes->Count - 1 - Index];
-    }
+    bool *IsLive = RR_ALLOC_TYPE_COUNT(Scratch.Arena, bool, Graph->Nodes.Count);
 
-    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    /* Walk back from nodes writing sink resources. Reverse topological
+     * order visits every consumer before the producers it reads from. */
+
+    for(size_t Index = SortedNodes->Count; Index-- > 0;)
     {
-        Rr_GraphNode *Node = Reversed[Index];
-        size_t OriginalIndex = Node->OriginalIndex;
-        for(size_t DepIndex = 0; DepIndex < AdjacencyList[OriginalIndex].Count;
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
             ++DepIndex)
         {
-            size_t DepNodeIndex = AdjacencyList[OriginalIndex].Data[DepIndex];
-            Graph->Nodes.Data[DepNodeIndex]->DependencyLevel = RR_MAX(
+            Rr_NodeDependency *Dependency = Node->Dependencies.Data + DepIndex;
+            Rr_GraphNode *Writer = RR_UPSERT_DEREF(
+                &Graph->ResourceWriteToNode,
+                Dependency->Handle.Hash,
+                Graph->Arena);
+            if(Writer == Node &&
+               Rr_IsSinkResource(Graph, Dependency->Handle.Values.Index))
+            {
+                IsLive[Node->OriginalIndex] = true;
+            }
+        }
+
+        if(IsLive[Node->OriginalIndex] == false)
+        {
+            continue;
+        }
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
+        {
+            Rr_GraphHandle Handle = Node->Dependencies.Data[DepIndex].Handle;
+            if(Handle.Values.Generation > 0)
+            {
+                Handle.Values.Generation--;
+                Rr_GraphNode *Producer = RR_UPSERT_DEREF(
+                    &Graph->ResourceWriteToNode,
+                    Handle.Hash,
+                    Graph->Arena);
+                if(Producer != NULL)
+                {
+                    IsLive[Producer->OriginalIndex] = true;
+                }
+            }
+        }
+
+        /* Writers of other ranges overlapping what this node accesses. */
+
+        Rr_IndexSlice *Dependencies = &AdjacencyList[Node->OriginalIndex];
+        for(size_t AdjIndex = 0; AdjIndex < Dependencies->Count; ++AdjIndex)
+        {
+            Rr_GraphNode *Other =
+                Graph->Nodes.Data[Dependencies->Data[AdjIndex]];
+            if(IsLive[Other->OriginalIndex] == false &&
+               Rr_IsWritingOverlappingRange(Graph, Other, Node))
+            {
+                IsLive[Other->OriginalIndex] = true;
+            }
+        }
+    }
+
+    size_t LiveCount = 0;
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+        if(IsLive[Node->OriginalIndex])
+        {
+            SortedNodes->Data[LiveCount++] = Node;
+        }
+    }
+    SortedNodes->Count = LiveCount;
+
+    Rr_DestroyScratch(Scratch);
+}
+
+/* Stable counting sort by descending dependency level. A node only
+ * depends on nodes of higher levels, so the order stays topological. */
+
+static void Rr_SortGraphNodesByLevel(
+    Rr_NodeSlice *SortedNodes,
+    Rr_Arena *Arena)
+{
+    size_t MaxLevel = 0;
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        MaxLevel = RR_MAX(MaxLevel, SortedNodes->Data[Index]->DependencyLevel);
+    }
+
+    size_t *Offsets = RR_ALLOC_TYPE_COUNT(Arena, size_t, MaxLevel + 2);
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Offsets[MaxLevel - SortedNodes->Data[Index]->DependencyLevel + 1]++;
+    }
+    for(size_t Level = 1; Level <= MaxLevel + 1; ++Level)
+    {
+        Offsets[Level] += Offsets[Level - 1];
+    }
+
+    Rr_GraphNode **Nodes =
+        RR_ALLOC_TYPE_COUNT(Arena, Rr_GraphNode *, SortedNodes->Count);
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+        Nodes[Offsets[MaxLevel - Node->DependencyLevel]++] = Node;
+    }
+    memcpy(
+        SortedNodes->Data,
+        Nodes,
+        sizeof(Rr_GraphNode *) * SortedNodes->Count);
+}
+
+static void Rr_ProcessGraphNodes(
+    Rr_Graph *Graph,
+    Rr_NodeSlice *SortedNodes,
+    Rr_Arena *Arena)
+{
+    if(Graph->Nodes.Count == 0)
+    {
+        RR_LOG("Graph doesn't contain any nodes!");
+
+        return;
+    }
+
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+
+    /* Adjacency list maps a node to a set of nodes that must
+     * be executed before it. */
+
+    Rr_IndexSlice *AdjacencyList =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, Rr_IndexSlice, Graph->Nodes.Count);
+    Rr_CreateGraphAdjacencyList(Graph, AdjacencyList, Scratch.Arena);
+
+    // Rr_PrintAdjacencyList(Graph->Nodes.Data, AdjacencyList,
+    // Graph->Nodes.Count);
+
+    /* Topological sort. */
+
+    int *SortState = RR_ALLOC(Scratch.Arena, sizeof(int) * Graph->Nodes.Count);
+    for(size_t Index = 0; Index < Graph->Nodes.Count; ++Index)
+    {
+        Rr_GraphNode *Node = Graph->Nodes.Data[Index];
+        if(Node != NULL)
+        {
+            Rr_SortGraph(
+                Node->OriginalIndex,
+                AdjacencyList,
+                SortState,
+                Graph->Nodes.Data,
+                SortedNodes);
+        }
+    }
+
+    /* Drop nodes whose writes are never observed. */
+
+    Rr_CullGraphNodes(Graph, AdjacencyList, SortedNodes);
+
+    /* Split nodes between early and late command buffers. */
+    /* @TODO: Probably shouldn't require its own pass? */
+    /* @TODO: Some early nodes still get batched for late execution. */
+
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+        if(Node->UsesLateCommandBuffer)
+        {
+            continue;
+        }
+        Rr_IndexSlice *Dependencies = &AdjacencyList[Node->OriginalIndex];
+        for(size_t DependencyIndex = 0; DependencyIndex < Dependencies->Count;
+            ++DependencyIndex)
+        {
+            Rr_GraphNode *Dependency =
+                Graph->Nodes.Data[Dependencies->Data[DependencyIndex]];
+            Node->UsesLateCommandBuffer |= Dependency->UsesLateCommandBuffer;
+        }
+    }
+
+    // Rr_PrintAdjacencyList(Graph->Nodes.Data, AdjacencyList,
+    // Graph->Nodes.Count);
+
+    /* Longest path search will determine dependency level for each node.
+     * Nodes within same dependency level are meant to be batched together. */
+
+    Rr_GraphNode **Reversed =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, Rr_GraphNode *, SortedNodes->Count);
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Reversed[Index] = SortedNodes->Data[SortedNodes->Count - 1 - Index];
+    }
+
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = Reversed[Index];
+        size_t OriginalIndex = Node->OriginalIndex;
+        for(size_t DepIndex = 0; DepIndex < AdjacencyList[OriginalIndex].Count;
+            ++DepIndex)
+        {
+            size_t DepNodeIndex = AdjacencyList[OriginalIndex].Data[DepIndex];
+            Graph->Nodes.Data[DepNodeIndex]->DependencyLevel = RR_MAX(
                 Graph->Nodes.Data[DepNodeIndex]->DependencyLevel,
                 Graph->Nodes.Data[OriginalIndex]->DependencyLevel + 1);
         }
     }
 
+    /* The executor batches consecutive nodes of the same level, and
+     * transient image lifetimes assume levels run highest first. */
+
+    Rr_SortGraphNodesByLevel(SortedNodes, Scratch.Arena);
+
+    Rr_DestroyScratch(Scratch);
+}
+
+static uint64_t Rr_GetGraphFingerprint(Rr_Graph *Graph, Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+
+    /* Fingerprint covers everything the sort, culling and dependency
+     * level assignment depend on: node types, sink resources, resource
+     * ranges, handles (including generations) and requested
+     * synchronization states. */
+
+    RR_SLICE(uint64_t) Words = { 0 };
+    *RR_PUSH_SLICE(&Words, Scratch.Arena) = Graph->Nodes.Count;
+    *RR_PUSH_SLICE(&Words, Scratch.Arena) = Graph->Resources.Count;
+    *RR_PUSH_SLICE(&Words, Scratch.Arena) = Graph->SwapchainImageResourceIndex;
+
+    for(size_t Index = 0; Index < Graph->Resources.Count; ++Index)
+    {
+        Rr_GraphResource *Resource = Graph->Resources.Data + Index;
+        *RR_PUSH_SLICE(&Words, Scratch.Arena) =
+            Rr_IsSinkResource(Graph, Index);
+        *RR_PUSH_SLICE(&Words, Scratch.Arena) = Resource->ParentIndex;
+        *RR_PUSH_SLICE(&Words, Scratch.Arena) = Resource->Range.Begin;
+        *RR_PUSH_SLICE(&Words, Scratch.Arena) = Resource->Range.End;
+    }
+
+    for(size_t Index = 0; Index < Graph->Nodes.Count; ++Index)
+    {
+        Rr_GraphNode *Node = Graph->Nodes.Data[Index];
+        *RR_PUSH_SLICE(&Words, Scratch.Arena) = Node->Type;
+        *RR_PUSH_SLICE(&Words, Scratch.Arena) = Node->UsesLateCommandBuffer;
+        *RR_PUSH_SLICE(&Words, Scratch.Arena) = Node->Dependencies.Count;
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
+        {
+            Rr_NodeDependency *Dependency = Node->Dependencies.Data + DepIndex;
+            *RR_PUSH_SLICE(&Words, Scratch.Arena) = Dependency->Handle.Hash;
+            *RR_PUSH_SLICE(&Words, Scratch.Arena) = Dependency->State.StageMask;
+            *RR_PUSH_SLICE(&Words, Scratch.Arena) =
+                Dependency->State.AccessMask;
+            *RR_PUSH_SLICE(&Words, Scratch.Arena) =
+                Dependency->State.Specific.Layout;
+        }
+    }
+
+    uint64_t Fingerprint =
+        XXH3_64bits(Words.Data, sizeof(uint64_t) * Words.Count);
+
     Rr_DestroyScratch(Scratch);
+
+    return Fingerprint;
+}
+
+static bool Rr_LoadCompiledGraph(
+    Rr_GraphCache *Cache,
+    Rr_Graph *Graph,
+    uint64_t Fingerprint,
+    Rr_NodeSlice *SortedNodes)
+{
+    for(size_t Index = 0; Index < RR_GRAPH_CACHE_SIZE; ++Index)
+    {
+        Rr_CompiledGraph *Compiled = Cache->Entries + Index;
+        if(Compiled->Arena == NULL || Compiled->Fingerprint != Fingerprint ||
+           Compiled->GraphNodeCount != Graph->Nodes.Count)
+        {
+            continue;
+        }
+
+        for(size_t NodeIndex = 0; NodeIndex < Compiled->NodeCount;
+            ++NodeIndex)
+        {
+            Rr_GraphNode *Node =
+                Graph->Nodes.Data[Compiled->SortedIndices[NodeIndex]];
+            Node->DependencyLevel = Compiled->DependencyLevels[NodeIndex];
+            Node->UsesLateCommandBuffer =
+                Compiled->UsesLateCommandBuffer[NodeIndex];
+            *RR_PUSH_SLICE(SortedNodes, NULL) = Node;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+static void Rr_StoreCompiledGraph(
+    Rr_GraphCache *Cache,
+    Rr_Graph *Graph,
+    uint64_t Fingerprint,
+    Rr_NodeSlice *SortedNodes)
+{
+    Rr_CompiledGraph *Compiled = Cache->Entries + Cache->NextEntryIndex;
+    Cache->NextEntryIndex = (Cache->NextEntryIndex + 1) % RR_GRAPH_CACHE_SIZE;
+
+    if(Compiled->Arena == NULL)
+    {
+        Compiled->Arena = Rr_CreateDefaultArena();
+    }
+    else
+    {
+        Rr_ResetArena(Compiled->Arena);
+    }
+
+    size_t Count = SortedNodes->Count;
+    Compiled->Fingerprint = Fingerprint;
+    Compiled->GraphNodeCount = Graph->Nodes.Count;
+    Compiled->NodeCount = Count;
+    Compiled->SortedIndices =
+        RR_ALLOC_TYPE_COUNT(Compiled->Arena, size_t, Count);
+    Compiled->DependencyLevels =
+        RR_ALLOC_TYPE_COUNT(Compiled->Arena, size_t, Count);
+    Compiled->UsesLateCommandBuffer =
+        RR_ALLOC_TYPE_COUNT(Compiled->Arena, bool, Count);
+
+    for(size_t Index = 0; Index < Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+        Compiled->SortedIndices[Index] = Node->OriginalIndex;
+        Compiled->DependencyLevels[Index] = Node->DependencyLevel;
+        Compiled->UsesLateCommandBuffer[Index] = Node->UsesLateCommandBuffer;
+    }
+}
+
+void Rr_CleanupGraphCache(Rr_GraphCache *Cache)
+{
+    for(size_t Index = 0; Index < RR_GRAPH_CACHE_SIZE; ++Index)
+    {
+        Rr_CompiledGraph *Compiled = Cache->Entries + Index;
+        if(Compiled->Arena != NULL)
+        {
+            Rr_DestroyArena(Compiled->Arena);
+        }
+    }
+
+    *Cache = (Rr_GraphCache){ 0 };
 }
 
 static void Rr_ExecuteGraphNode(
@@ -975,7 +1589,12 @@ static void Rr_ExecuteGraphNode(
         case RR_GRAPH_NODE_TYPE_COMPUTE:
         {
             Rr_ComputeNode *ComputeNode = &Node->Union.Compute;
-            Rr_ExecuteComputeNode(Renderer, Graph, ComputeNode, CommandBuffer);
+            Rr_ExecuteComputeNode(
+                Renderer,
+                Graph,
+                ComputeNode,
+                &Rr_GetCurrentFrame(Renderer)->DescriptorAllocator,
+                CommandBuffer);
         }
         break;
         case RR_GRAPH_NODE_TYPE_GRAPHICS:
@@ -1012,47 +1631,390 @@ static void Rr_ExecuteGraphNode(
     }
 }
 
-static void Rr_ApplyBarrierBatch(
+static bool Rr_IsNodeRecordable(Rr_GraphNode *Node)
+{
+    return Node->Type == RR_GRAPH_NODE_TYPE_GRAPHICS ||
+           Node->Type == RR_GRAPH_NODE_TYPE_COMPUTE;
+}
+
+static void Rr_RecordJob(
     Rr_Renderer *Renderer,
-    Rr_BarrierBatch *Barrier,
-    VkCommandBuffer CommandBuffer,
+    Rr_Graph *Graph,
+    Rr_RecordingContext *Context,
+    Rr_RecordingJob *Job,
     Rr_Arena *Arena)
 {
-    Rr_Scratch Scratch = Rr_GetScratch(Arena);
-
     Rr_Device *Device = &Renderer->Device;
 
-    size_t MaxPossibleBarriers =
-        Barrier->BufferBarriers.Count + Barrier->ImageBarriers.Count;
-
-    if(MaxPossibleBarriers == 0)
+    if(Context->CommandBufferIndex >= Context->CommandBuffers.Count)
     {
-        return;
+        VkCommandBufferAllocateInfo CommandBufferAllocateInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = VK_NULL_HANDLE,
+            .commandPool = Context->CommandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1,
+        };
+        Device->AllocateCommandBuffers(
+            Device->Handle,
+            &CommandBufferAllocateInfo,
+            RR_PUSH_SLICE(&Context->CommandBuffers, Arena));
     }
+    VkCommandBuffer CommandBuffer =
+        Context->CommandBuffers.Data[Context->CommandBufferIndex++];
 
-    VkPipelineStageFlags SrcStageMaskEarly = 0;
-    VkPipelineStageFlags DstStageMaskEarly = 0;
-    RR_SLICE(VkBufferMemoryBarrier) BufferBarriersEarly = { 0 };
-    RR_RESERVE_SLICE(
-        &BufferBarriersEarly,
-        Barrier->BufferBarriers.Count,
-        Scratch.Arena);
-    RR_SLICE(VkImageMemoryBarrier) ImageBarriersEarly = { 0 };
-    RR_RESERVE_SLICE(
-        &ImageBarriersEarly,
-        Barrier->ImageBarriers.Count,
-        Scratch.Arena);
+    Rr_GraphNode *Node = Job->Node;
 
-    VkPipelineStageFlags SrcStageMask = 0;
-    VkPipelineStageFlags DstStageMask = 0;
-    RR_SLICE(VkBufferMemoryBarrier) BufferBarriers = { 0 };
-    RR_RESERVE_SLICE(
-        &BufferBarriers,
-        Barrier->BufferBarriers.Count,
-        Scratch.Arena);
-    RR_SLICE(VkImageMemoryBarrier) ImageBarriers = { 0 };
-    RR_RESERVE_SLICE(
-        &ImageBarriers,
+    VkCommandBufferBeginInfo CommandBufferBeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = NULL,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = &Job->InheritanceInfo,
+    };
+    if(Node->Type == RR_GRAPH_NODE_TYPE_GRAPHICS)
+    {
+        CommandBufferBeginInfo.flags |=
+            VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    }
+    Device->BeginCommandBuffer(CommandBuffer, &CommandBufferBeginInfo);
+
+    if(Node->Type == RR_GRAPH_NODE_TYPE_GRAPHICS)
+    {
+        Rr_RecordGraphicsNode(
+            Renderer,
+            Graph,
+            &Node->Union.Graphics,
+            Job->Viewport,
+            &Context->DescriptorAllocator,
+            CommandBuffer);
+    }
+    else
+    {
+        Rr_ExecuteComputeNode(
+            Renderer,
+            Graph,
+            &Node->Union.Compute,
+            &Context->DescriptorAllocator,
+            CommandBuffer);
+    }
+
+    Device->EndCommandBuffer(CommandBuffer);
+
+    Job->CommandBuffer = CommandBuffer;
+}
+
+int SDLCALL Rr_RecordingThreadProc(void *UserData)
+{
+    Rr_RecordingThread *Thread = UserData;
+
+    Rr_Renderer *Renderer = Thread->Renderer;
+    Rr_RecordingThreads *Threads = &Renderer->RecordingThreads;
+
+    Rr_InitScratch(
+        RR_RECORDING_THREAD_SCRATCH_SIZE,
+        RR_SCRATCH_ARENA_COUNT,
+        0);
+
+    while(true)
+    {
+        SDL_WaitSemaphore(Thread->Semaphore);
+
+        if(Threads->ExitRequested)
+        {
+            break;
+        }
+
+        Rr_RecordingContext *Context =
+            Thread->Contexts + Renderer->CurrentFrameIndex;
+
+        while(true)
+        {
+            size_t JobIndex =
+                (size_t)SDL_AddAtomicInt(&Threads->NextJobIndex, 1);
+            if(JobIndex >= Threads->JobCount)
+            {
+                break;
+            }
+            Rr_RecordJob(
+                Renderer,
+                Threads->Graph,
+                Context,
+                Threads->Jobs + JobIndex,
+                Thread->Arena);
+        }
+
+        SDL_SignalSemaphore(Threads->DoneSemaphore);
+    }
+
+    SDL_CleanupTLS();
+
+    return 0;
+}
+
+static void Rr_ExecuteGraphBatch(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_GraphNode **Nodes,
+    size_t NodeCount,
+    VkCommandBuffer CommandBuffer,
+    size_t ConflictCount,
+    Rr_Arena **Conflicts)
+{
+    Rr_Device *Device = &Renderer->Device;
+    Rr_RecordingThreads *Threads = &Renderer->RecordingThreads;
+
+    /* Nodes within a batch are independent. Spread them across worker
+     * threads only when there is more than one to record. */
+
+    size_t JobCount = 0;
+    for(size_t Index = 0; Index < NodeCount; ++Index)
+    {
+        JobCount += Rr_IsNodeRecordable(Nodes[Index]) ? 1 : 0;
+    }
+
+    if(Threads->Count == 0 || JobCount < 2)
+    {
+        for(size_t Index = 0; Index < NodeCount; ++Index)
+        {
+            Rr_ExecuteGraphNode(Renderer, Graph, Nodes[Index], CommandBuffer);
+        }
+
+        return;
+    }
+
+    Rr_Scratch Scratch = Rr_GetScratchAvoiding(ConflictCount, Conflicts);
+
+    /* Render passes and framebuffers are resolved here since
+     * renderer caches are not thread safe. */
+
+    Rr_RecordingJob *Jobs =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, Rr_RecordingJob, JobCount);
+    size_t JobIndex = 0;
+    for(size_t Index = 0; Index < NodeCount; ++Index)
+    {
+        Rr_GraphNode *Node = Nodes[Index];
+        if(Rr_IsNodeRecordable(Node) == false)
+        {
+            continue;
+        }
+
+        Rr_RecordingJob *Job = Jobs + JobIndex++;
+        Job->Node = Node;
+        Job->InheritanceInfo = (VkCommandBufferInheritanceInfo){
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .pNext = NULL,
+        };
+
+        if(Node->Type == RR_GRAPH_NODE_TYPE_GRAPHICS)
+        {
+            Rr_GraphicsNodePass Pass = Rr_PrepareGraphicsNodePass(
+                Renderer,
+                Graph,
+                &Node->Union.Graphics,
+                Scratch.Arena);
+            Job->Viewport = Pass.Viewport;
+            Job->RenderPassBeginInfo = Pass.BeginInfo;
+            Job->InheritanceInfo.renderPass = Pass.BeginInfo.renderPass;
+            Job->InheritanceInfo.subpass = 0;
+            Job->InheritanceInfo.framebuffer = Pass.BeginInfo.framebuffer;
+        }
+    }
+
+    Threads->Graph = Graph;
+    Threads->Jobs = Jobs;
+    Threads->JobCount = JobCount;
+    SDL_SetAtomicInt(&Threads->NextJobIndex, 0);
+    for(size_t Index = 0; Index < Threads->Count; ++Index)
+    {
+        SDL_SignalSemaphore(Threads->Threads[Index].Semaphore);
+    }
+
+    /* Blits and transfers are cheap, record them inline meanwhile. */
+
+    for(size_t Index = 0; Index < NodeCount; ++Index)
+    {
+        if(Rr_IsNodeRecordable(Nodes[Index]) == false)
+        {
+            Rr_ExecuteGraphNode(Renderer, Graph, Nodes[Index], CommandBuffer);
+        }
+    }
+
+    for(size_t Index = 0; Index < Threads->Count; ++Index)
+    {
+        SDL_WaitSemaphore(Threads->DoneSemaphore);
+    }
+
+    for(size_t Index = 0; Index < JobCount; ++Index)
+    {
+        Rr_RecordingJob *Job = Jobs + Index;
+        if(Job->Node->Type == RR_GRAPH_NODE_TYPE_GRAPHICS)
+        {
+            Device->CmdBeginRenderPass(
+                CommandBuffer,
+                &Job->RenderPassBeginInfo,
+                VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            Device->CmdExecuteCommands(CommandBuffer, 1, &Job->CommandBuffer);
+            Device->CmdEndRenderPass(CommandBuffer);
+        }
+        else
+        {
+            Device->CmdExecuteCommands(CommandBuffer, 1, &Job->CommandBuffer);
+        }
+    }
+
+    Rr_DestroyScratch(Scratch);
+}
+
+/* A read following another read in the same layout keeps the earlier
+ * readers in the state. The next write then waits for all of them and
+ * later reads of any of these kinds skip their barrier. */
+
+static inline void Rr_MergeReadState(
+    Rr_SyncState *NewState,
+    VkPipelineStageFlags SrcStageMask,
+    VkAccessFlags SrcAccessMask,
+    VkImageLayout OldLayout,
+    uint32_t SrcQueueFamilyIndex)
+{
+    VkAccessFlags AccessMask = SrcAccessMask | NewState->AccessMask;
+    if(RR_HAS_BIT(AccessMask, RR_VULKAN_WRITES) == false &&
+       OldLayout == NewState->Specific.Layout &&
+       SrcQueueFamilyIndex == VK_QUEUE_FAMILY_IGNORED)
+    {
+        NewState->StageMask |= SrcStageMask;
+        NewState->AccessMask = AccessMask;
+    }
+}
+
+/* Converts a barrier for recording and moves the tracked state of the
+ * resource to the destination of the barrier. */
+
+static VkBufferMemoryBarrier Rr_ResolveBufferBarrier(
+    Rr_Renderer *Renderer,
+    Rr_BufferMemoryBarrier *BufferBarrier,
+    bool IsCompute)
+{
+    Rr_SyncState NewState = {
+        .StageMask = BufferBarrier->DstStageMask,
+        .AccessMask = BufferBarrier->DstAccessMask,
+        .ComputeOwned = IsCompute,
+    };
+    Rr_MergeReadState(
+        &NewState,
+        BufferBarrier->SrcStageMask,
+        BufferBarrier->SrcAccessMask,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        BufferBarrier->SrcQueueFamilyIndex);
+
+    *Rr_GetSynchronizationState(Renderer, (Rr_MapKey)BufferBarrier->Buffer) =
+        NewState;
+
+    return (VkBufferMemoryBarrier){
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .buffer = BufferBarrier->Buffer,
+        .srcAccessMask = BufferBarrier->SrcAccessMask,
+        .dstAccessMask = BufferBarrier->DstAccessMask,
+        .srcQueueFamilyIndex = BufferBarrier->SrcQueueFamilyIndex,
+        .dstQueueFamilyIndex = BufferBarrier->DstQueueFamilyIndex,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+}
+
+static VkImageMemoryBarrier Rr_ResolveImageBarrier(
+    Rr_Renderer *Renderer,
+    Rr_ImageMemoryBarrier *ImageBarrier,
+    bool IsCompute)
+{
+    Rr_MapKey Key = (Rr_MapKey)ImageBarrier->Image;
+    Rr_SyncState NewState = {
+        .StageMask = ImageBarrier->DstStageMask,
+        .AccessMask = ImageBarrier->DstAccessMask,
+        .Specific.Layout = ImageBarrier->NewLayout,
+        .ComputeOwned = IsCompute,
+    };
+    Rr_MergeReadState(
+        &NewState,
+        ImageBarrier->SrcStageMask,
+        ImageBarrier->SrcAccessMask,
+        ImageBarrier->OldLayout,
+        ImageBarrier->SrcQueueFamilyIndex);
+
+    /* Partial barriers are only created for split states. */
+
+    Rr_SyncState *ImageState = Rr_GetSynchronizationState(Renderer, Key);
+    if(ImageState->SubresourceCount == 0)
+    {
+        *ImageState = NewState;
+    }
+    else
+    {
+        VkImageSubresourceRange *Range = &ImageBarrier->SubresourceRange;
+        uint32_t LevelCount = Range->levelCount == VK_REMAINING_MIP_LEVELS
+                                  ? ImageState->SubresourceCount -
+                                        Range->baseMipLevel
+                                  : Range->levelCount;
+        for(uint32_t Level = 0; Level < LevelCount; ++Level)
+        {
+            *Rr_GetSubresourceSynchronizationState(
+                Renderer,
+                Key,
+                Range->baseMipLevel + Level) = NewState;
+        }
+    }
+
+    return (VkImageMemoryBarrier){
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .image = ImageBarrier->Image,
+        .srcAccessMask = ImageBarrier->SrcAccessMask,
+        .dstAccessMask = ImageBarrier->DstAccessMask,
+        .oldLayout = ImageBarrier->OldLayout,
+        .newLayout = ImageBarrier->NewLayout,
+        .srcQueueFamilyIndex = ImageBarrier->SrcQueueFamilyIndex,
+        .dstQueueFamilyIndex = ImageBarrier->DstQueueFamilyIndex,
+        .subresourceRange = ImageBarrier->SubresourceRange,
+    };
+}
+
+/* Without Synchronization2 all barriers of a batch share one stage
+ * mask. Barriers waited on by vertex processing are recorded separately
+ * so they don't have to wait for everything else. */
+
+static void Rr_RecordBarriers(
+    Rr_Renderer *Renderer,
+    Rr_BarrierBatch *Barrier,
+    VkCommandBuffer CommandBuffer,
+    bool IsCompute,
+    size_t ConflictCount,
+    Rr_Arena **Conflicts)
+{
+    Rr_Scratch Scratch = Rr_GetScratchAvoiding(ConflictCount, Conflicts);
+
+    Rr_Device *Device = &Renderer->Device;
+
+    VkPipelineStageFlags SrcStageMaskEarly = 0;
+    VkPipelineStageFlags DstStageMaskEarly = 0;
+    RR_SLICE(VkBufferMemoryBarrier) BufferBarriersEarly = { 0 };
+    RR_RESERVE_SLICE(
+        &BufferBarriersEarly,
+        Barrier->BufferBarriers.Count,
+        Scratch.Arena);
+    RR_SLICE(VkImageMemoryBarrier) ImageBarriersEarly = { 0 };
+    RR_RESERVE_SLICE(
+        &ImageBarriersEarly,
+        Barrier->ImageBarriers.Count,
+        Scratch.Arena);
+
+    VkPipelineStageFlags SrcStageMask = 0;
+    VkPipelineStageFlags DstStageMask = 0;
+    RR_SLICE(VkBufferMemoryBarrier) BufferBarriers = { 0 };
+    RR_RESERVE_SLICE(
+        &BufferBarriers,
+        Barrier->BufferBarriers.Count,
+        Scratch.Arena);
+    RR_SLICE(VkImageMemoryBarrier) ImageBarriers = { 0 };
+    RR_RESERVE_SLICE(
+        &ImageBarriers,
         Barrier->ImageBarriers.Count,
         Scratch.Arena);
 
@@ -1075,22 +2037,8 @@ static void Rr_ApplyBarrierBatch(
             BarriersSlice = (void *)&BufferBarriers;
         }
 
-        *RR_PUSH_SLICE(BarriersSlice, Scratch.Arena) = (VkBufferMemoryBarrier){
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-            .buffer = BufferBarrier->Buffer,
-            .srcAccessMask = BufferBarrier->SrcAccessMask,
-            .dstAccessMask = BufferBarrier->DstAccessMask,
-            .offset = 0,
-            .size = VK_WHOLE_SIZE,
-        };
-
-        Rr_SyncState *BufferState = Rr_GetSynchronizationState(
-            Renderer,
-            (Rr_MapKey)BufferBarrier->Buffer);
-        *BufferState = (Rr_SyncState){
-            .StageMask = BufferBarrier->DstStageMask,
-            .AccessMask = BufferBarrier->DstAccessMask,
-        };
+        *RR_PUSH_SLICE(BarriersSlice, Scratch.Arena) =
+            Rr_ResolveBufferBarrier(Renderer, BufferBarrier, IsCompute);
     }
 
     for(size_t Index = 0; Index < Barrier->ImageBarriers.Count; ++Index)
@@ -1112,25 +2060,8 @@ static void Rr_ApplyBarrierBatch(
             BarriersSlice = (void *)&ImageBarriers;
         }
 
-        *RR_PUSH_SLICE(BarriersSlice, Scratch.Arena) = (VkImageMemoryBarrier){
-            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-            .image = ImageBarrier->Image,
-            .srcAccessMask = ImageBarrier->SrcAccessMask,
-            .dstAccessMask = ImageBarrier->DstAccessMask,
-            .oldLayout = ImageBarrier->OldLayout,
-            .newLayout = ImageBarrier->NewLayout,
-            .subresourceRange = ImageBarrier->SubresourceRange,
-        };
-
-        Rr_SyncState *ImageState = Rr_GetSynchronizationState(
-            Renderer,
-            (Rr_MapKey)ImageBarrier->Image);
-
-        *ImageState = (Rr_SyncState){
-            .StageMask = ImageBarrier->DstStageMask,
-            .AccessMask = ImageBarrier->DstAccessMask,
-            .Specific.Layout = ImageBarrier->NewLayout,
-        };
+        *RR_PUSH_SLICE(BarriersSlice, Scratch.Arena) =
+            Rr_ResolveImageBarrier(Renderer, ImageBarrier, IsCompute);
     }
 
     if(BufferBarriersEarly.Count > 0 || ImageBarriersEarly.Count > 0)
@@ -1163,242 +2094,1631 @@ static void Rr_ApplyBarrierBatch(
             ImageBarriers.Data);
     }
 
-    Barrier->ImageBarriers.Count = 0;
-    Barrier->BufferBarriers.Count = 0;
-    Barrier->VulkanHandleToBarrier = NULL;
+    Rr_DestroyScratch(Scratch);
+}
+
+/* Synchronization2 keeps stage masks per barrier, a barrier waiting
+ * for a transfer no longer waits for unrelated fragment work. */
+
+static void Rr_RecordBarriers2(
+    Rr_Renderer *Renderer,
+    Rr_BarrierBatch *Barrier,
+    VkCommandBuffer CommandBuffer,
+    bool IsCompute,
+    size_t ConflictCount,
+    Rr_Arena **Conflicts)
+{
+    Rr_Scratch Scratch = Rr_GetScratchAvoiding(ConflictCount, Conflicts);
+
+    Rr_Device *Device = &Renderer->Device;
+
+    VkBufferMemoryBarrier2KHR *BufferBarriers = RR_ALLOC_TYPE_COUNT(
+        Scratch.Arena,
+        VkBufferMemoryBarrier2KHR,
+        Barrier->BufferBarriers.Count);
+    VkImageMemoryBarrier2KHR *ImageBarriers = RR_ALLOC_TYPE_COUNT(
+        Scratch.Arena,
+        VkImageMemoryBarrier2KHR,
+        Barrier->ImageBarriers.Count);
+
+    for(size_t Index = 0; Index < Barrier->BufferBarriers.Count; ++Index)
+    {
+        Rr_BufferMemoryBarrier *BufferBarrier =
+            Barrier->BufferBarriers.Data + Index;
+        VkBufferMemoryBarrier Resolved =
+            Rr_ResolveBufferBarrier(Renderer, BufferBarrier, IsCompute);
+        BufferBarriers[Index] = (VkBufferMemoryBarrier2KHR){
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR,
+            .srcStageMask = BufferBarrier->SrcStageMask,
+            .srcAccessMask = Resolved.srcAccessMask,
+            .dstStageMask = BufferBarrier->DstStageMask,
+            .dstAccessMask = Resolved.dstAccessMask,
+            .srcQueueFamilyIndex = Resolved.srcQueueFamilyIndex,
+            .dstQueueFamilyIndex = Resolved.dstQueueFamilyIndex,
+            .buffer = Resolved.buffer,
+            .offset = Resolved.offset,
+            .size = Resolved.size,
+        };
+    }
+
+    for(size_t Index = 0; Index < Barrier->ImageBarriers.Count; ++Index)
+    {
+        Rr_ImageMemoryBarrier *ImageBarrier =
+            Barrier->ImageBarriers.Data + Index;
+        VkImageMemoryBarrier Resolved =
+            Rr_ResolveImageBarrier(Renderer, ImageBarrier, IsCompute);
+        ImageBarriers[Index] = (VkImageMemoryBarrier2KHR){
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,
+            .srcStageMask = ImageBarrier->SrcStageMask,
+            .srcAccessMask = Resolved.srcAccessMask,
+            .dstStageMask = ImageBarrier->DstStageMask,
+            .dstAccessMask = Resolved.dstAccessMask,
+            .oldLayout = Resolved.oldLayout,
+            .newLayout = Resolved.newLayout,
+            .srcQueueFamilyIndex = Resolved.srcQueueFamilyIndex,
+            .dstQueueFamilyIndex = Resolved.dstQueueFamilyIndex,
+            .image = Resolved.image,
+            .subresourceRange = Resolved.subresourceRange,
+        };
+    }
+
+    VkDependencyInfoKHR DependencyInfo = {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+        .pNext = NULL,
+        .dependencyFlags = 0,
+        .bufferMemoryBarrierCount = Barrier->BufferBarriers.Count,
+        .pBufferMemoryBarriers = BufferBarriers,
+        .imageMemoryBarrierCount = Barrier->ImageBarriers.Count,
+        .pImageMemoryBarriers = ImageBarriers,
+    };
+    Device->CmdPipelineBarrier2KHR(CommandBuffer, &DependencyInfo);
 
     Rr_DestroyScratch(Scratch);
 }
 
-void Rr_ExecuteGraph(Rr_Renderer *Renderer, Rr_Graph *Graph, Rr_Arena *Arena)
+static void Rr_ApplyBarrierBatch(
+    Rr_Renderer *Renderer,
+    Rr_BarrierBatch *Barrier,
+    VkCommandBuffer CommandBuffer,
+    bool IsCompute,
+    size_t ConflictCount,
+    Rr_Arena **Conflicts)
 {
-    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+    Rr_Device *Device = &Renderer->Device;
 
-    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+    size_t MaxPossibleBarriers =
+        Barrier->BufferBarriers.Count + Barrier->ImageBarriers.Count;
 
-    Rr_NodeSlice SortedNodes = { 0 };
-    RR_RESERVE_SLICE(&SortedNodes, Graph->Nodes.Count, Scratch.Arena);
+    if(MaxPossibleBarriers == 0)
+    {
+        return;
+    }
 
-    Rr_ProcessGraphNodes(Graph, &SortedNodes, Scratch.Arena);
+    if(Device->CmdPipelineBarrier2KHR != NULL)
+    {
+        Rr_RecordBarriers2(
+            Renderer,
+            Barrier,
+            CommandBuffer,
+            IsCompute,
+            ConflictCount,
+            Conflicts);
+    }
+    else
+    {
+        Rr_RecordBarriers(
+            Renderer,
+            Barrier,
+            CommandBuffer,
+            IsCompute,
+            ConflictCount,
+            Conflicts);
+    }
 
-    /* Resolve all referenced resources. */
+    /* Join states only once the whole level moved them, split barriers
+     * of this level are applied before this batch. */
 
-    for(size_t Index = 0; Index < Graph->Resources.Count; ++Index)
+    for(size_t Index = 0; Index < Barrier->ImageBarriers.Count; ++Index)
     {
-        Rr_GraphResource *Resource = Graph->Resources.Data + Index;
-        if(Resource->IsImage)
-        {
-            Resource->Allocated =
-                Rr_GetCurrentAllocatedImage(Renderer, Resource->Container);
-        }
-        else
-        {
-            Resource->Allocated =
-                Rr_GetCurrentAllocatedBuffer(Renderer, Resource->Container);
+        Rr_JoinSynchronizationState(
+            Renderer,
+            (Rr_MapKey)Barrier->ImageBarriers.Data[Index].Image);
+    }
+
+    Barrier->ImageBarriers.Count = 0;
+    Barrier->BufferBarriers.Count = 0;
+    Barrier->VulkanHandleToBarrier = NULL;
+}
+
+/* Second half of split barriers, the events were set right after
+ * the batches producing the resources. */
+
+static void Rr_ApplySplitBarrierBatch(
+    Rr_Renderer *Renderer,
+    Rr_QueueBarriers *Barriers,
+    VkCommandBuffer CommandBuffer,
+    size_t ConflictCount,
+    Rr_Arena **Conflicts)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    Rr_BarrierBatch *Barrier = &Barriers->SplitBatch;
+
+    if(Barriers->WaitEvents.Count == 0)
+    {
+        return;
+    }
+
+    Rr_Scratch Scratch = Rr_GetScratchAvoiding(ConflictCount, Conflicts);
+
+    VkPipelineStageFlags SrcStageMask = 0;
+    VkPipelineStageFlags DstStageMask = 0;
+    RR_SLICE(VkEvent) Events = { 0 };
+    RR_RESERVE_SLICE(&Events, Barriers->WaitEvents.Count, Scratch.Arena);
+    RR_SLICE(VkBufferMemoryBarrier) BufferBarriers = { 0 };
+    RR_RESERVE_SLICE(
+        &BufferBarriers,
+        Barrier->BufferBarriers.Count,
+        Scratch.Arena);
+    RR_SLICE(VkImageMemoryBarrier) ImageBarriers = { 0 };
+    RR_RESERVE_SLICE(
+        &ImageBarriers,
+        Barrier->ImageBarriers.Count,
+        Scratch.Arena);
+
+    for(size_t Index = 0; Index < Barriers->WaitEvents.Count; ++Index)
+    {
+        Rr_GraphEvent *Event = Barriers->WaitEvents.Data[Index];
+        SrcStageMask |= Event->StageMask;
+        Event->IsWaited = false;
+        *RR_PUSH_SLICE(&Events, NULL) = Event->Handle;
+    }
+
+    for(size_t Index = 0; Index < Barrier->BufferBarriers.Count; ++Index)
+    {
+        Rr_BufferMemoryBarrier *BufferBarrier =
+            Barrier->BufferBarriers.Data + Index;
+        DstStageMask |= BufferBarrier->DstStageMask;
+        *RR_PUSH_SLICE(&BufferBarriers, NULL) =
+            Rr_ResolveBufferBarrier(Renderer, BufferBarrier, false);
+    }
+
+    for(size_t Index = 0; Index < Barrier->ImageBarriers.Count; ++Index)
+    {
+        Rr_ImageMemoryBarrier *ImageBarrier =
+            Barrier->ImageBarriers.Data + Index;
+        DstStageMask |= ImageBarrier->DstStageMask;
+        *RR_PUSH_SLICE(&ImageBarriers, NULL) =
+            Rr_ResolveImageBarrier(Renderer, ImageBarrier, false);
+    }
+
+    Device->CmdWaitEvents(
+        CommandBuffer,
+        Events.Count,
+        Events.Data,
+        SrcStageMask,
+        DstStageMask,
+        0,
+        NULL,
+        BufferBarriers.Count,
+        BufferBarriers.Data,
+        ImageBarriers.Count,
+        ImageBarriers.Data);
+
+    Barrier->ImageBarriers.Count = 0;
+    Barrier->BufferBarriers.Count = 0;
+    Barrier->VulkanHandleToBarrier = NULL;
+    Barriers->WaitEvents.Count = 0;
+
+    Rr_DestroyScratch(Scratch);
+}
+
+static bool Rr_ApplyReleaseBarriers(
+    Rr_Renderer *Renderer,
+    Rr_BarrierBatch *Releases,
+    VkCommandBuffer CommandBuffer,
+    Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+
+    Rr_Device *Device = &Renderer->Device;
+
+    bool HasReleases =
+        Releases->BufferBarriers.Count > 0 || Releases->ImageBarriers.Count > 0;
+
+    /* Release half of a queue family ownership transfer.
+     * Destination stage and access are ignored, the acquire
+     * on the other queue makes the memory available there.
+     * Synchronization state is updated by the acquire. */
+
+    VkPipelineStageFlags SrcStageMask = 0;
+    RR_SLICE(VkBufferMemoryBarrier) BufferBarriers = { 0 };
+    RR_RESERVE_SLICE(
+        &BufferBarriers,
+        Releases->BufferBarriers.Count,
+        Scratch.Arena);
+    RR_SLICE(VkImageMemoryBarrier) ImageBarriers = { 0 };
+    RR_RESERVE_SLICE(
+        &ImageBarriers,
+        Releases->ImageBarriers.Count,
+        Scratch.Arena);
+
+    for(size_t Index = 0; Index < Releases->BufferBarriers.Count; ++Index)
+    {
+        Rr_BufferMemoryBarrier *BufferBarrier =
+            Releases->BufferBarriers.Data + Index;
+        SrcStageMask |= BufferBarrier->SrcStageMask;
+        *RR_PUSH_SLICE(&BufferBarriers, NULL) = (VkBufferMemoryBarrier){
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .buffer = BufferBarrier->Buffer,
+            .srcAccessMask = BufferBarrier->SrcAccessMask,
+            .dstAccessMask = 0,
+            .srcQueueFamilyIndex = BufferBarrier->SrcQueueFamilyIndex,
+            .dstQueueFamilyIndex = BufferBarrier->DstQueueFamilyIndex,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        };
+    }
+
+    for(size_t Index = 0; Index < Releases->ImageBarriers.Count; ++Index)
+    {
+        Rr_ImageMemoryBarrier *ImageBarrier =
+            Releases->ImageBarriers.Data + Index;
+        SrcStageMask |= ImageBarrier->SrcStageMask;
+        *RR_PUSH_SLICE(&ImageBarriers, NULL) = (VkImageMemoryBarrier){
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .image = ImageBarrier->Image,
+            .srcAccessMask = ImageBarrier->SrcAccessMask,
+            .dstAccessMask = 0,
+            .oldLayout = ImageBarrier->OldLayout,
+            .newLayout = ImageBarrier->NewLayout,
+            .srcQueueFamilyIndex = ImageBarrier->SrcQueueFamilyIndex,
+            .dstQueueFamilyIndex = ImageBarrier->DstQueueFamilyIndex,
+            .subresourceRange = ImageBarrier->SubresourceRange,
+        };
+    }
+
+    if(HasReleases)
+    {
+        Device->CmdPipelineBarrier(
+            CommandBuffer,
+            SrcStageMask,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0,
+            NULL,
+            BufferBarriers.Count,
+            BufferBarriers.Data,
+            ImageBarriers.Count,
+            ImageBarriers.Data);
+    }
+
+    Releases->ImageBarriers.Count = 0;
+    Releases->BufferBarriers.Count = 0;
+    Releases->VulkanHandleToBarrier = NULL;
+
+    Rr_DestroyScratch(Scratch);
+
+    return HasReleases;
+}
+
+/* Resources last accessed by a batch which set an event at least two
+ * levels earlier are waited on with the event so the batches in
+ * between aren't stalled by the barrier. */
+
+static Rr_BarrierBatch *Rr_GetBarrierBatch(
+    Rr_GraphNode *Node,
+    Rr_QueueBarriers *Barriers,
+    void *Handle,
+    Rr_SyncState *PrevState,
+    bool IsOwnershipTransfer,
+    Rr_Arena *Arena)
+{
+    if(Barriers->UsesEvents == false || IsOwnershipTransfer ||
+       PrevState->StageMask == 0)
+    {
+        return &Barriers->Batch;
+    }
+
+    Rr_GraphEvent *Event = RR_UPSERT_DEREF(&Barriers->Events, Handle, Arena);
+    if(Event == NULL ||
+       Event->DependencyLevel < Node->DependencyLevel + 2 ||
+       (PrevState->StageMask & ~Event->StageMask) != 0)
+    {
+        return &Barriers->Batch;
+    }
+
+    if(Event->IsWaited == false)
+    {
+        Event->IsWaited = true;
+        *RR_PUSH_SLICE(&Barriers->WaitEvents, Arena) = Event;
+    }
+
+    return &Barriers->SplitBatch;
+}
+
+static bool Rr_IsRedundantBarrier(
+    Rr_SyncState *State,
+    Rr_SyncState *PrevState,
+    bool IsOwnershipTransfer)
+{
+    /* If reading again, just make sure the memory is "available" to
+     * this memory domain AND the image is in the same layout. */
+
+    bool IsReadingNow = RR_HAS_BIT(State->AccessMask, RR_VULKAN_WRITES) == 0;
+    bool WasReadingBefore =
+        RR_HAS_BIT(PrevState->AccessMask, RR_VULKAN_WRITES) == 0;
+    bool IsSameLayout = State->Specific.Layout == PrevState->Specific.Layout;
+
+    return IsReadingNow && WasReadingBefore && IsSameLayout &&
+           IsOwnershipTransfer == false &&
+           (PrevState->AccessMask & State->AccessMask) == State->AccessMask;
+}
+
+static void Rr_AddImageBarrier(
+    Rr_GraphNode *Node,
+    Rr_QueueBarriers *Barriers,
+    Rr_AllocatedImage *AllocatedImage,
+    Rr_SyncState *State,
+    Rr_SyncState *PrevState,
+    Rr_MapKey BarrierKey,
+    uint32_t BaseMipLevel,
+    uint32_t LevelCount,
+    Rr_Arena *Arena)
+{
+    bool IsOwnershipTransfer = PrevState->ComputeOwned != Barriers->IsCompute;
+
+    if(Rr_IsRedundantBarrier(State, PrevState, IsOwnershipTransfer))
+    {
+        /* Skip this barrier! Remember the reader for the next write. */
+
+        PrevState->StageMask |= State->StageMask;
+        return;
+    }
+
+    Rr_BarrierBatch *BarrierBatch = Rr_GetBarrierBatch(
+        Node,
+        Barriers,
+        AllocatedImage->Handle,
+        PrevState,
+        IsOwnershipTransfer,
+        Arena);
+
+    Rr_ImageMemoryBarrier **ImageBarrierRef =
+        RR_UPSERT(&BarrierBatch->VulkanHandleToBarrier, BarrierKey, Arena);
+    Rr_ImageMemoryBarrier *ImageBarrier = *ImageBarrierRef;
+    if(ImageBarrier != NULL)
+    {
+        /* Several nodes of this level reading the same subresources. */
+
+        if(ImageBarrier->NewLayout != State->Specific.Layout)
+        {
+            RR_ABORT(
+                "Node \"%s\" needs a different layout for an image "
+                "used in the same batch!",
+                Node->Name);
+        }
+        ImageBarrier->DstStageMask |= State->StageMask;
+        ImageBarrier->DstAccessMask |= State->AccessMask;
+        return;
+    }
+
+    *ImageBarrierRef = RR_PUSH_SLICE(&BarrierBatch->ImageBarriers, Arena);
+    ImageBarrier = *ImageBarrierRef;
+    *ImageBarrier = (Rr_ImageMemoryBarrier){
+        .SrcStageMask = PrevState->StageMask != 0
+                            ? PrevState->StageMask
+                            : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        .DstStageMask = State->StageMask,
+        .Image = AllocatedImage->Handle,
+        .SrcAccessMask = PrevState->AccessMask,
+        .DstAccessMask = State->AccessMask,
+        .OldLayout = PrevState->Specific.Layout,
+        .NewLayout = State->Specific.Layout,
+        .SrcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .DstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .SubresourceRange =
+            (VkImageSubresourceRange){
+                .aspectMask = AllocatedImage->Container->AspectFlags,
+                .baseMipLevel = BaseMipLevel,
+                .levelCount = LevelCount,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            },
+    };
+
+    /* Matching release goes to the queue that owned
+     * the image, acquire waits on a semaphore instead
+     * of the source stage. */
+
+    if(IsOwnershipTransfer)
+    {
+        assert(Barriers->Releases != NULL);
+
+        ImageBarrier->SrcQueueFamilyIndex = Barriers->OtherFamilyIndex;
+        ImageBarrier->DstQueueFamilyIndex = Barriers->FamilyIndex;
+        *RR_PUSH_SLICE(
+            &Barriers->Releases->ImageBarriers,
+            Barriers->ReleaseArena) = *ImageBarrier;
+        ImageBarrier->SrcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        ImageBarrier->SrcAccessMask = 0;
+    }
+}
+
+static Rr_MapKey Rr_GetMipBarrierKey(VkImage Image, uint32_t MipLevel)
+{
+    uint64_t Words[] = { (uint64_t)Image, MipLevel };
+    return XXH3_64bits(Words, sizeof(Words));
+}
+
+static void Rr_AddNodeImageBarriers(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_GraphNode *Node,
+    Rr_NodeDependency *Dependency,
+    Rr_QueueBarriers *Barriers,
+    Rr_Arena *Arena)
+{
+    Rr_AllocatedImage *AllocatedImage =
+        Rr_GetGraphImage(Graph, Dependency->Handle);
+    VkImage Image = AllocatedImage->Handle;
+    uint32_t MipLevels = AllocatedImage->Container->MipLevels;
+    Rr_GraphResource *Resource =
+        Graph->Resources.Data + Dependency->Handle.Values.Index;
+    uint32_t BaseMipLevel = (uint32_t)RR_MIN(Resource->Range.Begin, MipLevels);
+    uint32_t EndMipLevel = (uint32_t)RR_MIN(Resource->Range.End, MipLevels);
+
+    Rr_SyncState *PrevState =
+        Rr_GetSynchronizationState(Renderer, (Rr_MapKey)Image);
+
+    /* Whole image barriers are kept while the image state is uniform,
+     * including partial accesses covered by a barrier of this batch. */
+
+    if(PrevState->SubresourceCount == 0)
+    {
+        bool IsWholeImage = BaseMipLevel == 0 && EndMipLevel == MipLevels;
+        Rr_Map **Batch = &Barriers->Batch.VulkanHandleToBarrier;
+        Rr_Map **SplitBatch = &Barriers->SplitBatch.VulkanHandleToBarrier;
+        bool HasWholeBarrier = RR_UPSERT(Batch, Image, NULL) != NULL ||
+                               RR_UPSERT(SplitBatch, Image, NULL) != NULL;
+        if(IsWholeImage || HasWholeBarrier)
+        {
+            Rr_AddImageBarrier(
+                Node,
+                Barriers,
+                AllocatedImage,
+                &Dependency->State,
+                PrevState,
+                (Rr_MapKey)Image,
+                0,
+                VK_REMAINING_MIP_LEVELS,
+                Arena);
+            return;
+        }
+
+        Rr_SplitSynchronizationState(Renderer, (Rr_MapKey)Image, MipLevels);
+    }
+
+    for(uint32_t MipLevel = BaseMipLevel; MipLevel < EndMipLevel; ++MipLevel)
+    {
+        Rr_AddImageBarrier(
+            Node,
+            Barriers,
+            AllocatedImage,
+            &Dependency->State,
+            Rr_GetSubresourceSynchronizationState(
+                Renderer,
+                (Rr_MapKey)Image,
+                MipLevel),
+            Rr_GetMipBarrierKey(Image, MipLevel),
+            MipLevel,
+            1,
+            Arena);
+    }
+}
+
+static void Rr_AddNodeBarriers(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_GraphNode *Node,
+    Rr_QueueBarriers *Barriers,
+    Rr_Arena *Arena)
+{
+    for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count; ++DepIndex)
+    {
+        Rr_NodeDependency *Dependency = Node->Dependencies.Data + DepIndex;
+        Rr_SyncState *State = &Dependency->State;
+
+        if(State->Specific.Layout != 0)
+        {
+            /* Image Synchronization */
+
+            Rr_AddNodeImageBarriers(
+                Renderer,
+                Graph,
+                Node,
+                Dependency,
+                Barriers,
+                Arena);
+        }
+        else
+        {
+            /* Buffer Synchronization */
+
+            Rr_AllocatedBuffer *AllocatedBuffer =
+                Rr_GetGraphBuffer(Graph, Dependency->Handle);
+            VkBuffer Buffer = AllocatedBuffer->Handle;
+
+            Rr_SyncState *PrevState =
+                Rr_GetSynchronizationState(Renderer, (Rr_MapKey)Buffer);
+
+            bool IsOwnershipTransfer =
+                PrevState->ComputeOwned != Barriers->IsCompute;
+
+            if(Rr_IsRedundantBarrier(State, PrevState, IsOwnershipTransfer))
+            {
+                /* Skip this barrier! Remember the reader for the next
+                 * write. */
+
+                PrevState->StageMask |= State->StageMask;
+                continue;
+            }
+
+            Rr_BarrierBatch *BarrierBatch = Rr_GetBarrierBatch(
+                Node,
+                Barriers,
+                Buffer,
+                PrevState,
+                IsOwnershipTransfer,
+                Arena);
+
+            Rr_BufferMemoryBarrier **BufferBarrierRef =
+                RR_UPSERT(&BarrierBatch->VulkanHandleToBarrier, Buffer, Arena);
+            Rr_BufferMemoryBarrier *BufferBarrier = *BufferBarrierRef;
+            if(BufferBarrier == NULL)
+            {
+                *BufferBarrierRef =
+                    RR_PUSH_SLICE(&BarrierBatch->BufferBarriers, Arena);
+                BufferBarrier = *BufferBarrierRef;
+                *BufferBarrier = (Rr_BufferMemoryBarrier){
+                    .SrcStageMask = PrevState->StageMask != 0
+                                        ? PrevState->StageMask
+                                        : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                    .DstStageMask = State->StageMask,
+                    .Buffer = Buffer,
+                    .SrcAccessMask = PrevState->AccessMask,
+                    .DstAccessMask = State->AccessMask,
+                    .SrcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .DstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .Offset = 0,
+                    .Size = VK_WHOLE_SIZE,
+                };
+
+                if(IsOwnershipTransfer)
+                {
+                    assert(Barriers->Releases != NULL);
+
+                    BufferBarrier->SrcQueueFamilyIndex =
+                        Barriers->OtherFamilyIndex;
+                    BufferBarrier->DstQueueFamilyIndex = Barriers->FamilyIndex;
+                    *RR_PUSH_SLICE(
+                        &Barriers->Releases->BufferBarriers,
+                        Barriers->ReleaseArena) = *BufferBarrier;
+                    BufferBarrier->SrcStageMask =
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                    BufferBarrier->SrcAccessMask = 0;
+                }
+            }
+            else if(BufferBarrier->SrcQueueFamilyIndex ==
+                    VK_QUEUE_FAMILY_IGNORED)
+            {
+                BufferBarrier->SrcStageMask |= PrevState->StageMask;
+                BufferBarrier->DstStageMask |= State->StageMask;
+                BufferBarrier->SrcAccessMask |= PrevState->AccessMask;
+                BufferBarrier->DstAccessMask |= State->AccessMask;
+            }
+            else
+            {
+                BufferBarrier->DstStageMask |= State->StageMask;
+                BufferBarrier->DstAccessMask |= State->AccessMask;
+            }
+        }
+    }
+}
+
+/* Pooled buffers share one VkBuffer per block, and so its ownership
+ * and synchronization state. Returns VK_NULL_HANDLE otherwise. */
+
+static VkBuffer Rr_GetSharedGraphBuffer(
+    Rr_Renderer *Renderer,
+    Rr_GraphResource *Resource)
+{
+    if(Resource->IsImage)
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    Rr_Buffer *Buffer = Resource->Container;
+    if(Buffer->Pool == NULL)
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    return Rr_GetCurrentAllocatedBuffer(Renderer, Buffer)->Handle;
+}
+
+static void Rr_AssignNodeQueues(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_NodeSlice *SortedNodes,
+    Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+
+    size_t AsyncNodeCount = 0;
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+        Node->UsesComputeQueue = Node->Type == RR_GRAPH_NODE_TYPE_COMPUTE &&
+                                 Node->Union.Compute.Async &&
+                                 Node->UsesLateCommandBuffer == false &&
+                                 Rr_IsUsingComputeQueue(Renderer);
+        AsyncNodeCount += Node->UsesComputeQueue;
+    }
+
+    if(AsyncNodeCount == 0)
+    {
+        Rr_DestroyScratch(Scratch);
+        return;
+    }
+
+    /* The compute queue runs ahead of the whole late command buffer
+     * so an async node can only touch resource versions that precede
+     * every graphics access in this frame. Demoting a node adds
+     * graphics accesses, so repeat until nothing changes. */
+
+    size_t ResourceCount = Graph->Resources.Count;
+    int64_t *MaxAsyncGeneration =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, int64_t, ResourceCount);
+    int64_t *MinGraphicsGeneration =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, int64_t, ResourceCount);
+
+    /* Generations of different ranges aren't comparable, so a resource
+     * with ranges is kept off the compute queue as a whole once
+     * graphics work touches any part of it. */
+
+    bool *IsGraphicsParent =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, bool, ResourceCount);
+
+    /* Same for pooled buffers, an ownership transfer would take the
+     * whole block away from graphics work using its other ranges. */
+
+    VkBuffer *SharedBuffers =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, VkBuffer, ResourceCount);
+    for(size_t Index = 0; Index < ResourceCount; ++Index)
+    {
+        SharedBuffers[Index] = Rr_GetSharedGraphBuffer(
+            Renderer,
+            Graph->Resources.Data + Index);
+    }
+    Rr_HashMap GraphicsBuffers = { 0 };
+
+    bool Changed = true;
+    while(Changed)
+    {
+        Changed = false;
+
+        for(size_t Index = 0; Index < ResourceCount; ++Index)
+        {
+            MaxAsyncGeneration[Index] = -1;
+            MinGraphicsGeneration[Index] = INT64_MAX;
+            IsGraphicsParent[Index] = false;
+        }
+        Rr_ClearHashMap(&GraphicsBuffers);
+
+        for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+        {
+            Rr_GraphNode *Node = SortedNodes->Data[Index];
+            for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+                ++DepIndex)
+            {
+                Rr_GraphHandle *Handle =
+                    &Node->Dependencies.Data[DepIndex].Handle;
+                size_t ResourceIndex = Handle->Values.Index;
+                int64_t Generation = Handle->Values.Generation;
+                if(Node->UsesComputeQueue)
+                {
+                    MaxAsyncGeneration[ResourceIndex] =
+                        RR_MAX(MaxAsyncGeneration[ResourceIndex], Generation);
+                }
+                else
+                {
+                    MinGraphicsGeneration[ResourceIndex] = RR_MIN(
+                        MinGraphicsGeneration[ResourceIndex],
+                        Generation);
+                    IsGraphicsParent[Graph->Resources.Data[ResourceIndex]
+                                         .ParentIndex] = true;
+                    if(SharedBuffers[ResourceIndex] != VK_NULL_HANDLE)
+                    {
+                        Rr_UpsertHashMap(
+                            &GraphicsBuffers,
+                            (Rr_MapKey)SharedBuffers[ResourceIndex],
+                            Scratch.Arena);
+                    }
+                }
+            }
+        }
+
+        for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+        {
+            Rr_GraphNode *Node = SortedNodes->Data[Index];
+            if(Node->UsesComputeQueue == false)
+            {
+                continue;
+            }
+
+            for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+                ++DepIndex)
+            {
+                size_t ResourceIndex =
+                    Node->Dependencies.Data[DepIndex].Handle.Values.Index;
+                size_t ParentIndex =
+                    Graph->Resources.Data[ResourceIndex].ParentIndex;
+                bool IsSharedParent =
+                    Graph->Resources.Data[ParentIndex].HasAliases &&
+                    IsGraphicsParent[ParentIndex];
+                bool IsSharedBuffer =
+                    SharedBuffers[ResourceIndex] != VK_NULL_HANDLE &&
+                    Rr_UpsertHashMap(
+                        &GraphicsBuffers,
+                        (Rr_MapKey)SharedBuffers[ResourceIndex],
+                        NULL) != NULL;
+                if(MinGraphicsGeneration[ResourceIndex] <=
+                       MaxAsyncGeneration[ResourceIndex] ||
+                   IsSharedParent || IsSharedBuffer)
+                {
+                    Node->UsesComputeQueue = false;
+                    Changed = true;
+                    break;
+                }
+            }
+
+            if(Changed)
+            {
+                break;
+            }
+        }
+    }
+
+    /* Early command buffer is submitted before the compute queue runs,
+     * so graphics accesses to async results and everything ordered
+     * after them move to the late command buffer. Generation at or
+     * past the earliest late access of a resource means a node is
+     * ordered after it. Resources with ranges are handled as a whole. */
+
+    int64_t *LateGeneration = MinGraphicsGeneration;
+    bool *IsLateParent = IsGraphicsParent;
+    for(size_t Index = 0; Index < ResourceCount; ++Index)
+    {
+        LateGeneration[Index] =
+            MaxAsyncGeneration[Index] >= 0 ? 0 : INT64_MAX;
+        IsLateParent[Index] = false;
+    }
+
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+        if(Node->UsesComputeQueue)
+        {
+            continue;
+        }
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count &&
+                                 Node->UsesLateCommandBuffer == false;
+            ++DepIndex)
+        {
+            Rr_GraphHandle *Handle = &Node->Dependencies.Data[DepIndex].Handle;
+            Node->UsesLateCommandBuffer =
+                Handle->Values.Generation >=
+                    LateGeneration[Handle->Values.Index] ||
+                IsLateParent[Graph->Resources.Data[Handle->Values.Index]
+                                 .ParentIndex];
+        }
+
+        if(Node->UsesLateCommandBuffer == false)
+        {
+            continue;
+        }
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
+        {
+            Rr_GraphHandle *Handle = &Node->Dependencies.Data[DepIndex].Handle;
+            LateGeneration[Handle->Values.Index] = RR_MIN(
+                LateGeneration[Handle->Values.Index],
+                (int64_t)Handle->Values.Generation);
+
+            size_t ParentIndex =
+                Graph->Resources.Data[Handle->Values.Index].ParentIndex;
+            IsLateParent[ParentIndex] =
+                Graph->Resources.Data[ParentIndex].HasAliases;
+        }
+    }
+
+    Rr_DestroyScratch(Scratch);
+}
+
+typedef struct Rr_TransientPlacement Rr_TransientPlacement;
+struct Rr_TransientPlacement
+{
+    size_t FirstStep;
+    size_t LastStep;
+    VkPipelineStageFlags StageMask;
+    VkAccessFlags AccessMask;
+    VkMemoryRequirements Requirements;
+    VkDeviceSize Offset;
+    bool IsPlaced;
+};
+
+static bool Rr_AreTransientsOverlapping(
+    Rr_TransientPlacement *A,
+    Rr_TransientPlacement *B)
+{
+    return A->Offset < B->Offset + B->Requirements.size &&
+           B->Offset < A->Offset + A->Requirements.size;
+}
+
+static void Rr_PlaceTransientImages(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_NodeSlice *SortedNodes,
+    Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+
+    size_t TransientCount = Graph->TransientImages.Count;
+    if(TransientCount == 0 || SortedNodes->Count == 0)
+    {
+        Rr_TrimTransientHeap(Renderer, &Frame->TransientHeap);
+        Rr_DestroyScratch(Scratch);
+        return;
+    }
+
+    size_t *ResourceToTransient =
+        RR_ALLOC_TYPE_COUNT(Scratch.Arena, size_t, Graph->Resources.Count);
+    for(size_t Index = 0; Index < Graph->Resources.Count; ++Index)
+    {
+        ResourceToTransient[Index] = SIZE_MAX;
+    }
+
+    Rr_TransientPlacement *Placements = RR_ALLOC_TYPE_COUNT(
+        Scratch.Arena,
+        Rr_TransientPlacement,
+        TransientCount);
+    for(size_t Index = 0; Index < TransientCount; ++Index)
+    {
+        Rr_GraphTransientImage *TransientImage =
+            Graph->TransientImages.Data + Index;
+        ResourceToTransient[TransientImage->ResourceIndex] = Index;
+        Placements[Index].FirstStep = SIZE_MAX;
+    }
+
+    /* Lifetimes are tracked in execution steps derived from dependency
+     * levels since nodes of the same level may be recorded in any order.
+     * Levels count down towards the sinks and Rr_ProcessGraphNodes sorts
+     * the nodes by descending level, so the highest level runs first.
+     * The late command buffer runs after the whole early one. Async
+     * compute overlaps both so its images live all frame. */
+
+    size_t MaxLevel = 0;
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        MaxLevel = RR_MAX(MaxLevel, SortedNodes->Data[Index]->DependencyLevel);
+    }
+
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+        size_t NodeFirstStep =
+            (Node->UsesLateCommandBuffer ? MaxLevel + 1 : 0) + MaxLevel -
+            Node->DependencyLevel;
+        size_t NodeLastStep = NodeFirstStep;
+        if(Node->UsesComputeQueue)
+        {
+            NodeFirstStep = 0;
+            NodeLastStep = MaxLevel * 2 + 1;
+        }
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
+        {
+            Rr_NodeDependency *Dependency = Node->Dependencies.Data + DepIndex;
+            size_t TransientIndex = ResourceToTransient
+                [Graph->Resources.Data[Dependency->Handle.Values.Index]
+                     .ParentIndex];
+            if(TransientIndex == SIZE_MAX)
+            {
+                continue;
+            }
+
+            Rr_TransientPlacement *Placement = Placements + TransientIndex;
+            Placement->FirstStep = RR_MIN(Placement->FirstStep, NodeFirstStep);
+            Placement->LastStep = RR_MAX(Placement->LastStep, NodeLastStep);
+            Placement->StageMask |= Dependency->State.StageMask;
+            Placement->AccessMask |= Dependency->State.AccessMask;
+        }
+    }
+
+    /* Greedy first fit, largest images first. Each image goes to the
+     * lowest offset not overlapping any placed image that is alive at
+     * the same time. Images that can't share the heap memory type get
+     * their own allocation. */
+
+    size_t *Order = RR_ALLOC_TYPE_COUNT(Scratch.Arena, size_t, TransientCount);
+    size_t OrderCount = 0;
+    for(size_t Index = 0; Index < TransientCount; ++Index)
+    {
+        Rr_GraphTransientImage *TransientImage =
+            Graph->TransientImages.Data + Index;
+        Rr_TransientPlacement *Placement = Placements + Index;
+        if(Placement->FirstStep == SIZE_MAX)
+        {
+            continue;
+        }
+
+        Placement->Requirements = Rr_GetTransientImageRequirements(
+            Renderer,
+            &TransientImage->CreateInfo,
+            TransientImage->Hash);
+
+        size_t Position = OrderCount++;
+        while(Position > 0 &&
+              Placements[Order[Position - 1]].Requirements.size <
+                  Placement->Requirements.size)
+        {
+            Order[Position] = Order[Position - 1];
+            Position--;
+        }
+        Order[Position] = Index;
+    }
+
+    VkMemoryRequirements HeapRequirements = {
+        .alignment = 1,
+        .memoryTypeBits = ~0U,
+    };
+    for(size_t OrderIndex = 0; OrderIndex < OrderCount; ++OrderIndex)
+    {
+        Rr_TransientPlacement *Placement = Placements + Order[OrderIndex];
+        VkMemoryRequirements *Requirements = &Placement->Requirements;
+
+        uint32_t MemoryTypeBits =
+            HeapRequirements.memoryTypeBits & Requirements->memoryTypeBits;
+        if(MemoryTypeBits == 0)
+        {
+            Placement->Offset = RR_TRANSIENT_DEDICATED_OFFSET;
+            continue;
+        }
+        HeapRequirements.memoryTypeBits = MemoryTypeBits;
+        HeapRequirements.alignment =
+            RR_MAX(HeapRequirements.alignment, Requirements->alignment);
+
+        Placement->Offset = 0;
+        bool IsMoved = true;
+        while(IsMoved)
+        {
+            IsMoved = false;
+            for(size_t PlacedIndex = 0; PlacedIndex < OrderIndex;
+                ++PlacedIndex)
+            {
+                Rr_TransientPlacement *Placed = Placements + Order[PlacedIndex];
+                bool IsAlive = Placed->IsPlaced &&
+                               Placed->FirstStep <= Placement->LastStep &&
+                               Placement->FirstStep <= Placed->LastStep;
+                if(IsAlive && Rr_AreTransientsOverlapping(Placement, Placed))
+                {
+                    VkDeviceSize End =
+                        Placed->Offset + Placed->Requirements.size;
+                    Placement->Offset = (End + Requirements->alignment - 1) /
+                                        Requirements->alignment *
+                                        Requirements->alignment;
+                    IsMoved = true;
+                }
+            }
+        }
+        Placement->IsPlaced = true;
+
+        HeapRequirements.size = RR_MAX(
+            HeapRequirements.size,
+            Placement->Offset + Requirements->size);
+    }
+
+    Rr_ReserveTransientHeap(Renderer, &Frame->TransientHeap, &HeapRequirements);
+
+    for(size_t Index = 0; Index < TransientCount; ++Index)
+    {
+        Rr_GraphTransientImage *TransientImage =
+            Graph->TransientImages.Data + Index;
+        Rr_TransientPlacement *Placement = Placements + Index;
+        if(Placement->FirstStep == SIZE_MAX)
+        {
+            continue;
+        }
+
+        Rr_BindTransientImage(
+            Renderer,
+            &Frame->TransientHeap,
+            TransientImage->Image,
+            &TransientImage->CreateInfo,
+            TransientImage->ViewType,
+            TransientImage->Hash,
+            Placement->Offset);
+
+        /* Contents are discarded every frame. Start from an undefined
+         * layout and wait for earlier images aliasing the same memory. */
+
+        Rr_SyncState InitialState = { 0 };
+        for(size_t OtherIndex = 0; OtherIndex < TransientCount; ++OtherIndex)
+        {
+            Rr_TransientPlacement *Other = Placements + OtherIndex;
+            if(Other->IsPlaced && Placement->IsPlaced &&
+               Other->LastStep < Placement->FirstStep &&
+               Rr_AreTransientsOverlapping(Placement, Other))
+            {
+                InitialState.StageMask |= Other->StageMask;
+                InitialState.AccessMask |= Other->AccessMask;
+            }
+        }
+        Rr_MapKey Key =
+            (Rr_MapKey)TransientImage->Image->AllocatedImages[0].Handle;
+        Rr_ReturnSynchronizationState(Renderer, Key);
+        *Rr_GetSynchronizationState(Renderer, Key) = InitialState;
+    }
+
+    Rr_TrimTransientHeap(Renderer, &Frame->TransientHeap);
+
+    Rr_DestroyScratch(Scratch);
+}
+
+static void *Rr_GetDependencyVulkanHandle(
+    Rr_Graph *Graph,
+    Rr_NodeDependency *Dependency)
+{
+    if(Dependency->State.Specific.Layout != 0)
+    {
+        return Rr_GetGraphImage(Graph, Dependency->Handle)->Handle;
+    }
+    return Rr_GetGraphBuffer(Graph, Dependency->Handle)->Handle;
+}
+
+/* Marks levels whose graphics batch is followed by another access to
+ * the same resource at least two levels later. Those batches set an
+ * event the later access can wait on. */
+
+static bool *Rr_FindEventLevels(
+    Rr_Graph *Graph,
+    bool IsLate,
+    size_t LevelCount,
+    Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+
+    bool *NeedsEvent = RR_ALLOC_TYPE_COUNT(Arena, bool, LevelCount);
+    Rr_Map *LastLevels = NULL;
+
+    for(size_t Index = 0; Index < Graph->SortedNodes.Count; ++Index)
+    {
+        Rr_GraphNode *Node = Graph->SortedNodes.Data[Index];
+        if(Node->UsesLateCommandBuffer != IsLate || Node->UsesComputeQueue)
+        {
+            continue;
+        }
+
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
+        {
+            size_t *LastLevel = RR_UPSERT(
+                &LastLevels,
+                Rr_GetDependencyVulkanHandle(
+                    Graph,
+                    Node->Dependencies.Data + DepIndex),
+                Scratch.Arena);
+
+            /* Stored off by one, zero means not accessed yet. */
+
+            if(*LastLevel >= Node->DependencyLevel + 3)
+            {
+                NeedsEvent[*LastLevel - 1] = true;
+            }
+            *LastLevel = Node->DependencyLevel + 1;
+        }
+    }
+
+    Rr_DestroyScratch(Scratch);
+
+    return NeedsEvent;
+}
+
+static void Rr_SetBatchEvent(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_NodeSlice *Batch,
+    bool NeedsEvent,
+    Rr_QueueBarriers *Barriers,
+    VkCommandBuffer CommandBuffer,
+    Rr_Arena *Arena)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    Rr_GraphEvent *Event = NULL;
+    if(NeedsEvent)
+    {
+        Event = RR_ALLOC_TYPE(Arena, Rr_GraphEvent);
+        Event->DependencyLevel = Batch->Data[0]->DependencyLevel;
+        for(size_t Index = 0; Index < Batch->Count; ++Index)
+        {
+            Rr_GraphNode *Node = Batch->Data[Index];
+            for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+                ++DepIndex)
+            {
+                Event->StageMask |=
+                    Node->Dependencies.Data[DepIndex].State.StageMask;
+            }
+        }
+        if(Event->StageMask != 0)
+        {
+            Event->Handle = Rr_GetFrameEvent(Renderer);
+            Device->CmdSetEvent(CommandBuffer, Event->Handle, Event->StageMask);
+        }
+        else
+        {
+            Event = NULL;
+        }
+    }
+
+    /* Resources accessed without an event set afterwards have to use
+     * a regular barrier again. */
+
+    for(size_t Index = 0; Index < Batch->Count; ++Index)
+    {
+        Rr_GraphNode *Node = Batch->Data[Index];
+        for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
+            ++DepIndex)
+        {
+            void *Handle = Rr_GetDependencyVulkanHandle(
+                Graph,
+                Node->Dependencies.Data + DepIndex);
+            RR_UPSERT_DEREF(&Barriers->Events, Handle, Arena) = Event;
+        }
+    }
+}
+
+static size_t Rr_ExecuteGraphNodes(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    bool IsLate,
+    VkCommandBuffer CommandBuffer,
+    Rr_BarrierBatch *ComputeAcquires,
+    Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
+
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+    Rr_NodeSlice *SortedNodes = &Graph->SortedNodes;
+
+    Rr_QueueBarriers GraphicsBarriers = {
+        .FamilyIndex = Renderer->GraphicsQueue.FamilyIndex,
+        .OtherFamilyIndex = Renderer->ComputeQueue.FamilyIndex,
+        .IsCompute = false,
+        .UsesEvents = Renderer->UsesSplitBarriers,
+    };
+    Rr_QueueBarriers ComputeBarriers = {
+        .Releases = ComputeAcquires,
+        .ReleaseArena = Arena,
+        .FamilyIndex = Renderer->ComputeQueue.FamilyIndex,
+        .OtherFamilyIndex = Renderer->GraphicsQueue.FamilyIndex,
+        .IsCompute = true,
+    };
+
+    Rr_NodeSlice GraphicsBatch = { 0 };
+    RR_RESERVE_SLICE(&GraphicsBatch, SortedNodes->Count, Scratch.Arena);
+    Rr_NodeSlice ComputeBatch = { 0 };
+    RR_RESERVE_SLICE(&ComputeBatch, SortedNodes->Count, Scratch.Arena);
+    size_t ComputeNodeCount = 0;
+
+    /* Batches, barriers and events grow in Scratch and releases grow in
+     * Arena while nodes are recorded, nested scratches avoid both. */
+
+    Rr_Arena *Conflicts[] = { Arena, Scratch.Arena };
+
+    bool *NeedsEvent = NULL;
+    if(GraphicsBarriers.UsesEvents)
+    {
+        size_t MaxLevel = 0;
+        for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+        {
+            MaxLevel =
+                RR_MAX(MaxLevel, SortedNodes->Data[Index]->DependencyLevel);
+        }
+        NeedsEvent =
+            Rr_FindEventLevels(Graph, IsLate, MaxLevel + 1, Scratch.Arena);
+    }
+
+    for(size_t Index = 0; Index < SortedNodes->Count; ++Index)
+    {
+        Rr_GraphNode *Node = SortedNodes->Data[Index];
+
+        /* Nodes of the other phase still close their level below.
+         * Async compute nodes never use the late command buffer. */
+
+        bool IsRecorded = Node->UsesLateCommandBuffer == IsLate;
+        if(IsRecorded && Node->UsesComputeQueue)
+        {
+            Rr_AddNodeBarriers(
+                Renderer,
+                Graph,
+                Node,
+                &ComputeBarriers,
+                Scratch.Arena);
+            *RR_PUSH_SLICE(&ComputeBatch, NULL) = Node;
+            ComputeNodeCount++;
+        }
+        else if(IsRecorded)
+        {
+            Rr_AddNodeBarriers(
+                Renderer,
+                Graph,
+                Node,
+                &GraphicsBarriers,
+                Scratch.Arena);
+            *RR_PUSH_SLICE(&GraphicsBatch, NULL) = Node;
+        }
+
+        bool LastNodeThisLevel =
+            Index + 1 == SortedNodes->Count ||
+            SortedNodes->Data[Index + 1]->DependencyLevel !=
+                Node->DependencyLevel;
+        if(LastNodeThisLevel == false)
+        {
+            continue;
+        }
+
+        /* Execute current batch now! */
+
+        if(ComputeBatch.Count > 0)
+        {
+            Rr_ApplyBarrierBatch(
+                Renderer,
+                &ComputeBarriers.Batch,
+                Frame->ComputeCommandBuffer,
+                true,
+                RR_ARRAY_COUNT(Conflicts),
+                Conflicts);
+
+            for(size_t NodeIndex = 0; NodeIndex < ComputeBatch.Count;
+                ++NodeIndex)
+            {
+                Rr_ExecuteGraphNode(
+                    Renderer,
+                    Graph,
+                    ComputeBatch.Data[NodeIndex],
+                    Frame->ComputeCommandBuffer);
+            }
+
+            RR_EMPTY_SLICE(&ComputeBatch);
+        }
+
+        if(GraphicsBatch.Count > 0)
+        {
+            Rr_ApplySplitBarrierBatch(
+                Renderer,
+                &GraphicsBarriers,
+                CommandBuffer,
+                RR_ARRAY_COUNT(Conflicts),
+                Conflicts);
+            Rr_ApplyBarrierBatch(
+                Renderer,
+                &GraphicsBarriers.Batch,
+                CommandBuffer,
+                false,
+                RR_ARRAY_COUNT(Conflicts),
+                Conflicts);
+
+            Rr_ExecuteGraphBatch(
+                Renderer,
+                Graph,
+                GraphicsBatch.Data,
+                GraphicsBatch.Count,
+                CommandBuffer,
+                RR_ARRAY_COUNT(Conflicts),
+                Conflicts);
+
+            if(GraphicsBarriers.UsesEvents)
+            {
+                Rr_SetBatchEvent(
+                    Renderer,
+                    Graph,
+                    &GraphicsBatch,
+                    NeedsEvent[Node->DependencyLevel],
+                    &GraphicsBarriers,
+                    CommandBuffer,
+                    Scratch.Arena);
+            }
+
+            RR_EMPTY_SLICE(&GraphicsBatch);
         }
     }
 
-    size_t DependencyLevel = SortedNodes.Data[0]->DependencyLevel;
+    Rr_DestroyScratch(Scratch);
+
+    return ComputeNodeCount;
+}
 
-    Rr_BarrierBatch BarrierBatch = { 0 };
+static void Rr_ReturnComputeResources(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    VkCommandBuffer CommandBuffer,
+    Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
 
-    size_t BatchStartIndex = 0;
-    size_t BatchSize = 0;
+    /* Hand everything the compute queue touched back to the graphics
+     * queue at the end of the compute command buffer. Matching acquires
+     * are recorded at the start of the late command buffer, so the
+     * graphics queue owns all resources between frames. */
 
-    // bool UseLateCommandBuffer = false;
+    Rr_BarrierBatch Releases = { 0 };
+    Rr_BarrierBatch *Acquires = &Graph->ComputeReturns;
+    Rr_Map *VisitedMap = NULL;
 
-    for(size_t Index = 0; Index < SortedNodes.Count; ++Index)
+    for(size_t Index = 0; Index < Graph->SortedNodes.Count; ++Index)
     {
-        Rr_GraphNode *Node = SortedNodes.Data[Index];
-        // UseLateCommandBuffer |= Node->UsesLateCommandBuffer;
-        DependencyLevel = Node->DependencyLevel;
+        Rr_GraphNode *Node = Graph->SortedNodes.Data[Index];
+        if(Node->UsesComputeQueue == false)
+        {
+            continue;
+        }
 
         for(size_t DepIndex = 0; DepIndex < Node->Dependencies.Count;
             ++DepIndex)
         {
             Rr_NodeDependency *Dependency = Node->Dependencies.Data + DepIndex;
-            Rr_SyncState *State = &Dependency->State;
 
-            if(State->Specific.Layout != 0)
+            if(Dependency->State.Specific.Layout != 0)
             {
-                /* Image Synchronization */
-
                 Rr_AllocatedImage *AllocatedImage =
                     Rr_GetGraphImage(Graph, Dependency->Handle);
                 VkImage Image = AllocatedImage->Handle;
 
-                Rr_SyncState *PrevState =
-                    Rr_GetSynchronizationState(Renderer, (Rr_MapKey)Image);
-
-                /* If reading again, just make sure the memory is "available" to
-                 * this memory domain AND the image is in the same layout. */
-
-                bool IsReadingNow =
-                    RR_HAS_BIT(State->AccessMask, RR_VULKAN_WRITES) == 0;
-                bool WasReadingBefore =
-                    RR_HAS_BIT(PrevState->AccessMask, RR_VULKAN_WRITES) == 0;
-                bool IsSameLayout =
-                    State->Specific.Layout == PrevState->Specific.Layout;
-                if(IsReadingNow && WasReadingBefore && IsSameLayout)
+                bool *Visited = RR_UPSERT(&VisitedMap, Image, Scratch.Arena);
+                if(*Visited)
                 {
-                    bool IncludesPreviousAccessMask =
-                        (PrevState->AccessMask & State->AccessMask) ==
-                        State->AccessMask;
-                    if(IncludesPreviousAccessMask)
-                    {
-                        /* Skip this barrier! */
-
-                        continue;
-                    }
+                    continue;
                 }
+                *Visited = true;
 
-                Rr_ImageMemoryBarrier **ImageBarrierRef = RR_UPSERT(
-                    &BarrierBatch.VulkanHandleToBarrier,
-                    Image,
-                    Scratch.Arena);
-                Rr_ImageMemoryBarrier *ImageBarrier = *ImageBarrierRef;
-                if(ImageBarrier == NULL)
+                /* Split states keep their layouts, one transfer
+                 * per mip level. */
+
+                Rr_SyncState *WholeState =
+                    Rr_GetSynchronizationState(Renderer, (Rr_MapKey)Image);
+                uint32_t LevelCount = RR_MAX(WholeState->SubresourceCount, 1);
+                for(uint32_t Level = 0; Level < LevelCount; ++Level)
                 {
-                    *ImageBarrierRef = RR_PUSH_SLICE(
-                        &BarrierBatch.ImageBarriers,
-                        Scratch.Arena);
-                    ImageBarrier = *ImageBarrierRef;
-                    *ImageBarrier = (Rr_ImageMemoryBarrier){
-                        .SrcStageMask = PrevState->StageMask != 0
-                                            ? PrevState->StageMask
-                                            : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                    bool IsSplit = WholeState->SubresourceCount > 0;
+                    Rr_SyncState *State =
+                        IsSplit ? Rr_GetSubresourceSynchronizationState(
+                                      Renderer,
+                                      (Rr_MapKey)Image,
+                                      Level)
+                                : WholeState;
+                    Rr_ImageMemoryBarrier Barrier = {
+                        .SrcStageMask = State->StageMask,
                         .DstStageMask = State->StageMask,
                         .Image = Image,
-                        .SrcAccessMask = PrevState->AccessMask,
+                        .SrcAccessMask = State->AccessMask,
                         .DstAccessMask = State->AccessMask,
-                        .OldLayout = PrevState->Specific.Layout,
+                        .OldLayout = State->Specific.Layout,
                         .NewLayout = State->Specific.Layout,
+                        .SrcQueueFamilyIndex =
+                            Renderer->ComputeQueue.FamilyIndex,
+                        .DstQueueFamilyIndex =
+                            Renderer->GraphicsQueue.FamilyIndex,
                         .SubresourceRange =
                             (VkImageSubresourceRange){
                                 .aspectMask =
                                     AllocatedImage->Container->AspectFlags,
-                                .baseMipLevel = 0,
-                                .levelCount = VK_REMAINING_MIP_LEVELS,
+                                .baseMipLevel = Level,
+                                .levelCount =
+                                    IsSplit ? 1 : VK_REMAINING_MIP_LEVELS,
                                 .baseArrayLayer = 0,
                                 .layerCount = VK_REMAINING_ARRAY_LAYERS,
                             },
                     };
-                }
-                else
-                {
-                    RR_ABORT("Multiple image layout transitions!");
+                    *RR_PUSH_SLICE(&Releases.ImageBarriers, Scratch.Arena) =
+                        Barrier;
+                    Barrier.SrcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                    Barrier.SrcAccessMask = 0;
+                    *RR_PUSH_SLICE(&Acquires->ImageBarriers, Graph->Arena) =
+                        Barrier;
                 }
             }
             else
             {
-                /* Buffer Synchronization */
+                VkBuffer Buffer =
+                    Rr_GetGraphBuffer(Graph, Dependency->Handle)->Handle;
 
-                Rr_AllocatedBuffer *AllocatedBuffer =
-                    Rr_GetGraphBuffer(Graph, Dependency->Handle);
-                VkBuffer Buffer = AllocatedBuffer->Handle;
+                bool *Visited = RR_UPSERT(&VisitedMap, Buffer, Scratch.Arena);
+                if(*Visited)
+                {
+                    continue;
+                }
+                *Visited = true;
 
-                Rr_SyncState *PrevState =
+                Rr_SyncState *State =
                     Rr_GetSynchronizationState(Renderer, (Rr_MapKey)Buffer);
+                Rr_BufferMemoryBarrier Barrier = {
+                    .SrcStageMask = State->StageMask,
+                    .DstStageMask = State->StageMask,
+                    .Buffer = Buffer,
+                    .SrcAccessMask = State->AccessMask,
+                    .DstAccessMask = State->AccessMask,
+                    .SrcQueueFamilyIndex = Renderer->ComputeQueue.FamilyIndex,
+                    .DstQueueFamilyIndex = Renderer->GraphicsQueue.FamilyIndex,
+                    .Offset = 0,
+                    .Size = VK_WHOLE_SIZE,
+                };
+                *RR_PUSH_SLICE(&Releases.BufferBarriers, Scratch.Arena) =
+                    Barrier;
+                Barrier.SrcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                Barrier.SrcAccessMask = 0;
+                *RR_PUSH_SLICE(&Acquires->BufferBarriers, Graph->Arena) =
+                    Barrier;
+            }
+        }
+    }
 
-                /* If reading again, just make sure the memory is "available" to
-                 * this memory domain. */
+    Rr_ApplyReleaseBarriers(Renderer, &Releases, CommandBuffer, Scratch.Arena);
 
-                bool IsReadingNow =
-                    RR_HAS_BIT(State->AccessMask, RR_VULKAN_WRITES) == 0;
-                bool WasReadingBefore =
-                    RR_HAS_BIT(PrevState->AccessMask, RR_VULKAN_WRITES) == 0;
-                if(IsReadingNow && WasReadingBefore)
-                {
-                    bool IncludesPreviousAccessMask =
-                        (PrevState->AccessMask & State->AccessMask) ==
-                        State->AccessMask;
-                    if(IncludesPreviousAccessMask)
-                    {
-                        /* Skip this barrier! */
+    Rr_DestroyScratch(Scratch);
+}
 
-                        continue;
-                    }
-                }
+void Rr_ExecuteEarlyGraph(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_Arena *Arena)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(Arena);
 
-                Rr_BufferMemoryBarrier **BufferBarrierRef = RR_UPSERT(
-                    &BarrierBatch.VulkanHandleToBarrier,
-                    Buffer,
-                    Scratch.Arena);
-                Rr_BufferMemoryBarrier *BufferBarrier = *BufferBarrierRef;
-                if(BufferBarrier == NULL)
-                {
-                    *BufferBarrierRef = RR_PUSH_SLICE(
-                        &BarrierBatch.BufferBarriers,
-                        Scratch.Arena);
-                    BufferBarrier = *BufferBarrierRef;
-                    *BufferBarrier = (Rr_BufferMemoryBarrier){
-                        .SrcStageMask = PrevState->StageMask != 0
-                                            ? PrevState->StageMask
-                                            : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                        .DstStageMask = State->StageMask,
-                        .Buffer = Buffer,
-                        .SrcAccessMask = PrevState->AccessMask,
-                        .DstAccessMask = State->AccessMask,
-                        .Offset = 0,
-                        .Size = VK_WHOLE_SIZE,
-                    };
-                }
-                else
-                {
-                    BufferBarrier->SrcStageMask |= PrevState->StageMask;
-                    BufferBarrier->DstStageMask |= State->StageMask;
-                    BufferBarrier->SrcAccessMask |= PrevState->AccessMask;
-                    BufferBarrier->DstAccessMask |= State->AccessMask;
-                }
-            }
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+
+    Rr_NodeSlice *SortedNodes = &Graph->SortedNodes;
+    RR_RESERVE_SLICE(SortedNodes, Graph->Nodes.Count, Graph->Arena);
+
+    /* Reuse sort order and dependency levels when the topology
+     * matches a recently compiled graph. Barriers are still resolved
+     * below since they depend on the global synchronization state
+     * and on per-frame allocations. */
+
+    uint64_t Fingerprint = Rr_GetGraphFingerprint(Graph, Scratch.Arena);
+    if(Rr_LoadCompiledGraph(
+           &Renderer->GraphCache,
+           Graph,
+           Fingerprint,
+           SortedNodes) == false)
+    {
+        Rr_ProcessGraphNodes(Graph, SortedNodes, Scratch.Arena);
+        if(SortedNodes->Count > 0)
+        {
+            Rr_StoreCompiledGraph(
+                &Renderer->GraphCache,
+                Graph,
+                Fingerprint,
+                SortedNodes);
         }
+    }
+
+    /* Move async compute nodes to the compute queue where possible. */
+
+    Rr_AssignNodeQueues(Renderer, Graph, SortedNodes, Scratch.Arena);
+
+    /* Alias transient images with disjoint lifetimes. */
+
+    Rr_PlaceTransientImages(Renderer, Graph, SortedNodes, Scratch.Arena);
 
-        BatchSize++;
+    /* Resolve all referenced resources. Swapchain image is
+     * resolved again once acquired. */
 
-        bool LastNode = false;
-        bool LastNodeThisLevel = false;
-        if(Index + 1 < SortedNodes.Count)
+    for(size_t Index = 0; Index < Graph->Resources.Count; ++Index)
+    {
+        Rr_GraphResource *Resource = Graph->Resources.Data + Index;
+        if(Resource->IsImage)
         {
-            LastNodeThisLevel =
-                SortedNodes.Data[Index + 1]->DependencyLevel != DependencyLevel;
+            Resource->Allocated =
+                Rr_GetCurrentAllocatedImage(Renderer, Resource->Container);
         }
         else
         {
-            LastNode = true;
+            Resource->Allocated =
+                Rr_GetCurrentAllocatedBuffer(Renderer, Resource->Container);
         }
-        if(LastNode || LastNodeThisLevel)
-        {
-            /* Execute current batch now! */
-
-            // VkCommandBuffer CommandBuffer = UseLateCommandBuffer
-            //                                     ? Frame->LateCommandBuffer
-            //                                     : Frame->EarlyCommandBuffer;
+    }
 
-            VkCommandBuffer CommandBuffer = Frame->LateCommandBuffer;
+    /* Record everything that doesn't depend on the swapchain image. */
 
-            Rr_ApplyBarrierBatch(
-                Renderer,
-                &BarrierBatch,
-                CommandBuffer,
-                Scratch.Arena);
+    Rr_BarrierBatch ComputeAcquires = { 0 };
+    size_t ComputeNodeCount = Rr_ExecuteGraphNodes(
+        Renderer,
+        Graph,
+        false,
+        Frame->EarlyCommandBuffer,
+        &ComputeAcquires,
+        Scratch.Arena);
 
-            for(size_t NodeIndex = BatchStartIndex;
-                NodeIndex < BatchStartIndex + BatchSize;
-                ++NodeIndex)
-            {
-                Rr_GraphNode *Node = SortedNodes.Data[NodeIndex];
-                Rr_ExecuteGraphNode(Renderer, Graph, Node, CommandBuffer);
-            }
+    /* Graphics releases go last into the early command buffer
+     * which the compute submission waits on. */
 
-            BatchStartIndex = Index + 1;
-            BatchSize = 0;
-            // UseLateCommandBuffer = 0;
-        }
+    Frame->ComputeSubmitPending = ComputeNodeCount > 0;
+    if(Frame->ComputeSubmitPending)
+    {
+        Rr_ApplyReleaseBarriers(
+            Renderer,
+            &ComputeAcquires,
+            Frame->EarlyCommandBuffer,
+            Scratch.Arena);
+        Rr_ReturnComputeResources(
+            Renderer,
+            Graph,
+            Frame->ComputeCommandBuffer,
+            Scratch.Arena);
     }
 
     Rr_DestroyScratch(Scratch);
 }
 
+void Rr_AcquireComputeResources(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    VkCommandBuffer CommandBuffer,
+    Rr_Arena *Arena)
+{
+    Rr_ApplyBarrierBatch(
+        Renderer,
+        &Graph->ComputeReturns,
+        CommandBuffer,
+        false,
+        1,
+        &Arena);
+}
+
+void Rr_ExecuteLateGraph(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_Arena *Arena)
+{
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+
+    Rr_GraphResource *SwapchainResource =
+        Graph->Resources.Data + Graph->SwapchainImageResourceIndex;
+    SwapchainResource->Allocated =
+        Rr_GetCurrentAllocatedImage(Renderer, SwapchainResource->Container);
+
+    Rr_AcquireComputeResources(
+        Renderer,
+        Graph,
+        Frame->LateCommandBuffer,
+        Arena);
+
+    Rr_ExecuteGraphNodes(
+        Renderer,
+        Graph,
+        true,
+        Frame->LateCommandBuffer,
+        NULL,
+        Arena);
+}
+
 static inline Rr_GraphImage *Rr_GetGraphHandle(
     Rr_Graph *Graph,
     void *Container,
@@ -1415,6 +3735,52 @@ static inline Rr_GraphImage *Rr_GetGraphHandle(
         };
         *RR_PUSH_SLICE(&Graph->Resources, Graph->Arena) = (Rr_GraphResource){
             .Container = Container,
+            .Range = { 0, UINT64_MAX },
+            .ParentIndex = Handle.Values.Index,
+            .IsImage = IsImage,
+        };
+        *GraphHandle = RR_ALLOC_TYPE(Graph->Arena, Rr_GraphHandle);
+        **GraphHandle = Handle;
+    }
+
+    return *GraphHandle;
+}
+
+static Rr_GraphHandle *Rr_GetGraphRangeHandle(
+    Rr_Graph *Graph,
+    void *Container,
+    bool IsImage,
+    Rr_GraphRange Range)
+{
+    Rr_GraphHandle *ParentHandle =
+        Rr_GetGraphHandle(Graph, Container, IsImage);
+
+    uint64_t Limit = IsImage ? ((Rr_Image *)Container)->MipLevels
+                             : ((Rr_Buffer *)Container)->Size;
+    Range.End = RR_MIN(Range.End, Limit);
+    if(Range.Begin == 0 && Range.End == Limit)
+    {
+        return ParentHandle;
+    }
+    assert(Range.Begin < Range.End);
+
+    uint64_t Words[] = { (Rr_MapKey)Container, Range.Begin, Range.End };
+    Rr_GraphHandle **GraphHandle = RR_UPSERT(
+        &Graph->RangeHandles,
+        XXH3_64bits(Words, sizeof(Words)),
+        Graph->Arena);
+    if(*GraphHandle == NULL)
+    {
+        uint32_t ParentIndex = ParentHandle->Values.Index;
+        Graph->Resources.Data[ParentIndex].HasAliases = true;
+
+        Rr_GraphImage Handle = {
+            .Values.Index = Graph->Resources.Count,
+        };
+        *RR_PUSH_SLICE(&Graph->Resources, Graph->Arena) = (Rr_GraphResource){
+            .Container = Container,
+            .Range = Range,
+            .ParentIndex = ParentIndex,
             .IsImage = IsImage,
         };
         *GraphHandle = RR_ALLOC_TYPE(Graph->Arena, Rr_GraphHandle);
@@ -1434,6 +3800,70 @@ Rr_GraphImage *Rr_GetGraphImageHandle(Rr_Graph *Graph, Rr_Image *Image)
     return Rr_GetGraphHandle(Graph, Image, true);
 }
 
+Rr_Image *Rr_CreateGraphImage(
+    Rr_Renderer *Renderer,
+    Rr_IntVec3 Extent,
+    Rr_TextureFormat Format,
+    Rr_ImageFlags Flags)
+{
+    assert(RR_HAS_BIT(Flags, RR_IMAGE_FLAGS_PER_FRAME_BIT) == false);
+    assert(RR_HAS_BIT(Flags, RR_IMAGE_FLAGS_READBACK_BIT) == false);
+
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+    Rr_Graph *Graph = Frame->Graph;
+
+    Rr_Image *Image = RR_ALLOC_TYPE(Frame->Arena, Rr_Image);
+
+    Rr_GraphTransientImage *TransientImage =
+        RR_PUSH_SLICE(&Graph->TransientImages, Frame->Arena);
+    Rr_InitImage(
+        Image,
+        Extent,
+        Format,
+        Flags,
+        &TransientImage->CreateInfo,
+        &TransientImage->ViewType);
+    TransientImage->Image = Image;
+    TransientImage->ResourceIndex =
+        Rr_GetGraphImageHandle(Graph, Image)->Values.Index;
+
+    VkImageCreateInfo *CreateInfo = &TransientImage->CreateInfo;
+    uint64_t Words[] = {
+        CreateInfo->imageType,
+        CreateInfo->format,
+        CreateInfo->extent.width,
+        CreateInfo->extent.height,
+        CreateInfo->extent.depth,
+        CreateInfo->mipLevels,
+        CreateInfo->usage,
+        TransientImage->ViewType,
+    };
+    TransientImage->Hash = XXH3_64bits(Words, sizeof(Words));
+
+    return Image;
+}
+
+static void Rr_ExportGraphResource(
+    Rr_Renderer *Renderer,
+    void *Container,
+    bool IsImage)
+{
+    Rr_Graph *Graph = Rr_GetCurrentFrame(Renderer)->Graph;
+
+    Rr_GraphHandle *Handle = Rr_GetGraphHandle(Graph, Container, IsImage);
+    Graph->Resources.Data[Handle->Values.Index].IsExported = true;
+}
+
+void Rr_ExportImage(Rr_Renderer *Renderer, Rr_Image *Image)
+{
+    Rr_ExportGraphResource(Renderer, Image, true);
+}
+
+void Rr_ExportBuffer(Rr_Renderer *Renderer, Rr_Buffer *Buffer)
+{
+    Rr_ExportGraphResource(Renderer, Buffer, false);
+}
+
 Rr_GraphNode *Rr_AddTransferNode(Rr_Renderer *Renderer, const char *Name)
 {
     Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
@@ -1457,10 +3887,16 @@ void Rr_TransferBufferData(
 {
     Rr_TransferNode *TransferNode = &Node->Union.Transfer;
 
-    Rr_GraphBuffer *SrcBufferHandle =
-        Rr_GetGraphBufferHandle(Node->Graph, SrcBuffer);
-    Rr_GraphBuffer *DstBufferHandle =
-        Rr_GetGraphBufferHandle(Node->Graph, DstBuffer);
+    Rr_GraphBuffer *SrcBufferHandle = Rr_GetGraphRangeHandle(
+        Node->Graph,
+        SrcBuffer,
+        false,
+        (Rr_GraphRange){ SrcOffset, SrcOffset + Size });
+    Rr_GraphBuffer *DstBufferHandle = Rr_GetGraphRangeHandle(
+        Node->Graph,
+        DstBuffer,
+        false,
+        (Rr_GraphRange){ DstOffset, DstOffset + Size });
 
     *RR_PUSH_SLICE(&TransferNode->Transfers, Node->Graph->Arena) =
         (Rr_Transfer){
@@ -1488,11 +3924,13 @@ void Rr_TransferBufferData(
         });
 }
 
-Rr_GraphNode *Rr_AddBlitNode(
+static Rr_GraphNode *Rr_AddGraphBlitNode(
     Rr_Renderer *Renderer,
     const char *Name,
-    Rr_Image *SrcImage,
-    Rr_Image *DstImage,
+    Rr_GraphImage *SrcImageHandle,
+    uint32_t SrcMipLevel,
+    Rr_GraphImage *DstImageHandle,
+    uint32_t DstMipLevel,
     Rr_IntVec4 SrcRect,
     Rr_IntVec4 DstRect,
     Rr_ImageAspect ImageAspect)
@@ -1502,17 +3940,14 @@ Rr_GraphNode *Rr_AddBlitNode(
     Rr_GraphNode *GraphNode =
         Rr_AddGraphNode(Frame, RR_GRAPH_NODE_TYPE_BLIT, Name);
 
-    Rr_GraphImage *SrcImageHandle =
-        Rr_GetGraphImageHandle(Frame->Graph, SrcImage);
-    Rr_GraphImage *DstImageHandle =
-        Rr_GetGraphImageHandle(Frame->Graph, DstImage);
-
     Rr_BlitNode *BlitNode = &GraphNode->Union.Blit;
     *BlitNode = (Rr_BlitNode){
         .SrcImageHandle = *SrcImageHandle,
         .DstImageHandle = *DstImageHandle,
         .SrcRect = SrcRect,
         .DstRect = DstRect,
+        .SrcMipLevel = SrcMipLevel,
+        .DstMipLevel = DstMipLevel,
     };
 
     BlitNode->AspectMask = Rr_GetVulkanImageAspect(ImageAspect);
@@ -1538,6 +3973,65 @@ Rr_GraphNode *Rr_AddBlitNode(
     return GraphNode;
 }
 
+Rr_GraphNode *Rr_AddBlitNode(
+    Rr_Renderer *Renderer,
+    const char *Name,
+    Rr_Image *SrcImage,
+    Rr_Image *DstImage,
+    Rr_IntVec4 SrcRect,
+    Rr_IntVec4 DstRect,
+    Rr_ImageAspect ImageAspect)
+{
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+
+    return Rr_AddGraphBlitNode(
+        Renderer,
+        Name,
+        Rr_GetGraphImageHandle(Frame->Graph, SrcImage),
+        0,
+        Rr_GetGraphImageHandle(Frame->Graph, DstImage),
+        0,
+        SrcRect,
+        DstRect,
+        ImageAspect);
+}
+
+Rr_GraphNode *Rr_AddMipBlitNode(
+    Rr_Renderer *Renderer,
+    const char *Name,
+    Rr_Image *SrcImage,
+    uint32_t SrcMipLevel,
+    Rr_Image *DstImage,
+    uint32_t DstMipLevel,
+    Rr_IntVec4 SrcRect,
+    Rr_IntVec4 DstRect,
+    Rr_ImageAspect ImageAspect)
+{
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+
+    assert(SrcMipLevel < SrcImage->MipLevels);
+    assert(DstMipLevel < DstImage->MipLevels);
+
+    return Rr_AddGraphBlitNode(
+        Renderer,
+        Name,
+        Rr_GetGraphRangeHandle(
+            Frame->Graph,
+            SrcImage,
+            true,
+            (Rr_GraphRange){ SrcMipLevel, SrcMipLevel + 1 }),
+        SrcMipLevel,
+        Rr_GetGraphRangeHandle(
+            Frame->Graph,
+            DstImage,
+            true,
+            (Rr_GraphRange){ DstMipLevel, DstMipLevel + 1 }),
+        DstMipLevel,
+        SrcRect,
+        DstRect,
+        ImageAspect);
+}
+
 Rr_GraphNode *Rr_AddComputeNode(Rr_Renderer *Renderer, const char *Name)
 {
     Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
@@ -1547,13 +4041,17 @@ Rr_GraphNode *Rr_AddComputeNode(Rr_Renderer *Renderer, const char *Name)
 
     Rr_ComputeNode *ComputeNode = &GraphNode->Union.Compute;
 
-    ComputeNode->Encoded.Encoded =
-        RR_ALLOC(Frame->Arena, sizeof(Rr_NodeFunction));
-    ComputeNode->Encoded.EncodedFirst = ComputeNode->Encoded.Encoded;
 
     return GraphNode;
 }
 
+void Rr_SetComputeNodeAsync(Rr_GraphNode *Node, bool Async)
+{
+    assert(Node->Type == RR_GRAPH_NODE_TYPE_COMPUTE);
+
+    Node->Union.Compute.Async = Async;
+}
+
 Rr_GraphNode *Rr_AddGraphicsNode(
     Rr_Renderer *Renderer,
     const char *Name,
@@ -1632,21 +4130,39 @@ Rr_GraphNode *Rr_AddGraphicsNode(
             });
     }
 
-    GraphicsNode->Encoded.Encoded =
-        RR_ALLOC(Frame->Arena, sizeof(Rr_NodeFunction));
-    GraphicsNode->Encoded.EncodedFirst = GraphicsNode->Encoded.Encoded;
 
     return GraphNode;
 }
 
-#define RR_NODE_ENCODE(FunctionType, ArgsType)                         \
-    Rr_Arena *Arena = Node->Graph->Arena;                              \
-    Rr_Encoded *Encoded = (Rr_Encoded *)&Node->Union;                  \
-    Encoded->Encoded->Next = RR_ALLOC(Arena, sizeof(Rr_NodeFunction)); \
-    Encoded->Encoded = Encoded->Encoded->Next;                         \
-    Encoded->Encoded->Type = FunctionType;                             \
-    Encoded->Encoded->Args = RR_ALLOC(Arena, sizeof(ArgsType));        \
-    *(ArgsType *)Encoded->Encoded->Args
+static void *Rr_EncodeNodeFunction(
+    Rr_GraphNode *Node,
+    Rr_NodeFunctionType Type,
+    size_t ArgsSize)
+{
+    Rr_Encoded *Encoded = (Rr_Encoded *)&Node->Union;
+
+    size_t Size = RR_NODE_FUNCTION_HEADER_SIZE +
+                  RR_ALIGN_POW2(ArgsSize, RR_SAFE_ALIGNMENT);
+    size_t Offset = Encoded->Stream.Count;
+    if(Offset + Size > Encoded->Stream.Capacity)
+    {
+        RR_RESERVE_SLICE(
+            &Encoded->Stream,
+            RR_MAX(Offset + Size, Encoded->Stream.Capacity * 2),
+            Node->Graph->Arena);
+    }
+    Encoded->Stream.Count += Size;
+
+    Rr_NodeFunction *Function =
+        (Rr_NodeFunction *)(Encoded->Stream.Data + Offset);
+    Function->Type = Type;
+    Function->Size = (uint32_t)Size;
+
+    return Rr_GetNodeFunctionArgs(Function);
+}
+
+#define RR_NODE_ENCODE(FunctionType, ArgsType) \
+    *(ArgsType *)Rr_EncodeNodeFunction(Node, FunctionType, sizeof(ArgsType))
 
 void Rr_BindComputePipeline(
     Rr_GraphNode *Node,
@@ -1931,7 +4447,11 @@ void Rr_BindUniformBuffer(
     assert(Binding < RR_MAX_BINDINGS);
     assert(Size > 0);
 
-    Rr_GraphBuffer *BufferHandle = Rr_GetGraphBufferHandle(Node->Graph, Buffer);
+    Rr_GraphBuffer *BufferHandle = Rr_GetGraphRangeHandle(
+        Node->Graph,
+        Buffer,
+        false,
+        (Rr_GraphRange){ Offset, (uint64_t)Offset + Size });
 
     RR_NODE_ENCODE(
         RR_NODE_FUNCTION_TYPE_BIND_UNIFORM_BUFFER,
@@ -1982,7 +4502,11 @@ void Rr_BindStorageBuffer(
     assert(Binding < RR_MAX_BINDINGS);
     assert(Size > 0);
 
-    Rr_GraphBuffer *BufferHandle = Rr_GetGraphBufferHandle(Node->Graph, Buffer);
+    Rr_GraphBuffer *BufferHandle = Rr_GetGraphRangeHandle(
+        Node->Graph,
+        Buffer,
+        false,
+        (Rr_GraphRange){ Offset, (uint64_t)Offset + Size });
 
     RR_NODE_ENCODE(
         RR_NODE_FUNCTION_TYPE_BIND_STORAGE_BUFFER,
@@ -2068,3 +4592,85 @@ void Rr_BindStorageImage(
             });
     }
 }
+
+void Rr_PushConstants(
+    Rr_GraphNode *Node,
+    uint32_t Offset,
+    uint32_t Size,
+    const void *Data)
+{
+    assert(Node->Type == RR_GRAPH_NODE_TYPE_COMPUTE ||
+           Node->Type == RR_GRAPH_NODE_TYPE_GRAPHICS);
+    assert(Offset + Size <= RR_MAX_PUSH_CONSTANTS_SIZE);
+    assert(Size > 0 && Data != NULL);
+
+    Rr_PushConstantsArgs *Args = Rr_EncodeNodeFunction(
+        Node,
+        RR_NODE_FUNCTION_TYPE_PUSH_CONSTANTS,
+        sizeof(Rr_PushConstantsArgs) + Size);
+    Args->Offset = Offset;
+    Args->Size = Size;
+    memcpy(Args + 1, Data, Size);
+}
+
+static VkPipelineStageFlags Rr_GetNodeShaderStages(Rr_GraphNode *Node)
+{
+    if(Node->Type == RR_GRAPH_NODE_TYPE_COMPUTE)
+    {
+        return VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    }
+    return VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+           VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+}
+
+void Rr_UseSampledImage(Rr_GraphNode *Node, Rr_Image *Image)
+{
+    assert(Image != NULL);
+
+    Rr_AddNodeDependency(
+        Node,
+        Rr_GetGraphImageHandle(Node->Graph, Image),
+        &(Rr_SyncState){
+            .AccessMask = VK_ACCESS_SHADER_READ_BIT,
+            .StageMask = Rr_GetNodeShaderStages(Node),
+            .Specific.Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        });
+}
+
+void Rr_UseStorageImage(Rr_GraphNode *Node, Rr_Image *Image)
+{
+    assert(Image != NULL);
+
+    Rr_AddNodeDependency(
+        Node,
+        Rr_GetGraphImageHandle(Node->Graph, Image),
+        &(Rr_SyncState){
+            .AccessMask =
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            .StageMask = Rr_GetNodeShaderStages(Node),
+            .Specific.Layout = VK_IMAGE_LAYOUT_GENERAL,
+        });
+}
+
+void Rr_UseStorageBuffer(
+    Rr_GraphNode *Node,
+    Rr_Buffer *Buffer,
+    uint32_t Offset,
+    uint32_t Size)
+{
+    assert(Buffer != NULL);
+    assert(Size > 0);
+
+    Rr_AddNodeDependency(
+        Node,
+        Rr_GetGraphRangeHandle(
+            Node->Graph,
+            Buffer,
+            false,
+            (Rr_GraphRange){ Offset, (uint64_t)Offset + Size }),
+        &(Rr_SyncState){
+            .AccessMask =
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            .StageMask = Rr_GetNodeShaderStages(Node),
+        });
+}
@@ -2,8 +2,13 @@
 
 #include <Rr/Rr_Graph.h>
 
+#include "Rr_Descriptor.h"
 #include "Rr_Vulkan.h"
 
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+
 struct Rr_Frame;
 
 typedef RR_SLICE(size_t) Rr_IndexSlice;
@@ -28,27 +33,45 @@ typedef enum
     RR_NODE_FUNCTION_TYPE_BIND_UNIFORM_BUFFER,
     RR_NODE_FUNCTION_TYPE_BIND_STORAGE_BUFFER,
     RR_NODE_FUNCTION_TYPE_BIND_STORAGE_IMAGE,
+    RR_NODE_FUNCTION_TYPE_PUSH_CONSTANTS,
 } Rr_NodeFunctionType;
 
+/* Node functions are packed back to back into a single stream per node.
+ * Each one is a header followed by its arguments inline, both padded to
+ * RR_SAFE_ALIGNMENT so arguments can be read in place. */
+
 typedef struct Rr_NodeFunction Rr_NodeFunction;
 struct Rr_NodeFunction
 {
     Rr_NodeFunctionType Type;
-    void *Args;
-    Rr_NodeFunction *Next;
+    uint32_t Size;
 };
 
+#define RR_NODE_FUNCTION_HEADER_SIZE \
+    RR_ALIGN_POW2(sizeof(Rr_NodeFunction), RR_SAFE_ALIGNMENT)
+
 typedef struct Rr_Encoded Rr_Encoded;
 struct Rr_Encoded
 {
-    Rr_NodeFunction *EncodedFirst;
-    Rr_NodeFunction *Encoded;
+    RR_SLICE(char) Stream;
 };
 
+static inline void *Rr_GetNodeFunctionArgs(Rr_NodeFunction *Function)
+{
+    return (char *)Function + RR_NODE_FUNCTION_HEADER_SIZE;
+}
+
+static inline Rr_NodeFunction *Rr_GetNextNodeFunction(
+    Rr_NodeFunction *Function)
+{
+    return (Rr_NodeFunction *)((char *)Function + Function->Size);
+}
+
 typedef struct Rr_ComputeNode Rr_ComputeNode;
 struct Rr_ComputeNode
 {
     Rr_Encoded Encoded;
+    bool Async;
 };
 
 typedef struct Rr_GraphicsNode Rr_GraphicsNode;
@@ -171,6 +194,15 @@ struct Rr_BindStorageImageArgs
     uint32_t Binding;
 };
 
+/* Followed by Size bytes of constants. */
+
+typedef struct Rr_PushConstantsArgs Rr_PushConstantsArgs;
+struct Rr_PushConstantsArgs
+{
+    uint32_t Offset;
+    uint32_t Size;
+};
+
 typedef struct Rr_Transfer Rr_Transfer;
 struct Rr_Transfer
 {
@@ -194,6 +226,8 @@ struct Rr_BlitNode
     Rr_GraphImage DstImageHandle;
     Rr_IntVec4 SrcRect;
     Rr_IntVec4 DstRect;
+    uint32_t SrcMipLevel;
+    uint32_t DstMipLevel;
     Rr_BlitMode Mode;
     VkImageAspectFlags AspectMask;
 };
@@ -221,28 +255,169 @@ struct Rr_GraphNode
     RR_SLICE(Rr_NodeDependency) Dependencies;
     Rr_Graph *Graph;
     bool UsesLateCommandBuffer;
+    bool UsesComputeQueue;
+};
+
+/* Event set after a batch whose results are consumed at least two
+ * dependency levels later. Consumers wait on it instead of issuing
+ * a pipeline barrier right before their batch. */
+
+typedef struct Rr_GraphEvent Rr_GraphEvent;
+struct Rr_GraphEvent
+{
+    VkEvent Handle;
+    VkPipelineStageFlags StageMask;
+    size_t DependencyLevel;
+    bool IsWaited;
+};
+
+typedef struct Rr_QueueBarriers Rr_QueueBarriers;
+struct Rr_QueueBarriers
+{
+    Rr_BarrierBatch Batch;
+
+    /* Releases are applied after recording finishes, so they grow in
+     * an arena that outlives the recording scratch. */
+
+    Rr_BarrierBatch *Releases;
+    Rr_Arena *ReleaseArena;
+    uint32_t FamilyIndex;
+    uint32_t OtherFamilyIndex;
+    bool IsCompute;
+
+    /* Split barriers, maps Vulkan handles to the event set after
+     * the last batch that accessed them. */
+
+    bool UsesEvents;
+    Rr_Map *Events;
+    Rr_BarrierBatch SplitBatch;
+    RR_SLICE(Rr_GraphEvent *) WaitEvents;
 };
 
+/* Mip levels of an image or bytes of a buffer. */
+
+typedef struct Rr_GraphRange Rr_GraphRange;
+struct Rr_GraphRange
+{
+    uint64_t Begin;
+    uint64_t End;
+};
+
+/* Each accessed range of a resource is versioned as a separate
+ * resource aliasing its parent (the whole resource) so accesses to
+ * disjoint ranges don't serialize. */
+
 typedef struct Rr_GraphResource Rr_GraphResource;
 struct Rr_GraphResource
 {
     Rr_GraphHandle Handle;
     void *Container;
     void *Allocated;
+    Rr_GraphRange Range;
+    uint32_t ParentIndex;
     uint32_t Generation;
     bool IsImage;
+    bool IsExported;
+    bool HasAliases;
+};
+
+typedef struct Rr_GraphTransientImage Rr_GraphTransientImage;
+struct Rr_GraphTransientImage
+{
+    Rr_Image *Image;
+    VkImageCreateInfo CreateInfo;
+    VkImageViewType ViewType;
+    uint64_t Hash;
+    uint32_t ResourceIndex;
 };
 
 struct Rr_Graph
 {
     RR_SLICE(Rr_GraphNode *) Nodes;
     RR_SLICE(Rr_GraphResource) Resources;
+    RR_SLICE(Rr_GraphTransientImage) TransientImages;
     Rr_Map *Handles;
+    Rr_Map *RangeHandles;
     Rr_Map *ResourceWriteToNode;
     uint32_t SwapchainImageResourceIndex;
+    Rr_NodeSlice SortedNodes;
+    Rr_BarrierBatch ComputeReturns;
     Rr_Arena *Arena;
 };
 
+/* Compiled graph cache keeps sort order and dependency levels of
+ * recently executed graph topologies. */
+
+#define RR_GRAPH_CACHE_SIZE 4
+
+typedef struct Rr_CompiledGraph Rr_CompiledGraph;
+struct Rr_CompiledGraph
+{
+    uint64_t Fingerprint;
+    size_t GraphNodeCount;
+    size_t NodeCount;
+    size_t *SortedIndices;
+    size_t *DependencyLevels;
+    bool *UsesLateCommandBuffer;
+    Rr_Arena *Arena;
+};
+
+typedef struct Rr_GraphCache Rr_GraphCache;
+struct Rr_GraphCache
+{
+    Rr_CompiledGraph Entries[RR_GRAPH_CACHE_SIZE];
+    size_t NextEntryIndex;
+};
+
+extern void Rr_CleanupGraphCache(Rr_GraphCache *Cache);
+
+/* Worker threads record graphics and compute nodes of a batch
+ * into secondary command buffers. */
+
+typedef struct Rr_RecordingJob Rr_RecordingJob;
+struct Rr_RecordingJob
+{
+    Rr_GraphNode *Node;
+    Rr_IntVec4 Viewport;
+    VkRenderPassBeginInfo RenderPassBeginInfo;
+    VkCommandBufferInheritanceInfo InheritanceInfo;
+    VkCommandBuffer CommandBuffer;
+};
+
+typedef struct Rr_RecordingContext Rr_RecordingContext;
+struct Rr_RecordingContext
+{
+    VkCommandPool CommandPool;
+    RR_SLICE(VkCommandBuffer) CommandBuffers;
+    size_t CommandBufferIndex;
+    Rr_DescriptorAllocator DescriptorAllocator;
+};
+
+typedef struct Rr_RecordingThread Rr_RecordingThread;
+struct Rr_RecordingThread
+{
+    Rr_RecordingContext Contexts[RR_FRAME_OVERLAP];
+    SDL_Thread *Handle;
+    SDL_Semaphore *Semaphore;
+    Rr_Renderer *Renderer;
+    Rr_Arena *Arena;
+};
+
+typedef struct Rr_RecordingThreads Rr_RecordingThreads;
+struct Rr_RecordingThreads
+{
+    Rr_RecordingThread *Threads;
+    size_t Count;
+    SDL_Semaphore *DoneSemaphore;
+    Rr_Graph *Graph;
+    Rr_RecordingJob *Jobs;
+    size_t JobCount;
+    SDL_AtomicInt NextJobIndex;
+    bool ExitRequested;
+};
+
+extern int SDLCALL Rr_RecordingThreadProc(void *UserData);
+
 extern Rr_GraphBuffer *Rr_GetGraphBufferHandle(
     Rr_Graph *Graph,
     Rr_Buffer *Buffer);
@@ -254,7 +429,18 @@ extern Rr_GraphNode *Rr_AddGraphNode(
     Rr_GraphNodeType Type,
     const char *Name);
 
-extern void Rr_ExecuteGraph(
+extern void Rr_ExecuteEarlyGraph(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    Rr_Arena *Arena);
+
+extern void Rr_AcquireComputeResources(
+    Rr_Renderer *Renderer,
+    Rr_Graph *Graph,
+    VkCommandBuffer CommandBuffer,
+    Rr_Arena *Arena);
+
+extern void Rr_ExecuteLateGraph(
     Rr_Renderer *Renderer,
     Rr_Graph *Graph,
     Rr_Arena *Arena);
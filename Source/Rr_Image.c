@@ -1,6 +1,7 @@
 #include "Rr_Image.h"
 
 #include "Rr_Buffer.h"
+#include "Rr_Log.h"
 #include "Rr_Renderer.h"
 #include "Rr_UploadContext.h"
 
@@ -17,7 +18,7 @@ Rr_Sampler *Rr_CreateSampler(Rr_Renderer *Renderer, Rr_SamplerInfo *Info)
     Rr_Device *Device = &Renderer->Device;
 
     Rr_Sampler *Sampler =
-        RR_GET_FREE_LIST_ITEM(&Renderer->Samplers, Renderer->Arena);
+        RR_ALLOC_POOL_ITEM(&Renderer->Samplers, Renderer->Arena);
 
     VkSamplerCreateInfo SamplerInfo = {
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
@@ -41,6 +42,21 @@ Rr_Sampler *Rr_CreateSampler(Rr_Renderer *Renderer, Rr_SamplerInfo *Info)
 
     Device->CreateSampler(Device->Handle, &SamplerInfo, NULL, &Sampler->Handle);
 
+    if(Renderer->UsesBindless)
+    {
+        Sampler->BindlessIndex = Rr_AllocateBindlessIndex(
+            &Renderer->Bindless,
+            RR_BINDLESS_BINDING_SAMPLER);
+        if(Sampler->BindlessIndex != RR_BINDLESS_INVALID_INDEX)
+        {
+            Rr_WriteBindlessSampler(
+                &Renderer->Bindless,
+                Device,
+                Sampler->BindlessIndex,
+                Sampler->Handle);
+        }
+    }
+
     return Sampler;
 }
 
@@ -50,9 +66,23 @@ void Rr_DestroySampler(Rr_Renderer *Renderer, Rr_Sampler *Sampler)
 
     Rr_Device *Device = &Renderer->Device;
 
+    if(Renderer->UsesBindless)
+    {
+        Rr_ReleaseBindlessIndex(
+            &Renderer->Bindless,
+            RR_BINDLESS_BINDING_SAMPLER,
+            Sampler->BindlessIndex,
+            Renderer->FrameNumber);
+    }
+
     Device->DestroySampler(Device->Handle, Sampler->Handle, NULL);
 
-    RR_RETURN_FREE_LIST_ITEM(&Renderer->Samplers, Sampler);
+    RR_FREE_POOL_ITEM(&Renderer->Samplers, Sampler);
+}
+
+uint32_t Rr_GetSamplerBindlessIndex(Rr_Sampler *Sampler)
+{
+    return Sampler->BindlessIndex;
 }
 
 void Rr_UploadStagingImage(
@@ -111,7 +141,7 @@ void Rr_UploadStagingImage(
             });
 
         VkBufferImageCopy BufferImageCopy = {
-            .bufferOffset = 0,
+            .bufferOffset = AllocatedStagingBuffer->Offset + StagingOffset,
             .bufferRowLength = 0,
             .bufferImageHeight = 0,
             .imageSubresource = {
@@ -202,6 +232,10 @@ void Rr_UploadImage(
         Renderer,
         Data.Size,
         RR_BUFFER_FLAGS_STAGING_BIT | RR_BUFFER_FLAGS_MAPPED_BIT);
+    if(StagingBuffer == NULL)
+    {
+        RR_ABORT("Failed to allocate staging buffer!");
+    }
     *RR_PUSH_SLICE(&UploadContext->StagingBuffers, UploadContext->Arena) =
         StagingBuffer;
 
@@ -224,19 +258,18 @@ void Rr_UploadImage(
         0);
 }
 
-Rr_Image *Rr_CreateImage(
-    Rr_Renderer *Renderer,
+void Rr_InitImage(
+    Rr_Image *Image,
     Rr_IntVec3 Extent,
     Rr_TextureFormat Format,
-    Rr_ImageFlags Flags)
+    Rr_ImageFlags Flags,
+    VkImageCreateInfo *OutCreateInfo,
+    VkImageViewType *OutViewType)
 {
     assert(Extent.Width >= 1);
     assert(Extent.Height >= 1);
     assert(Extent.Depth >= 1);
 
-    Rr_Device *Device = &Renderer->Device;
-
-    Rr_Image *Image = RR_GET_FREE_LIST_ITEM(&Renderer->Images, Renderer->Arena);
     Image->Flags = Flags;
     Image->Format = Rr_GetVulkanTextureFormat(Format);
     Image->Extent.width = Extent.Width;
@@ -262,6 +295,7 @@ Rr_Image *Rr_CreateImage(
         MipLevels =
             (uint32_t)floorf(logf(RR_MAX(Extent.Width, Extent.Height))) + 1;
     }
+    Image->MipLevels = MipLevels;
 
     Image->AllocatedImageCount = 1;
     if(RR_HAS_BIT(Flags, RR_IMAGE_FLAGS_PER_FRAME_BIT) ||
@@ -297,7 +331,7 @@ Rr_Image *Rr_CreateImage(
 
     /* @TODO: Some kind of real usage must be enforced aside from TRANSFER_*. */
 
-    VkImageCreateInfo ImageCreateInfo = {
+    *OutCreateInfo = (VkImageCreateInfo){
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .pNext = NULL,
         .imageType = ImageType,
@@ -310,6 +344,7 @@ Rr_Image *Rr_CreateImage(
         .usage = UsageFlags,
         .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
     };
+    *OutViewType = ImageViewType;
 
     Image->AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
     if(Image->Format == VK_FORMAT_D16_UNORM_S8_UINT ||
@@ -326,50 +361,212 @@ Rr_Image *Rr_CreateImage(
     {
         Image->AspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
     }
+}
+
+static void Rr_CreateImageView(
+    Rr_Renderer *Renderer,
+    Rr_AllocatedImage *AllocatedImage,
+    VkImageViewType ViewType,
+    uint32_t MipLevels)
+{
+    Rr_Device *Device = &Renderer->Device;
+    Rr_Image *Image = AllocatedImage->Container;
+
+    VkImageViewCreateInfo ImageViewCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .pNext = NULL,
+        .image = AllocatedImage->Handle,
+        .viewType = ViewType,
+        .format = Image->Format,
+        .subresourceRange = {
+            .aspectMask = Image->AspectFlags,
+            .baseMipLevel = 0,
+            .layerCount = MipLevels,
+            .baseArrayLayer = 0,
+            .levelCount = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+
+    Device->CreateImageView(
+        Device->Handle,
+        &ImageViewCreateInfo,
+        NULL,
+        &AllocatedImage->View);
+}
+
+static uint32_t Rr_AddBindlessImage(
+    Rr_Renderer *Renderer,
+    Rr_BindlessBinding Binding,
+    VkImageView View,
+    VkImageLayout Layout)
+{
+    uint32_t Index = Rr_AllocateBindlessIndex(&Renderer->Bindless, Binding);
+    if(Index != RR_BINDLESS_INVALID_INDEX)
+    {
+        Rr_WriteBindlessImage(
+            &Renderer->Bindless,
+            &Renderer->Device,
+            Binding,
+            Index,
+            View,
+            Layout);
+    }
+    return Index;
+}
+
+static void Rr_TrackImageMemory(
+    Rr_Renderer *Renderer,
+    Rr_GPUMemoryCategory Category,
+    VmaAllocation Allocation,
+    bool Allocated)
+{
+    VmaAllocationInfo AllocationInfo;
+    vmaGetAllocationInfo(Renderer->Allocator, Allocation, &AllocationInfo);
+    Rr_TrackGPUMemory(Renderer, Category, AllocationInfo.size, Allocated);
+}
+
+static Rr_Image *Rr_AllocateImage(
+    Rr_Renderer *Renderer,
+    Rr_IntVec3 Extent,
+    Rr_TextureFormat Format,
+    Rr_ImageFlags Flags,
+    bool WithinBudget)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    Rr_Image *Image = RR_ALLOC_POOL_ITEM(&Renderer->Images, Renderer->Arena);
+
+    VkImageCreateInfo ImageCreateInfo;
+    VkImageViewType ImageViewType;
+    Rr_InitImage(
+        Image,
+        Extent,
+        Format,
+        Flags,
+        &ImageCreateInfo,
+        &ImageViewType);
 
     VmaAllocationCreateInfo AllocationCreateInfo = {
         .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
         .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
     };
+    if(WithinBudget)
+    {
+        AllocationCreateInfo.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+    }
 
     for(size_t Index = 0; Index < Image->AllocatedImageCount; ++Index)
     {
         Rr_AllocatedImage *AllocatedImage = Image->AllocatedImages + Index;
         AllocatedImage->Container = Image;
 
-        vmaCreateImage(
-            Renderer->Allocator,
+        Device->CreateImage(
+            Device->Handle,
             &ImageCreateInfo,
+            NULL,
+            &AllocatedImage->Handle);
+
+        VmaAllocationInfo AllocationInfo;
+        VkResult Result = vmaAllocateMemoryForImage(
+            Renderer->Allocator,
+            AllocatedImage->Handle,
             &AllocationCreateInfo,
-            &AllocatedImage->Handle,
             &AllocatedImage->Allocation,
-            NULL);
-
-        VkImageViewCreateInfo ImageViewCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-            .pNext = NULL,
-            .image = AllocatedImage->Handle,
-            .viewType = ImageViewType,
-            .format = Image->Format,
-            .subresourceRange = {
-                .aspectMask = Image->AspectFlags,
-                .baseMipLevel = 0,
-                .layerCount = MipLevels,
-                .baseArrayLayer = 0,
-                .levelCount = VK_REMAINING_ARRAY_LAYERS,
-            },
-        };
-
-        Device->CreateImageView(
-            Device->Handle,
-            &ImageViewCreateInfo,
-            NULL,
-            &AllocatedImage->View);
+            &AllocationInfo);
+        if(Result == VK_ERROR_OUT_OF_DEVICE_MEMORY && WithinBudget)
+        {
+            VkMemoryRequirements Requirements;
+            Device->GetImageMemoryRequirements(
+                Device->Handle,
+                AllocatedImage->Handle,
+                &Requirements);
+            if(Rr_RelieveGPUMemoryPressure(Renderer, Requirements.size))
+            {
+                Result = vmaAllocateMemoryForImage(
+                    Renderer->Allocator,
+                    AllocatedImage->Handle,
+                    &AllocationCreateInfo,
+                    &AllocatedImage->Allocation,
+                    &AllocationInfo);
+            }
+        }
+        if(Result != VK_SUCCESS)
+        {
+            RR_LOG(
+                "Failed to allocate %ux%u image.",
+                ImageCreateInfo.extent.width,
+                ImageCreateInfo.extent.height);
+            Device->DestroyImage(Device->Handle, AllocatedImage->Handle, NULL);
+            Image->AllocatedImageCount = Index;
+            Rr_DestroyImage(Renderer, Image);
+            return NULL;
+        }
+        vmaBindImageMemory(
+            Renderer->Allocator,
+            AllocatedImage->Allocation,
+            AllocatedImage->Handle);
+
+        Rr_TrackGPUMemory(
+            Renderer,
+            Index > 0 ? RR_GPU_MEMORY_CATEGORY_PER_FRAME_COPIES
+                      : RR_GPU_MEMORY_CATEGORY_IMAGE,
+            AllocationInfo.size,
+            true);
+
+        Rr_CreateImageView(
+            Renderer,
+            AllocatedImage,
+            ImageViewType,
+            ImageCreateInfo.mipLevels);
+
+        if(Renderer->UsesBindless == false)
+        {
+            continue;
+        }
+        if(RR_HAS_BIT(Flags, RR_IMAGE_FLAGS_SAMPLED_BIT))
+        {
+            AllocatedImage->SampledIndex = Rr_AddBindlessImage(
+                Renderer,
+                RR_BINDLESS_BINDING_SAMPLED_IMAGE,
+                AllocatedImage->View,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+        if(RR_HAS_BIT(Flags, RR_IMAGE_FLAGS_STORAGE_BIT))
+        {
+            AllocatedImage->StorageIndex = Rr_AddBindlessImage(
+                Renderer,
+                RR_BINDLESS_BINDING_STORAGE_IMAGE,
+                AllocatedImage->View,
+                VK_IMAGE_LAYOUT_GENERAL);
+        }
     }
 
     return Image;
 }
 
+Rr_Image *Rr_CreateImage(
+    Rr_Renderer *Renderer,
+    Rr_IntVec3 Extent,
+    Rr_TextureFormat Format,
+    Rr_ImageFlags Flags)
+{
+    return Rr_AllocateImage(
+        Renderer,
+        Extent,
+        Format,
+        Flags,
+        Renderer->EnforcesMemoryBudget);
+}
+
+Rr_Image *Rr_CreateUnbudgetedImage(
+    Rr_Renderer *Renderer,
+    Rr_IntVec3 Extent,
+    Rr_TextureFormat Format,
+    Rr_ImageFlags Flags)
+{
+    return Rr_AllocateImage(Renderer, Extent, Format, Flags, false);
+}
+
 void Rr_DestroyImage(Rr_Renderer *Renderer, Rr_Image *Image)
 {
     if(Image == NULL)
@@ -381,17 +578,46 @@ void Rr_DestroyImage(Rr_Renderer *Renderer, Rr_Image *Image)
 
     for(size_t Index = 0; Index < Image->AllocatedImageCount; ++Index)
     {
+        if(Renderer->UsesBindless)
+        {
+            Rr_ReleaseBindlessIndex(
+                &Renderer->Bindless,
+                RR_BINDLESS_BINDING_SAMPLED_IMAGE,
+                Image->AllocatedImages[Index].SampledIndex,
+                Renderer->FrameNumber);
+            Rr_ReleaseBindlessIndex(
+                &Renderer->Bindless,
+                RR_BINDLESS_BINDING_STORAGE_IMAGE,
+                Image->AllocatedImages[Index].StorageIndex,
+                Renderer->FrameNumber);
+        }
         Device->DestroyImageView(
             Device->Handle,
             Image->AllocatedImages[Index].View,
             NULL);
+        Rr_TrackImageMemory(
+            Renderer,
+            Index > 0 ? RR_GPU_MEMORY_CATEGORY_PER_FRAME_COPIES
+                      : RR_GPU_MEMORY_CATEGORY_IMAGE,
+            Image->AllocatedImages[Index].Allocation,
+            false);
         vmaDestroyImage(
             Renderer->Allocator,
             Image->AllocatedImages[Index].Handle,
             Image->AllocatedImages[Index].Allocation);
     }
 
-    RR_RETURN_FREE_LIST_ITEM(&Renderer->Images, Image);
+    RR_FREE_POOL_ITEM(&Renderer->Images, Image);
+}
+
+uint32_t Rr_GetImageBindlessIndex(Rr_Renderer *Renderer, Rr_Image *Image)
+{
+    return Rr_GetCurrentAllocatedImage(Renderer, Image)->SampledIndex;
+}
+
+uint32_t Rr_GetStorageImageBindlessIndex(Rr_Renderer *Renderer, Rr_Image *Image)
+{
+    return Rr_GetCurrentAllocatedImage(Renderer, Image)->StorageIndex;
 }
 
 Rr_IntVec3 Rr_GetImageExtent3D(Rr_Image *Image)
@@ -448,6 +674,10 @@ Rr_Image *Rr_CreateImageRGBA8(
         Extent,
         RR_TEXTURE_FORMAT_R8G8B8A8_UNORM,
         RR_IMAGE_FLAGS_SAMPLED_BIT | RR_IMAGE_FLAGS_TRANSFER_BIT);
+    if(ColorImage == NULL)
+    {
+        return NULL;
+    }
 
     Rr_UploadImage(
         Renderer,
@@ -490,6 +720,11 @@ Rr_Image *Rr_CreateImageRGBA8FromPNG(
         Extent,
         RR_TEXTURE_FORMAT_R8G8B8A8_UNORM,
         RR_IMAGE_FLAGS_SAMPLED_BIT | RR_IMAGE_FLAGS_TRANSFER_BIT);
+    if(ColorImage == NULL)
+    {
+        stbi_image_free(ParsedData);
+        return NULL;
+    }
 
     Rr_UploadImage(
         Renderer,
@@ -618,3 +853,253 @@ Rr_AllocatedImage *Rr_GetCurrentAllocatedImage(
         Renderer->CurrentFrameIndex % Image->AllocatedImageCount;
     return &Image->AllocatedImages[AllocatedImageIndex];
 }
+
+VkMemoryRequirements Rr_GetTransientImageRequirements(
+    Rr_Renderer *Renderer,
+    VkImageCreateInfo *CreateInfo,
+    uint64_t Hash)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    /* Query requirements once per image description with a throwaway
+     * image, the actual images are only created after placement. */
+
+    VkMemoryRequirements **Requirements = RR_UPSERT(
+        &Renderer->TransientImageRequirements,
+        Hash,
+        Renderer->Arena);
+    if(*Requirements == NULL)
+    {
+        VkImage Image;
+        Device->CreateImage(Device->Handle, CreateInfo, NULL, &Image);
+        *Requirements = RR_ALLOC_TYPE(Renderer->Arena, VkMemoryRequirements);
+        Device->GetImageMemoryRequirements(
+            Device->Handle,
+            Image,
+            *Requirements);
+        Device->DestroyImage(Device->Handle, Image, NULL);
+    }
+
+    return **Requirements;
+}
+
+static void Rr_DestroyTransientImage(
+    Rr_Renderer *Renderer,
+    Rr_TransientImage *TransientImage)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    Rr_DestroyFramebuffersWithView(Renderer, TransientImage->View);
+    Rr_ReturnSynchronizationState(Renderer, (Rr_MapKey)TransientImage->Handle);
+    Device->DestroyImageView(Device->Handle, TransientImage->View, NULL);
+    Device->DestroyImage(Device->Handle, TransientImage->Handle, NULL);
+    if(TransientImage->Allocation != NULL)
+    {
+        Rr_TrackImageMemory(
+            Renderer,
+            RR_GPU_MEMORY_CATEGORY_TRANSIENT,
+            TransientImage->Allocation,
+            false);
+        vmaFreeMemory(Renderer->Allocator, TransientImage->Allocation);
+    }
+}
+
+void Rr_ReserveTransientHeap(
+    Rr_Renderer *Renderer,
+    Rr_TransientHeap *Heap,
+    VkMemoryRequirements *Requirements)
+{
+    bool IsCompatible =
+        Heap->Allocation != NULL && Heap->Size >= Requirements->size &&
+        RR_HAS_BIT(Requirements->memoryTypeBits, 1U << Heap->MemoryType);
+    if(IsCompatible || Requirements->size == 0)
+    {
+        return;
+    }
+
+    /* Images are bound to the old block, recreate them all. */
+
+    for(size_t Index = 0; Index < Heap->Images.Count; ++Index)
+    {
+        Rr_DestroyTransientImage(Renderer, Heap->Images.Data + Index);
+    }
+    RR_EMPTY_SLICE(&Heap->Images);
+
+    if(Heap->Allocation != NULL)
+    {
+        Rr_TrackImageMemory(
+            Renderer,
+            RR_GPU_MEMORY_CATEGORY_TRANSIENT,
+            Heap->Allocation,
+            false);
+        vmaFreeMemory(Renderer->Allocator, Heap->Allocation);
+    }
+
+    VmaAllocationCreateInfo AllocationCreateInfo = {
+        .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+    };
+    VmaAllocationInfo AllocationInfo;
+    vmaAllocateMemory(
+        Renderer->Allocator,
+        Requirements,
+        &AllocationCreateInfo,
+        &Heap->Allocation,
+        &AllocationInfo);
+    Rr_TrackGPUMemory(
+        Renderer,
+        RR_GPU_MEMORY_CATEGORY_TRANSIENT,
+        AllocationInfo.size,
+        true);
+
+    Heap->Size = Requirements->size;
+    Heap->MemoryType = AllocationInfo.memoryType;
+
+    RR_LOG(
+        "Transient heap resized to %zu bytes.",
+        (size_t)Requirements->size);
+}
+
+void Rr_BindTransientImage(
+    Rr_Renderer *Renderer,
+    Rr_TransientHeap *Heap,
+    Rr_Image *Image,
+    VkImageCreateInfo *CreateInfo,
+    VkImageViewType ViewType,
+    uint64_t Hash,
+    VkDeviceSize Offset)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    Rr_TransientImage *TransientImage = NULL;
+    for(size_t Index = 0; Index < Heap->Images.Count; ++Index)
+    {
+        Rr_TransientImage *Cached = Heap->Images.Data + Index;
+        if(Cached->Used == false && Cached->Hash == Hash &&
+           Cached->Offset == Offset)
+        {
+            TransientImage = Cached;
+            break;
+        }
+    }
+
+    if(TransientImage == NULL)
+    {
+        if(Heap->Arena == NULL)
+        {
+            Heap->Arena = Rr_CreateDefaultArena();
+        }
+
+        TransientImage = RR_PUSH_SLICE(&Heap->Images, Heap->Arena);
+        *TransientImage = (Rr_TransientImage){
+            .Hash = Hash,
+            .Offset = Offset,
+        };
+
+        Device->CreateImage(
+            Device->Handle,
+            CreateInfo,
+            NULL,
+            &TransientImage->Handle);
+
+        /* Offset past the heap means the image could not share
+         * the heap memory type, give it its own allocation. */
+
+        if(Offset == RR_TRANSIENT_DEDICATED_OFFSET)
+        {
+            VmaAllocationCreateInfo AllocationCreateInfo = {
+                .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            };
+            vmaAllocateMemoryForImage(
+                Renderer->Allocator,
+                TransientImage->Handle,
+                &AllocationCreateInfo,
+                &TransientImage->Allocation,
+                NULL);
+            Rr_TrackImageMemory(
+                Renderer,
+                RR_GPU_MEMORY_CATEGORY_TRANSIENT,
+                TransientImage->Allocation,
+                true);
+            vmaBindImageMemory(
+                Renderer->Allocator,
+                TransientImage->Allocation,
+                TransientImage->Handle);
+        }
+        else
+        {
+            vmaBindImageMemory2(
+                Renderer->Allocator,
+                Heap->Allocation,
+                Offset,
+                TransientImage->Handle,
+                NULL);
+        }
+
+        Rr_AllocatedImage AllocatedImage = {
+            .Handle = TransientImage->Handle,
+            .Container = Image,
+        };
+        Rr_CreateImageView(
+            Renderer,
+            &AllocatedImage,
+            ViewType,
+            CreateInfo->mipLevels);
+        TransientImage->View = AllocatedImage.View;
+    }
+
+    TransientImage->Used = true;
+
+    Image->AllocatedImages[0] = (Rr_AllocatedImage){
+        .Handle = TransientImage->Handle,
+        .View = TransientImage->View,
+        .Container = Image,
+    };
+}
+
+void Rr_TrimTransientHeap(Rr_Renderer *Renderer, Rr_TransientHeap *Heap)
+{
+    /* Images not reused by this frame belong to an older placement.
+     * Frame fence was waited on, so they can be destroyed right away. */
+
+    for(size_t Index = 0; Index < Heap->Images.Count;)
+    {
+        Rr_TransientImage *TransientImage = Heap->Images.Data + Index;
+        if(TransientImage->Used)
+        {
+            TransientImage->Used = false;
+            Index++;
+        }
+        else
+        {
+            Rr_DestroyTransientImage(Renderer, TransientImage);
+            *TransientImage = Heap->Images.Data[--Heap->Images.Count];
+        }
+    }
+}
+
+void Rr_DestroyTransientHeap(Rr_Renderer *Renderer, Rr_TransientHeap *Heap)
+{
+    for(size_t Index = 0; Index < Heap->Images.Count; ++Index)
+    {
+        Rr_DestroyTransientImage(Renderer, Heap->Images.Data + Index);
+    }
+
+    if(Heap->Allocation != NULL)
+    {
+        Rr_TrackImageMemory(
+            Renderer,
+            RR_GPU_MEMORY_CATEGORY_TRANSIENT,
+            Heap->Allocation,
+            false);
+        vmaFreeMemory(Renderer->Allocator, Heap->Allocation);
+    }
+
+    if(Heap->Arena != NULL)
+    {
+        Rr_DestroyArena(Heap->Arena);
+    }
+
+    *Heap = (Rr_TransientHeap){ 0 };
+}
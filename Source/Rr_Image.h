@@ -12,6 +12,7 @@
 struct Rr_Sampler
 {
     VkSampler Handle;
+    uint32_t BindlessIndex;
 };
 
 typedef struct Rr_AllocatedImage Rr_AllocatedImage;
@@ -21,6 +22,10 @@ struct Rr_AllocatedImage
     VkImageView View;
     VmaAllocation Allocation;
     Rr_Image *Container;
+
+    /* Bindless indices, only given to images from Rr_CreateImage. */
+    uint32_t SampledIndex;
+    uint32_t StorageIndex;
 };
 
 struct Rr_Image
@@ -29,10 +34,79 @@ struct Rr_Image
     VkImageAspectFlags AspectFlags;
     VkFormat Format;
     Rr_ImageFlags Flags;
+    uint32_t MipLevels;
     size_t AllocatedImageCount;
     Rr_AllocatedImage AllocatedImages[RR_MAX_FRAME_OVERLAP];
 };
 
+/* Transient images are owned by the render graph and live in a
+ * per-frame heap. Images with disjoint lifetimes share memory. */
+
+#define RR_TRANSIENT_DEDICATED_OFFSET (~(VkDeviceSize)0)
+
+typedef struct Rr_TransientImage Rr_TransientImage;
+struct Rr_TransientImage
+{
+    uint64_t Hash;
+    VkDeviceSize Offset;
+    VkImage Handle;
+    VkImageView View;
+    VmaAllocation Allocation;
+    bool Used;
+};
+
+typedef struct Rr_TransientHeap Rr_TransientHeap;
+struct Rr_TransientHeap
+{
+    VmaAllocation Allocation;
+    VkDeviceSize Size;
+    uint32_t MemoryType;
+    RR_SLICE(Rr_TransientImage) Images;
+    Rr_Arena *Arena;
+};
+
+extern void Rr_InitImage(
+    Rr_Image *Image,
+    Rr_IntVec3 Extent,
+    Rr_TextureFormat Format,
+    Rr_ImageFlags Flags,
+    VkImageCreateInfo *OutCreateInfo,
+    VkImageViewType *OutViewType);
+
+/* Same as Rr_CreateImage but ignores the GPU memory budget, for images
+ * the renderer cannot work without. */
+
+extern Rr_Image *Rr_CreateUnbudgetedImage(
+    Rr_Renderer *Renderer,
+    Rr_IntVec3 Extent,
+    Rr_TextureFormat Format,
+    Rr_ImageFlags Flags);
+
+extern VkMemoryRequirements Rr_GetTransientImageRequirements(
+    Rr_Renderer *Renderer,
+    VkImageCreateInfo *CreateInfo,
+    uint64_t Hash);
+
+extern void Rr_ReserveTransientHeap(
+    Rr_Renderer *Renderer,
+    Rr_TransientHeap *Heap,
+    VkMemoryRequirements *Requirements);
+
+extern void Rr_BindTransientImage(
+    Rr_Renderer *Renderer,
+    Rr_TransientHeap *Heap,
+    Rr_Image *Image,
+    VkImageCreateInfo *CreateInfo,
+    VkImageViewType ViewType,
+    uint64_t Hash,
+    VkDeviceSize Offset);
+
+extern void Rr_TrimTransientHeap(Rr_Renderer *Renderer, Rr_TransientHeap *Heap);
+
+extern void Rr_DestroyTransientHeap(
+    Rr_Renderer *Renderer,
+    Rr_TransientHeap *Heap);
+
 extern void Rr_UploadStagingImage(
     Rr_Renderer *Renderer,
     Rr_UploadContext *UploadContext,
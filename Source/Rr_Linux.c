@@ -5,15 +5,50 @@
 #include "Rr_Log.h"
 
 #include <assert.h>
+#include <stdio.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 static Rr_PlatformInfo PlatformInfo;
 
+static int Rr_GetTransparentHugePageSize(void)
+{
+#ifdef MADV_HUGEPAGE
+    char Mode[128] = { 0 };
+    FILE *File = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if(File == NULL)
+    {
+        return 0;
+    }
+    bool IsRead = fgets(Mode, sizeof(Mode), File) != NULL;
+    fclose(File);
+    if(IsRead == false || strstr(Mode, "[never]") != NULL)
+    {
+        return 0;
+    }
+
+    int Size = 0;
+    File = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+    if(File != NULL)
+    {
+        if(fscanf(File, "%d", &Size) != 1)
+        {
+            Size = 0;
+        }
+        fclose(File);
+    }
+    return Size > 0 ? Size : (int)RR_MEGABYTES(2);
+#else
+    return 0;
+#endif
+}
+
 bool Rr_InitPlatform(void)
 {
     PlatformInfo.PageSize = getpagesize();
     PlatformInfo.AllocationGranularity = PlatformInfo.PageSize;
+    PlatformInfo.HugePageSize = Rr_GetTransparentHugePageSize();
 
     return true;
 }
@@ -28,6 +63,42 @@ void *Rr_ReserveMemory(size_t Size)
     return mmap(0, Size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 }
 
+void *Rr_ReserveHugeMemory(size_t Size)
+{
+    size_t Alignment = PlatformInfo.HugePageSize;
+    if(Alignment == 0)
+    {
+        return Rr_ReserveMemory(Size);
+    }
+
+    /* Over-reserve and trim, mmap only guarantees page alignment. */
+
+    char *Data = mmap(
+        0,
+        Size + Alignment,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if(Data == MAP_FAILED)
+    {
+        return NULL;
+    }
+    char *Aligned = (char *)RR_ALIGN_POW2((uintptr_t)Data, Alignment);
+    size_t Head = Aligned - Data;
+    if(Head > 0)
+    {
+        munmap(Data, Head);
+    }
+    munmap(Aligned + Size, Alignment - Head);
+
+#ifdef MADV_HUGEPAGE
+    madvise(Aligned, Size, MADV_HUGEPAGE);
+#endif
+
+    return Aligned;
+}
+
 void Rr_ReleaseMemory(void *Data, size_t Size)
 {
     munmap(Data, Size);
@@ -39,8 +110,6 @@ bool Rr_CommitMemory(void *Data, size_t Size)
     {
         return false;
     }
-    mlock(Data, Size);
-    munlock(Data, Size);
     return true;
 }
 
@@ -50,6 +119,21 @@ void Rr_DecommitMemory(void *Data, size_t Size)
     mprotect(Data, Size, PROT_NONE);
 }
 
+void Rr_PrefaultMemory(void *Data, size_t Size)
+{
+#ifdef MADV_POPULATE_WRITE
+    if(madvise(Data, Size, MADV_POPULATE_WRITE) == 0)
+    {
+        return;
+    }
+#endif
+
+    /* Older kernels, locking faults the range in. */
+
+    mlock(Data, Size);
+    munlock(Data, Size);
+}
+
 int Rr_GetAtomicInt(Rr_AtomicInt *AtomicInt)
 {
     return __atomic_load_n(&AtomicInt->Value, __ATOMIC_SEQ_CST);
@@ -283,16 +283,17 @@ static Rr_LoadResult Rr_ProcessLoadContext(
         Rr_DestroyBuffer(Renderer, UploadContext.StagingBuffers.Data[Index]);
     }
 
-    Rr_LockSpinLock(&App->SyncArena.Lock);
-
     Rr_PendingLoad *PendingLoad =
-        RR_PUSH_SLICE(&Renderer->PendingLoadsSlice, App->SyncArena.Arena);
-    *PendingLoad = (Rr_PendingLoad){
-        .LoadingCallback = LoadContext->LoadingCallback,
-        .UserData = LoadContext->UserData,
-    };
-
-    Rr_UnlockSpinLock(&App->SyncArena.Lock);
+        RR_CONCURRENT_ALLOC_TYPE(App->LoadArena, Rr_PendingLoad);
+    PendingLoad->LoadingCallback = LoadContext->LoadingCallback;
+    PendingLoad->UserData = LoadContext->UserData;
+    do
+    {
+        PendingLoad->Next = SDL_GetAtomicPointer(&Renderer->PendingLoads);
+    } while(SDL_CompareAndSwapAtomicPointer(
+                &Renderer->PendingLoads,
+                PendingLoad->Next,
+                PendingLoad) == false);
 
     if(LoadContext->Semaphore)
     {
@@ -387,7 +388,13 @@ static int SDLCALL Rr_LoadThreadProc(void *UserData)
     Rr_Renderer *Renderer = App->Renderer;
     Rr_Device *Device = &Renderer->Device;
 
-    Rr_InitScratch(RR_LOADING_THREAD_SCRATCH_SIZE);
+    /* Load sizes vary per asset, so scratch grows on demand instead of
+     * prefaulting a worst case on every thread. */
+
+    Rr_InitScratch(
+        RR_LOADING_THREAD_SCRATCH_SIZE,
+        RR_SCRATCH_ARENA_COUNT,
+        RR_ARENA_FLAGS_HUGE_PAGES_BIT);
 
     Rr_LoadAsyncContext LoadAsyncContext = { 0 };
     Rr_InitLoadAsyncContext(Renderer, &LoadAsyncContext);
@@ -502,6 +509,8 @@ Rr_LoadContext *Rr_LoadAsync(
         RR_ABORT("Submitted zero tasks to load procedure!");
     }
 
+    SDL_AddAtomicInt(&LoadThread->App->Renderer->LoadsInFlight, 1);
+
     SDL_LockMutex(LoadThread->Mutex);
     Rr_LoadTask *NewTasks =
         RR_ALLOC_TYPE_COUNT(LoadThread->Arena, Rr_LoadTask, TaskCount);
@@ -11,6 +11,7 @@ struct Rr_PendingLoad
 {
     Rr_LoadCallback LoadingCallback;
     void *UserData;
+    Rr_PendingLoad *Next;
 };
 
 struct Rr_LoadThread
@@ -5,11 +5,35 @@
 #include <Rr/Rr_Platform.h>
 
 #include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_bits.h>
 #include <SDL3/SDL_thread.h>
 
 #include <assert.h>
 #include <limits.h>
 
+#if defined(__SANITIZE_ADDRESS__)
+#define RR_HAS_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define RR_HAS_ASAN 1
+#endif
+#endif
+
+#if RR_ARENA_POISONING && defined(RR_HAS_ASAN)
+#include <sanitizer/asan_interface.h>
+#define RR_POISON_MEMORY(Data, Size)   ASAN_POISON_MEMORY_REGION(Data, Size)
+#define RR_UNPOISON_MEMORY(Data, Size) ASAN_UNPOISON_MEMORY_REGION(Data, Size)
+#else
+#define RR_POISON_MEMORY(Data, Size)   ((void)(Data), (void)(Size))
+#define RR_UNPOISON_MEMORY(Data, Size) ((void)(Data), (void)(Size))
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RR_HASH_MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
 void *Rr_Malloc(size_t Bytes)
 {
     return SDL_malloc(Bytes);
@@ -40,14 +64,30 @@ void Rr_AlignedFree(void *Ptr)
     SDL_aligned_free(Ptr);
 }
 
-Rr_Arena *Rr_CreateArena(size_t ReserveSize, size_t CommitSize)
+Rr_Arena *Rr_CreateArena(
+    size_t ReserveSize,
+    size_t CommitSize,
+    Rr_ArenaFlags Flags)
 {
-    size_t PageSize = Rr_GetPlatformInfo()->PageSize;
+    Rr_PlatformInfo *PlatformInfo = Rr_GetPlatformInfo();
+    bool UsesHugePages = RR_HAS_BIT(Flags, RR_ARENA_FLAGS_HUGE_PAGES_BIT) &&
+                         PlatformInfo->HugePageSize > 0;
+
+    /* Committing part of a huge page would split it into regular pages,
+     * so huge page arenas commit in whole huge pages. */
+
+    size_t PageSize =
+        UsesHugePages ? PlatformInfo->HugePageSize : PlatformInfo->PageSize;
     ReserveSize = RR_ALIGN_POW2(ReserveSize, PageSize);
     CommitSize = RR_ALIGN_POW2(CommitSize, PageSize);
 
-    char *Data = Rr_ReserveMemory(ReserveSize);
+    char *Data = UsesHugePages ? Rr_ReserveHugeMemory(ReserveSize)
+                               : Rr_ReserveMemory(ReserveSize);
     Rr_CommitMemory(Data, CommitSize);
+    if(RR_HAS_BIT(Flags, RR_ARENA_FLAGS_PREFAULT_BIT))
+    {
+        Rr_PrefaultMemory(Data, CommitSize);
+    }
 
     Rr_Arena *Arena = (Rr_Arena *)Data;
     *Arena = (Rr_Arena){
@@ -56,6 +96,7 @@ Rr_Arena *Rr_CreateArena(size_t ReserveSize, size_t CommitSize)
         .CommitSize = CommitSize,
         .Reserved = ReserveSize,
         .Commited = CommitSize,
+        .Flags = Flags,
     };
 
     return Arena;
@@ -63,12 +104,65 @@ Rr_Arena *Rr_CreateArena(size_t ReserveSize, size_t CommitSize)
 
 Rr_Arena *Rr_CreateDefaultArena(void)
 {
-    return Rr_CreateArena(RR_ARENA_RESERVE_DEFAULT, RR_ARENA_COMMIT_DEFAULT);
+    return Rr_CreateArena(
+        RR_ARENA_RESERVE_DEFAULT,
+        RR_ARENA_COMMIT_DEFAULT,
+        RR_ARENA_FLAGS_PREFAULT_BIT);
+}
+
+static inline void Rr_UpdateArenaPeak(Rr_Arena *Arena)
+{
+    Arena->Peak = RR_MAX(Arena->Peak, Arena->Position);
+    Arena->WindowPeak = RR_MAX(Arena->WindowPeak, Arena->Position);
+}
+
+static inline void Rr_RewindArena(Rr_Arena *Arena, uintptr_t Position)
+{
+    Rr_UpdateArenaPeak(Arena);
+    RR_POISON_MEMORY((char *)Arena + Position, Arena->Position - Position);
+    Arena->Position = Position;
+}
+
+static void Rr_DecommitArenaWindow(Rr_Arena *Arena)
+{
+    uintptr_t Keep = RR_ALIGN_POW2(Arena->WindowPeak, Arena->CommitSize);
+    Keep = RR_MAX(Keep, Arena->CommitSize);
+    if(Arena->Commited > Keep)
+    {
+        Rr_DecommitMemory((char *)Arena + Keep, Arena->Commited - Keep);
+        Arena->Commited = Keep;
+    }
+    Arena->WindowPeak = Arena->Position;
+    Arena->WindowResets = 0;
 }
 
 void Rr_ResetArena(Rr_Arena *Arena)
 {
-    Arena->Position = sizeof(Rr_Arena);
+    Rr_RewindArena(Arena, sizeof(Rr_Arena));
+
+    if(Arena->DecommitWindow > 0 &&
+       ++Arena->WindowResets >= Arena->DecommitWindow)
+    {
+        Rr_DecommitArenaWindow(Arena);
+    }
+}
+
+void Rr_SetArenaDecommitWindow(Rr_Arena *Arena, uint32_t Resets)
+{
+    Arena->DecommitWindow = Resets;
+    Arena->WindowResets = 0;
+}
+
+Rr_ArenaStats Rr_GetArenaStats(Rr_Arena *Arena)
+{
+    Rr_UpdateArenaPeak(Arena);
+
+    return (Rr_ArenaStats){
+        .Reserved = Arena->Reserved,
+        .Committed = Arena->Commited,
+        .Peak = Arena->Peak,
+        .Current = Arena->Position,
+    };
 }
 
 void Rr_DestroyArena(Rr_Arena *Arena)
@@ -77,6 +171,7 @@ void Rr_DestroyArena(Rr_Arena *Arena)
     {
         return;
     }
+    RR_UNPOISON_MEMORY(Arena, Arena->Commited);
     Rr_ReleaseMemory((void *)Arena, Arena->ReserveSize);
 }
 
@@ -87,15 +182,31 @@ Rr_Scratch Rr_CreateScratch(Rr_Arena *Arena)
 
 void Rr_DestroyScratch(Rr_Scratch Scratch)
 {
-    Scratch.Arena->Position = Scratch.Position;
+    /* Releasing the outermost scratch empties the arena. */
+
+    if(Scratch.Position == sizeof(Rr_Arena))
+    {
+        Rr_ResetArena(Scratch.Arena);
+    }
+    else
+    {
+        Rr_RewindArena(Scratch.Arena, Scratch.Position);
+    }
 }
 
+typedef struct Rr_ScratchArenas Rr_ScratchArenas;
+struct Rr_ScratchArenas
+{
+    size_t Count;
+    Rr_Arena *Arenas[];
+};
+
 static void SDLCALL Rr_CleanupScratchArena(void *ScratchArena)
 {
-    Rr_Arena **Arenas = ScratchArena;
-    for(size_t Index = 0; Index < 2; ++Index)
+    Rr_ScratchArenas *ScratchArenas = ScratchArena;
+    for(size_t Index = 0; Index < ScratchArenas->Count; ++Index)
     {
-        Rr_DestroyArena(Arenas[Index]);
+        Rr_DestroyArena(ScratchArenas->Arenas[Index]);
     }
     Rr_Free(ScratchArena);
 }
@@ -107,39 +218,47 @@ void Rr_SetScratchTLS(void *TLSID)
     ScratchArenaTLS = *((SDL_TLSID *)TLSID);
 }
 
-void Rr_InitScratch(size_t Size)
+void Rr_InitScratch(size_t Size, size_t Count, Rr_ArenaFlags Flags)
 {
     if(SDL_GetTLS(&ScratchArenaTLS) != 0)
     {
         RR_ABORT("Scratch is already initialized for this thread!");
     }
-    Rr_Arena **Arenas = Rr_Calloc(2, sizeof(Rr_Arena *));
-    for(size_t Index = 0; Index < 2; ++Index)
+    if(Count == 0)
     {
-        Arenas[Index] = Rr_CreateDefaultArena();
+        RR_ABORT("Scratch needs at least one arena!");
     }
-    SDL_SetTLS(&ScratchArenaTLS, Arenas, Rr_CleanupScratchArena);
+    Rr_ScratchArenas *ScratchArenas =
+        Rr_Calloc(1, sizeof(Rr_ScratchArenas) + sizeof(Rr_Arena *) * Count);
+    ScratchArenas->Count = Count;
+    for(size_t Index = 0; Index < Count; ++Index)
+    {
+        Rr_Arena *Arena = Rr_CreateArena(RR_ARENA_RESERVE_DEFAULT, Size, Flags);
+        Rr_SetArenaDecommitWindow(Arena, RR_SCRATCH_ARENA_DECOMMIT_WINDOW);
+        ScratchArenas->Arenas[Index] = Arena;
+    }
+    SDL_SetTLS(&ScratchArenaTLS, ScratchArenas, Rr_CleanupScratchArena);
 }
 
-Rr_Scratch Rr_GetScratch(Rr_Arena *Conflict)
+Rr_Scratch Rr_GetScratchAvoiding(size_t ConflictCount, Rr_Arena **Conflicts)
 {
     if(ScratchArenaTLS.value == 0)
     {
         RR_ABORT("ScratchArenaTLS is not set!");
     }
-    Rr_Arena **Arenas = (Rr_Arena **)SDL_GetTLS(&ScratchArenaTLS);
-    if(Conflict == NULL)
+    Rr_ScratchArenas *ScratchArenas = SDL_GetTLS(&ScratchArenaTLS);
+    for(size_t Index = 0; Index < ScratchArenas->Count; ++Index)
     {
-        return Rr_CreateScratch(Arenas[0]);
-    }
-    else
-    {
-        for(size_t Index = 0; Index < 2; ++Index)
+        Rr_Arena *Arena = ScratchArenas->Arenas[Index];
+        bool IsConflict = false;
+        for(size_t ConflictIndex = 0; ConflictIndex < ConflictCount;
+            ++ConflictIndex)
         {
-            if(Arenas[Index] != Conflict)
-            {
-                return Rr_CreateScratch(Arenas[Index]);
-            }
+            IsConflict |= Conflicts[ConflictIndex] == Arena;
+        }
+        if(IsConflict == false)
+        {
+            return Rr_CreateScratch(Arena);
         }
     }
 
@@ -148,6 +267,11 @@ Rr_Scratch Rr_GetScratch(Rr_Arena *Conflict)
     return (Rr_Scratch){ 0 };
 }
 
+Rr_Scratch Rr_GetScratch(Rr_Arena *Conflict)
+{
+    return Rr_GetScratchAvoiding(Conflict != NULL ? 1 : 0, &Conflict);
+}
+
 void *Rr_AllocArenaNoZero(
     Rr_Arena *Arena,
     size_t Size,
@@ -172,6 +296,10 @@ void *Rr_AllocArenaNoZero(
         uintptr_t CommitSize = CommitTarget - Arena->Commited;
         char *CommitPtr = (char *)Arena + Arena->Commited;
         Rr_CommitMemory(CommitPtr, CommitSize);
+        if(RR_HAS_BIT(Arena->Flags, RR_ARENA_FLAGS_PREFAULT_BIT))
+        {
+            Rr_PrefaultMemory(CommitPtr, CommitSize);
+        }
         Arena->Commited = CommitTarget;
     }
 
@@ -180,6 +308,7 @@ void *Rr_AllocArenaNoZero(
     {
         Result = (char *)Arena + PositionAligned;
         Arena->Position = Target;
+        RR_UNPOISON_MEMORY(Result, TotalSize);
     }
     else
     {
@@ -199,17 +328,181 @@ void *Rr_AllocArena(Rr_Arena *Arena, size_t Size, size_t Align, size_t Count)
 
 void Rr_PopArena(Rr_Arena *Arena, size_t Amount)
 {
-    Arena->Position -= Amount;
+    Rr_RewindArena(Arena, Arena->Position - Amount);
+}
+
+struct Rr_ConcurrentArena
+{
+    SDL_AtomicPointer Position;
+    SDL_TLSID LocalTLS;
+    uint32_t Epoch;
+    uintptr_t Start;
+    uintptr_t ReserveSize;
+    uintptr_t ChunkSize;
+};
+
+/* Chunk owned by the calling thread, stale once the arena epoch moves. */
+
+typedef struct Rr_ConcurrentArenaLocal Rr_ConcurrentArenaLocal;
+struct Rr_ConcurrentArenaLocal
+{
+    uint32_t Epoch;
+    char *Position;
+    char *End;
+};
+
+Rr_ConcurrentArena *Rr_CreateConcurrentArena(
+    size_t ReserveSize,
+    size_t ChunkSize)
+{
+    size_t PageSize = Rr_GetPlatformInfo()->PageSize;
+    ReserveSize = RR_ALIGN_POW2(ReserveSize, PageSize);
+    ChunkSize = RR_ALIGN_POW2(ChunkSize, PageSize);
+    size_t HeaderSize = RR_ALIGN_POW2(sizeof(Rr_ConcurrentArena), PageSize);
+
+    char *Data = Rr_ReserveMemory(ReserveSize);
+    Rr_CommitMemory(Data, HeaderSize);
+
+    Rr_ConcurrentArena *Arena = (Rr_ConcurrentArena *)Data;
+    *Arena = (Rr_ConcurrentArena){
+        .Start = HeaderSize,
+        .ReserveSize = ReserveSize,
+        .ChunkSize = ChunkSize,
+    };
+    SDL_SetAtomicPointer(&Arena->Position, Data + HeaderSize);
+
+    return Arena;
+}
+
+Rr_ConcurrentArena *Rr_CreateDefaultConcurrentArena(void)
+{
+    return Rr_CreateConcurrentArena(
+        RR_ARENA_RESERVE_DEFAULT,
+        RR_CONCURRENT_ARENA_CHUNK_DEFAULT);
+}
+
+void Rr_ResetConcurrentArena(Rr_ConcurrentArena *Arena)
+{
+    SDL_SetAtomicPointer(&Arena->Position, (char *)Arena + Arena->Start);
+    Arena->Epoch++;
+}
+
+void Rr_DestroyConcurrentArena(Rr_ConcurrentArena *Arena)
+{
+    if(Arena == NULL)
+    {
+        return;
+    }
+    Rr_ReleaseMemory((void *)Arena, Arena->ReserveSize);
+}
+
+static void SDLCALL Rr_CleanupConcurrentArenaLocal(void *Local)
+{
+    Rr_Free(Local);
+}
+
+/* Chunks are page aligned so that threads never commit the same page. */
+
+static char *Rr_CarveConcurrentArena(Rr_ConcurrentArena *Arena, size_t Size)
+{
+    Size = RR_ALIGN_POW2(Size, (size_t)Rr_GetPlatformInfo()->PageSize);
+    char *End = (char *)Arena + Arena->ReserveSize;
+
+    char *Chunk;
+    do
+    {
+        Chunk = SDL_GetAtomicPointer(&Arena->Position);
+        if((size_t)(End - Chunk) < Size)
+        {
+            RR_ABORT("Concurrent arena reserved memory overflow!");
+        }
+    } while(SDL_CompareAndSwapAtomicPointer(
+                &Arena->Position,
+                Chunk,
+                Chunk + Size) == false);
+
+    if(Rr_CommitMemory(Chunk, Size) == false)
+    {
+        RR_ABORT("Failed to commit concurrent arena memory!");
+    }
+
+    return Chunk;
+}
+
+void *Rr_AllocConcurrentArenaNoZero(
+    Rr_ConcurrentArena *Arena,
+    size_t Size,
+    size_t Align,
+    size_t Count)
+{
+    if(Size == 0 || Count == 0)
+    {
+        RR_LOG("Allocating 0 bytes from an arena!");
+        return NULL;
+    }
+
+    Rr_ConcurrentArenaLocal *Local = SDL_GetTLS(&Arena->LocalTLS);
+    if(Local == NULL)
+    {
+        Local = Rr_Calloc(1, sizeof(Rr_ConcurrentArenaLocal));
+        SDL_SetTLS(&Arena->LocalTLS, Local, Rr_CleanupConcurrentArenaLocal);
+    }
+    if(Local->Epoch != Arena->Epoch)
+    {
+        *Local = (Rr_ConcurrentArenaLocal){ .Epoch = Arena->Epoch };
+    }
+
+    size_t TotalSize = Size * Count;
+    uintptr_t PositionAligned =
+        RR_ALIGN_POW2((uintptr_t)Local->Position, Align);
+    if(PositionAligned + TotalSize > (uintptr_t)Local->End)
+    {
+        /* Large requests would waste most of a fresh chunk,
+         * give them their own and keep bumping the current one. */
+
+        if(TotalSize + Align > Arena->ChunkSize / 2)
+        {
+            char *Chunk = Rr_CarveConcurrentArena(Arena, TotalSize + Align);
+            return (void *)RR_ALIGN_POW2((uintptr_t)Chunk, Align);
+        }
+
+        Local->Position = Rr_CarveConcurrentArena(Arena, Arena->ChunkSize);
+        Local->End = Local->Position + Arena->ChunkSize;
+        PositionAligned = RR_ALIGN_POW2((uintptr_t)Local->Position, Align);
+    }
+
+    Local->Position = (char *)PositionAligned + TotalSize;
+
+    return (void *)PositionAligned;
 }
 
-Rr_SyncArena Rr_CreateSyncArena(void)
+void *Rr_AllocConcurrentArena(
+    Rr_ConcurrentArena *Arena,
+    size_t Size,
+    size_t Align,
+    size_t Count)
 {
-    return (Rr_SyncArena){ .Arena = Rr_CreateDefaultArena() };
+    return memset(
+        Rr_AllocConcurrentArenaNoZero(Arena, Size, Align, Count),
+        0,
+        Size * Count);
 }
 
-void Rr_DestroySyncArena(Rr_SyncArena *Arena)
+/* Slice data ending at the top of the arena can grow without moving. */
+
+static bool Rr_ExtendSliceInPlace(
+    Rr_Arena *Arena,
+    void *Data,
+    size_t OldSize,
+    size_t NewSize)
 {
-    Rr_DestroyArena(Arena->Arena);
+    char *Top = (char *)Arena + Arena->Position;
+    if(Data == NULL || (char *)Data + OldSize != Top)
+    {
+        return false;
+    }
+    Rr_AllocArenaNoZero(Arena, NewSize - OldSize, 1, 1);
+    return true;
 }
 
 void Rr_GrowSlice(void *Slice, size_t Size, Rr_Arena *Arena)
@@ -222,10 +515,21 @@ void Rr_GrowSlice(void *Slice, size_t Size, Rr_Arena *Arena)
     RR_SLICE(void) Replica;
     memcpy(&Replica, Slice, sizeof(Replica));
 
-    void *Data = NULL;
+    size_t OldCapacity = Replica.Capacity;
     Replica.Capacity = Replica.Capacity ? Replica.Capacity : 1;
     Replica.Capacity *= 2;
-    Data = RR_ALLOC_NO_ZERO(Arena, Size * Replica.Capacity);
+
+    if(Rr_ExtendSliceInPlace(
+           Arena,
+           Replica.Data,
+           Size * OldCapacity,
+           Size * Replica.Capacity))
+    {
+        memcpy(Slice, &Replica, sizeof(Replica));
+        return;
+    }
+
+    void *Data = RR_ALLOC_NO_ZERO(Arena, Size * Replica.Capacity);
 
     if(Replica.Count)
     {
@@ -246,10 +550,21 @@ void Rr_ResizeSlice(void *Slice, size_t Size, size_t Count, Rr_Arena *Arena)
     RR_SLICE(void) Replica;
     memcpy(&Replica, Slice, sizeof(Replica));
 
-    void *Data = NULL;
-
+    size_t OldCapacity = Replica.Capacity;
     Replica.Capacity = Count;
-    Data = RR_ALLOC_NO_ZERO(Arena, Size * Count);
+
+    if(Count > OldCapacity &&
+       Rr_ExtendSliceInPlace(
+           Arena,
+           Replica.Data,
+           Size * OldCapacity,
+           Size * Count))
+    {
+        memcpy(Slice, &Replica, sizeof(Replica));
+        return;
+    }
+
+    void *Data = RR_ALLOC_NO_ZERO(Arena, Size * Count);
 
     if(Replica.Count)
     {
@@ -260,11 +575,56 @@ void Rr_ResizeSlice(void *Slice, size_t Size, size_t Count, Rr_Arena *Arena)
     memcpy(Slice, &Replica, sizeof(Replica));
 }
 
+void Rr_PushSegmentedSlice(void *Slice, size_t Size, Rr_Arena *Arena)
+{
+    /* Same layout for every element type. */
+
+    void **Segments = Slice;
+    size_t *Count = (size_t *)(Segments + RR_SEGMENTED_SLICE_SEGMENTS);
+
+    size_t Segment = Rr_GetSliceSegment(*Count);
+    if(Segment >= RR_SEGMENTED_SLICE_SEGMENTS)
+    {
+        RR_ABORT("Segmented slice overflow!");
+    }
+
+    /* Segments are kept when the slice is emptied. */
+
+    if(Segments[Segment] == NULL)
+    {
+        if(Arena == NULL)
+        {
+            RR_ABORT("Attempt to grow a slice but Arena is NULL!");
+        }
+        Segments[Segment] = RR_ALLOC_NO_ZERO(
+            Arena,
+            Size * (RR_SEGMENTED_SLICE_BASE << Segment));
+    }
+
+    char *Element = (char *)Segments[Segment] +
+                    Size * Rr_GetSliceSegmentOffset(*Count);
+    memset(Element, 0, Size);
+    (*Count)++;
+}
+
+/* Pointer keys and sequential indices leave most bits unused,
+ * mix them before using bits of the key for lookup. */
+
+static inline uint64_t Rr_HashMapKey(Rr_MapKey Key)
+{
+    Key ^= Key >> 30;
+    Key *= 0xBF58476D1CE4E5B9ull;
+    Key ^= Key >> 27;
+    Key *= 0x94D049BB133111EBull;
+    Key ^= Key >> 31;
+    return Key;
+}
+
 void **Rr_UpsertMap(Rr_Map **Map, Rr_MapKey Key, Rr_Arena *Arena)
 {
     if(*Map != NULL)
     {
-        for(Rr_MapKey Hash = Key; *Map; Hash <<= 2)
+        for(Rr_MapKey Hash = Rr_HashMapKey(Key); *Map; Hash <<= 2)
         {
             if(Key == (*Map)->Key)
             {
@@ -283,6 +643,268 @@ void **Rr_UpsertMap(Rr_Map **Map, Rr_MapKey Key, Rr_Arena *Arena)
     return &(*Map)->Value;
 }
 
+#define RR_HASH_MAP_EMPTY   0x80
+#define RR_HASH_MAP_DELETED 0xFE
+
+/* Bit per slot of a group whose control byte matches. */
+
+static inline uint32_t Rr_MatchHashMapGroup(const uint8_t *Group, uint8_t Byte)
+{
+#ifdef RR_HASH_MAP_SSE2
+    __m128i Control = _mm_loadu_si128((const __m128i *)Group);
+    __m128i Match = _mm_cmpeq_epi8(Control, _mm_set1_epi8((char)Byte));
+    return (uint32_t)_mm_movemask_epi8(Match);
+#else
+    uint32_t Mask = 0;
+    for(uint32_t Index = 0; Index < RR_HASH_MAP_GROUP_SIZE; ++Index)
+    {
+        Mask |= (uint32_t)(Group[Index] == Byte) << Index;
+    }
+    return Mask;
+#endif
+}
+
+/* Empty and deleted control bytes are the ones with the high bit set. */
+
+static inline uint32_t Rr_MatchHashMapGroupFree(const uint8_t *Group)
+{
+#ifdef RR_HASH_MAP_SSE2
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_loadu_si128((const __m128i *)Group));
+#else
+    uint32_t Mask = 0;
+    for(uint32_t Index = 0; Index < RR_HASH_MAP_GROUP_SIZE; ++Index)
+    {
+        Mask |= (uint32_t)(Group[Index] >> 7) << Index;
+    }
+    return Mask;
+#endif
+}
+
+static inline uint32_t Rr_GetLowestBitIndex(uint32_t Mask)
+{
+    return (uint32_t)SDL_MostSignificantBitIndex32(Mask & (0u - Mask));
+}
+
+/* Groups are visited in triangular order, which covers every group of
+ * a power of two table. At least one empty slot is always left so
+ * unsuccessful lookups terminate. */
+
+static Rr_HashMapSlot *Rr_FindHashMapSlot(
+    Rr_HashMap *Map,
+    Rr_MapKey Key,
+    uint64_t Hash)
+{
+    if(Map->Capacity == 0)
+    {
+        return NULL;
+    }
+
+    size_t GroupMask = Map->Capacity / RR_HASH_MAP_GROUP_SIZE - 1;
+    size_t Group = (Hash >> 7) & GroupMask;
+    uint8_t Tag = Hash & 0x7F;
+
+    for(size_t Probe = 1;; ++Probe)
+    {
+        size_t Base = Group * RR_HASH_MAP_GROUP_SIZE;
+        uint8_t *Control = Map->Control + Base;
+        for(uint32_t Mask = Rr_MatchHashMapGroup(Control, Tag); Mask != 0;
+            Mask &= Mask - 1)
+        {
+            Rr_HashMapSlot *Slot =
+                Map->Slots + Base + Rr_GetLowestBitIndex(Mask);
+            if(Slot->Key == Key)
+            {
+                return Slot;
+            }
+        }
+        if(Rr_MatchHashMapGroup(Control, RR_HASH_MAP_EMPTY) != 0)
+        {
+            return NULL;
+        }
+        Group = (Group + Probe) & GroupMask;
+    }
+}
+
+static size_t Rr_FindHashMapFreeIndex(Rr_HashMap *Map, uint64_t Hash)
+{
+    size_t GroupMask = Map->Capacity / RR_HASH_MAP_GROUP_SIZE - 1;
+    size_t Group = (Hash >> 7) & GroupMask;
+
+    for(size_t Probe = 1;; ++Probe)
+    {
+        size_t Base = Group * RR_HASH_MAP_GROUP_SIZE;
+        uint32_t Mask = Rr_MatchHashMapGroupFree(Map->Control + Base);
+        if(Mask != 0)
+        {
+            return Base + Rr_GetLowestBitIndex(Mask);
+        }
+        Group = (Group + Probe) & GroupMask;
+    }
+}
+
+static void Rr_RehashHashMap(
+    Rr_HashMap *Map,
+    size_t Capacity,
+    Rr_Arena *Arena)
+{
+    Rr_HashMap Old = *Map;
+
+    Map->Capacity = Capacity;
+    Map->Count = 0;
+    Map->Tombstones = 0;
+    Map->Control = RR_ALLOC_NO_ZERO(Arena, Capacity);
+    Map->Slots = RR_ALLOC_TYPE_COUNT(Arena, Rr_HashMapSlot, Capacity);
+    memset(Map->Control, RR_HASH_MAP_EMPTY, Capacity);
+
+    for(size_t Index = 0; Index < Old.Capacity; ++Index)
+    {
+        if(Old.Control[Index] & 0x80)
+        {
+            continue;
+        }
+        uint64_t Hash = Rr_HashMapKey(Old.Slots[Index].Key);
+        size_t NewIndex = Rr_FindHashMapFreeIndex(Map, Hash);
+        Map->Control[NewIndex] = Old.Control[Index];
+        Map->Slots[NewIndex] = Old.Slots[Index];
+        Map->Count++;
+    }
+}
+
+/* Same capacity rehash that drops tombstones without new storage. Live
+ * entries are first marked deleted and tombstones emptied, then each
+ * marked entry moves to the first free slot of its probe sequence,
+ * swapping with a marked entry that still has to be placed. */
+
+static void Rr_PurgeHashMapTombstones(Rr_HashMap *Map)
+{
+    for(size_t Index = 0; Index < Map->Capacity; ++Index)
+    {
+        Map->Control[Index] = (Map->Control[Index] & 0x80)
+                                  ? RR_HASH_MAP_EMPTY
+                                  : RR_HASH_MAP_DELETED;
+    }
+
+    for(size_t Index = 0; Index < Map->Capacity; ++Index)
+    {
+        while(Map->Control[Index] == RR_HASH_MAP_DELETED)
+        {
+            uint64_t Hash = Rr_HashMapKey(Map->Slots[Index].Key);
+            uint8_t Tag = Hash & 0x7F;
+            size_t NewIndex = Rr_FindHashMapFreeIndex(Map, Hash);
+
+            /* Lookups match whole groups, any slot of the group works. */
+
+            if(NewIndex / RR_HASH_MAP_GROUP_SIZE ==
+               Index / RR_HASH_MAP_GROUP_SIZE)
+            {
+                Map->Control[Index] = Tag;
+            }
+            else if(Map->Control[NewIndex] == RR_HASH_MAP_EMPTY)
+            {
+                Map->Slots[NewIndex] = Map->Slots[Index];
+                Map->Control[NewIndex] = Tag;
+                Map->Control[Index] = RR_HASH_MAP_EMPTY;
+            }
+            else
+            {
+                Rr_HashMapSlot Slot = Map->Slots[NewIndex];
+                Map->Slots[NewIndex] = Map->Slots[Index];
+                Map->Slots[Index] = Slot;
+                Map->Control[NewIndex] = Tag;
+            }
+        }
+    }
+
+    Map->Tombstones = 0;
+}
+
+void **Rr_UpsertHashMap(Rr_HashMap *Map, Rr_MapKey Key, Rr_Arena *Arena)
+{
+    uint64_t Hash = Rr_HashMapKey(Key);
+
+    Rr_HashMapSlot *Slot = Rr_FindHashMapSlot(Map, Key, Hash);
+    if(Slot != NULL)
+    {
+        return &Slot->Value;
+    }
+    if(Arena == NULL)
+    {
+        return NULL;
+    }
+
+    /* Keep the load below 7/8, rehash in place when mostly tombstones. */
+
+    if((Map->Count + Map->Tombstones + 1) * 8 > Map->Capacity * 7)
+    {
+        size_t Capacity = RR_HASH_MAP_GROUP_SIZE;
+        while((Map->Count + 1) * 2 > Capacity)
+        {
+            Capacity *= 2;
+        }
+        if(Capacity > Map->Capacity)
+        {
+            Rr_RehashHashMap(Map, Capacity, Arena);
+        }
+        else
+        {
+            Rr_PurgeHashMapTombstones(Map);
+        }
+    }
+
+    size_t Index = Rr_FindHashMapFreeIndex(Map, Hash);
+    if(Map->Control[Index] == RR_HASH_MAP_DELETED)
+    {
+        Map->Tombstones--;
+    }
+    Map->Control[Index] = Hash & 0x7F;
+    Map->Count++;
+
+    Slot = Map->Slots + Index;
+    Slot->Key = Key;
+    Slot->Value = NULL;
+
+    return &Slot->Value;
+}
+
+bool Rr_RemoveHashMap(Rr_HashMap *Map, Rr_MapKey Key)
+{
+    Rr_HashMapSlot *Slot = Rr_FindHashMapSlot(Map, Key, Rr_HashMapKey(Key));
+    if(Slot == NULL)
+    {
+        return false;
+    }
+
+    /* A group that still has an empty slot was never full, so no probe
+     * went past it and the slot can be emptied instead of deleted. */
+
+    size_t Index = Slot - Map->Slots;
+    uint8_t *Group =
+        Map->Control + Index / RR_HASH_MAP_GROUP_SIZE * RR_HASH_MAP_GROUP_SIZE;
+    if(Rr_MatchHashMapGroup(Group, RR_HASH_MAP_EMPTY) != 0)
+    {
+        Map->Control[Index] = RR_HASH_MAP_EMPTY;
+    }
+    else
+    {
+        Map->Control[Index] = RR_HASH_MAP_DELETED;
+        Map->Tombstones++;
+    }
+    Map->Count--;
+
+    return true;
+}
+
+void Rr_ClearHashMap(Rr_HashMap *Map)
+{
+    if(Map->Capacity > 0)
+    {
+        memset(Map->Control, RR_HASH_MAP_EMPTY, Map->Capacity);
+    }
+    Map->Count = 0;
+    Map->Tombstones = 0;
+}
+
 typedef struct Rr_FreeList Rr_FreeList;
 struct Rr_FreeList
 {
@@ -327,3 +949,400 @@ void Rr_ReturnFreeListItem(void *FreeList, void *Pointer)
     FreeListTyped->First = ((char *)Pointer) - sizeof(Rr_FreeListHeader);
     ((Rr_FreeListHeader *)FreeListTyped->First)->Next = OldFirst;
 }
+
+static char *Rr_GetPoolSlotData(Rr_Pool *Pool, size_t Size, uint32_t Index)
+{
+    return Pool->Items.Segments[Rr_GetSliceSegment(Index)] +
+           Size * Rr_GetSliceSegmentOffset(Index);
+}
+
+static uint32_t Rr_GetPoolSlotIndex(Rr_Pool *Pool, size_t Size, void *Item)
+{
+    uintptr_t Address = (uintptr_t)Item;
+    for(size_t Segment = 0; Segment < RR_SEGMENTED_SLICE_SEGMENTS &&
+                            Pool->Items.Segments[Segment] != NULL;
+        ++Segment)
+    {
+        uintptr_t Data = (uintptr_t)Pool->Items.Segments[Segment];
+        size_t Capacity = (size_t)RR_SEGMENTED_SLICE_BASE << Segment;
+        if(Address >= Data && Address < Data + Size * Capacity)
+        {
+            return (uint32_t)(Capacity - RR_SEGMENTED_SLICE_BASE +
+                              (Address - Data) / Size);
+        }
+    }
+
+    RR_ABORT("Item doesn't belong to the pool!");
+
+    return 0;
+}
+
+void *Rr_AllocPoolItem(Rr_Pool *Pool, size_t Size, Rr_Arena *Arena)
+{
+    assert(Pool != NULL && Size >= sizeof(uint32_t));
+
+    uint32_t Index;
+    char *Item;
+    if(Pool->FirstFree != 0)
+    {
+        Index = Pool->FirstFree - 1;
+        Item = Rr_GetPoolSlotData(Pool, Size, Index);
+        memcpy(&Pool->FirstFree, Item, sizeof(uint32_t));
+    }
+    else
+    {
+        Index = (uint32_t)Pool->Items.Count;
+        Rr_PushSegmentedSlice(&Pool->Items, Size, Arena);
+        Rr_PushSegmentedSlice(&Pool->LiveSlots, sizeof(bool), Arena);
+        Item = Rr_GetPoolSlotData(Pool, Size, Index);
+    }
+
+    *RR_AT_SEGMENTED_SLICE(&Pool->LiveSlots, Index) = true;
+    Pool->LiveCount++;
+
+    return memset(Item, 0, Size);
+}
+
+void Rr_FreePoolItem(Rr_Pool *Pool, size_t Size, void *Item)
+{
+    assert(Pool != NULL && Item != NULL);
+
+    uint32_t Index = Rr_GetPoolSlotIndex(Pool, Size, Item);
+    bool *Live = RR_AT_SEGMENTED_SLICE(&Pool->LiveSlots, Index);
+    if(*Live == false)
+    {
+        RR_ABORT("Double free of a pool item!");
+    }
+    *Live = false;
+
+    memcpy(Item, &Pool->FirstFree, sizeof(uint32_t));
+    Pool->FirstFree = Index + 1;
+    Pool->LiveCount--;
+}
+
+/* Sizes below RR_TLSF_SMALL_SIZE map linearly to the first level,
+ * larger ones split each power of two into RR_TLSF_SL_COUNT lists. */
+
+#define RR_TLSF_ALIGNMENT_LOG2 4
+#define RR_TLSF_ALIGNMENT      (1 << RR_TLSF_ALIGNMENT_LOG2)
+#define RR_TLSF_SL_LOG2        4
+#define RR_TLSF_SL_COUNT       (1 << RR_TLSF_SL_LOG2)
+#define RR_TLSF_FL_SHIFT       (RR_TLSF_SL_LOG2 + RR_TLSF_ALIGNMENT_LOG2)
+#define RR_TLSF_FL_MAX_LOG2    37
+#define RR_TLSF_FL_COUNT       (RR_TLSF_FL_MAX_LOG2 - RR_TLSF_FL_SHIFT + 2)
+#define RR_TLSF_SMALL_SIZE     (1 << RR_TLSF_FL_SHIFT)
+
+/* Flags live in the low bits of the block size. */
+
+#define RR_TLSF_BLOCK_FREE_BIT      ((size_t)1 << 0)
+#define RR_TLSF_BLOCK_PREV_FREE_BIT ((size_t)1 << 1)
+#define RR_TLSF_BLOCK_FLAGS         (RR_TLSF_ALIGNMENT - 1)
+
+/* The header precedes the payload. Free list links are stored in the
+ * payload, which is why blocks are never smaller than two pointers.
+ * PrevPhysical is only valid while the previous block is free. */
+
+typedef struct Rr_TLSFBlock Rr_TLSFBlock;
+struct Rr_TLSFBlock
+{
+    Rr_TLSFBlock *PrevPhysical;
+    size_t Size;
+    Rr_TLSFBlock *NextFree;
+    Rr_TLSFBlock *PrevFree;
+};
+
+#define RR_TLSF_HEADER_SIZE    RR_TLSF_ALIGNMENT
+#define RR_TLSF_MIN_BLOCK_SIZE RR_TLSF_ALIGNMENT
+
+struct Rr_TLSF
+{
+    Rr_Arena *Arena;
+    size_t GrowSize;
+
+    /* Zero sized used block closing the managed range. */
+    Rr_TLSFBlock *Sentinel;
+
+    uint32_t FLBitmap;
+    uint32_t SLBitmap[RR_TLSF_FL_COUNT];
+    Rr_TLSFBlock *Blocks[RR_TLSF_FL_COUNT][RR_TLSF_SL_COUNT];
+};
+
+static inline uint32_t Rr_GetMostSignificantBitIndex(size_t Value)
+{
+    uint64_t Wide = Value;
+    if(Wide >> 32)
+    {
+        return 32 + SDL_MostSignificantBitIndex32((uint32_t)(Wide >> 32));
+    }
+    return SDL_MostSignificantBitIndex32((uint32_t)Wide);
+}
+
+static inline size_t Rr_GetTLSFBlockSize(Rr_TLSFBlock *Block)
+{
+    return Block->Size & ~(size_t)RR_TLSF_BLOCK_FLAGS;
+}
+
+static inline Rr_TLSFBlock *Rr_GetNextTLSFBlock(Rr_TLSFBlock *Block)
+{
+    return (Rr_TLSFBlock *)((char *)Block + RR_TLSF_HEADER_SIZE +
+                            Rr_GetTLSFBlockSize(Block));
+}
+
+static inline void Rr_MapTLSFSize(size_t Size, uint32_t *FL, uint32_t *SL)
+{
+    if(Size < RR_TLSF_SMALL_SIZE)
+    {
+        *FL = 0;
+        *SL = (uint32_t)(Size / RR_TLSF_ALIGNMENT);
+        return;
+    }
+    uint32_t Log2 = Rr_GetMostSignificantBitIndex(Size);
+    *SL = (uint32_t)(Size >> (Log2 - RR_TLSF_SL_LOG2)) ^ RR_TLSF_SL_COUNT;
+    *FL = Log2 - RR_TLSF_FL_SHIFT + 1;
+}
+
+static void Rr_InsertTLSFBlock(Rr_TLSF *TLSF, Rr_TLSFBlock *Block)
+{
+    uint32_t FL, SL;
+    Rr_MapTLSFSize(Rr_GetTLSFBlockSize(Block), &FL, &SL);
+    assert(FL < RR_TLSF_FL_COUNT);
+
+    Rr_TLSFBlock *Head = TLSF->Blocks[FL][SL];
+    Block->NextFree = Head;
+    Block->PrevFree = NULL;
+    if(Head != NULL)
+    {
+        Head->PrevFree = Block;
+    }
+    TLSF->Blocks[FL][SL] = Block;
+    TLSF->FLBitmap |= 1u << FL;
+    TLSF->SLBitmap[FL] |= 1u << SL;
+}
+
+static void Rr_RemoveTLSFBlock(Rr_TLSF *TLSF, Rr_TLSFBlock *Block)
+{
+    uint32_t FL, SL;
+    Rr_MapTLSFSize(Rr_GetTLSFBlockSize(Block), &FL, &SL);
+
+    if(Block->NextFree != NULL)
+    {
+        Block->NextFree->PrevFree = Block->PrevFree;
+    }
+    if(Block->PrevFree != NULL)
+    {
+        Block->PrevFree->NextFree = Block->NextFree;
+    }
+    else
+    {
+        TLSF->Blocks[FL][SL] = Block->NextFree;
+        if(Block->NextFree == NULL)
+        {
+            TLSF->SLBitmap[FL] &= ~(1u << SL);
+            if(TLSF->SLBitmap[FL] == 0)
+            {
+                TLSF->FLBitmap &= ~(1u << FL);
+            }
+        }
+    }
+}
+
+/* Rounds the request up to the next list so that any block found
+ * there fits without walking the list. */
+
+static size_t Rr_RoundTLSFSize(size_t Size)
+{
+    if(Size >= RR_TLSF_SMALL_SIZE)
+    {
+        uint32_t Log2 = Rr_GetMostSignificantBitIndex(Size);
+        Size += ((size_t)1 << (Log2 - RR_TLSF_SL_LOG2)) - 1;
+    }
+
+    return Size;
+}
+
+static Rr_TLSFBlock *Rr_FindTLSFBlock(Rr_TLSF *TLSF, size_t Size)
+{
+    uint32_t FL, SL;
+    Rr_MapTLSFSize(Rr_RoundTLSFSize(Size), &FL, &SL);
+    if(FL >= RR_TLSF_FL_COUNT)
+    {
+        return NULL;
+    }
+
+    uint32_t SLMap = TLSF->SLBitmap[FL] & (~0u << SL);
+    if(SLMap == 0)
+    {
+        uint32_t FLMap = TLSF->FLBitmap & (~0u << (FL + 1));
+        if(FLMap == 0)
+        {
+            return NULL;
+        }
+        FL = Rr_GetLowestBitIndex(FLMap);
+        SLMap = TLSF->SLBitmap[FL];
+    }
+    SL = Rr_GetLowestBitIndex(SLMap);
+
+    Rr_TLSFBlock *Block = TLSF->Blocks[FL][SL];
+    Rr_RemoveTLSFBlock(TLSF, Block);
+
+    return Block;
+}
+
+static Rr_TLSFBlock *Rr_MergeTLSFBlockWithPrev(
+    Rr_TLSF *TLSF,
+    Rr_TLSFBlock *Block)
+{
+    if((Block->Size & RR_TLSF_BLOCK_PREV_FREE_BIT) == 0)
+    {
+        return Block;
+    }
+
+    Rr_TLSFBlock *Prev = Block->PrevPhysical;
+    Rr_RemoveTLSFBlock(TLSF, Prev);
+    Prev->Size += RR_TLSF_HEADER_SIZE + Rr_GetTLSFBlockSize(Block);
+    Rr_GetNextTLSFBlock(Prev)->PrevPhysical = Prev;
+
+    return Prev;
+}
+
+/* Takes a block carved from the arena right after the sentinel, the
+ * old sentinel becomes its header and a new one closes the range.
+ * The block must cover the rounded size, otherwise it lands in a list
+ * below the one Rr_FindTLSFBlock searches. */
+
+static void Rr_GrowTLSF(Rr_TLSF *TLSF, size_t Size)
+{
+    size_t GrowSize = RR_MAX(
+        TLSF->GrowSize,
+        Rr_RoundTLSFSize(Size) + RR_TLSF_HEADER_SIZE);
+    GrowSize = RR_ALIGN_POW2(GrowSize, RR_TLSF_ALIGNMENT);
+
+    char *Data = Rr_AllocArenaNoZero(
+        TLSF->Arena,
+        GrowSize,
+        RR_TLSF_ALIGNMENT,
+        1);
+    assert(Data == (char *)TLSF->Sentinel + RR_TLSF_HEADER_SIZE);
+
+    Rr_TLSFBlock *Block = TLSF->Sentinel;
+    Block->Size = (GrowSize - RR_TLSF_HEADER_SIZE) | RR_TLSF_BLOCK_FREE_BIT |
+                  (Block->Size & RR_TLSF_BLOCK_PREV_FREE_BIT);
+
+    TLSF->Sentinel = Rr_GetNextTLSFBlock(Block);
+    TLSF->Sentinel->Size = RR_TLSF_BLOCK_PREV_FREE_BIT;
+    TLSF->Sentinel->PrevPhysical = Block;
+
+    Rr_InsertTLSFBlock(TLSF, Rr_MergeTLSFBlockWithPrev(TLSF, Block));
+}
+
+Rr_TLSF *Rr_CreateTLSF(size_t Reserve, size_t GrowSize)
+{
+    Rr_Arena *Arena = Rr_CreateArena(Reserve, RR_ARENA_COMMIT_DEFAULT, 0);
+
+    Rr_TLSF *TLSF = RR_ALLOC_TYPE(Arena, Rr_TLSF);
+    TLSF->Arena = Arena;
+    TLSF->GrowSize = GrowSize;
+    TLSF->Sentinel = Rr_AllocArenaNoZero(
+        Arena,
+        RR_TLSF_HEADER_SIZE,
+        RR_TLSF_ALIGNMENT,
+        1);
+    *TLSF->Sentinel = (Rr_TLSFBlock){ 0 };
+
+    return TLSF;
+}
+
+Rr_TLSF *Rr_CreateDefaultTLSF(void)
+{
+    return Rr_CreateTLSF(RR_ARENA_RESERVE_DEFAULT, RR_TLSF_GROW_DEFAULT);
+}
+
+void Rr_DestroyTLSF(Rr_TLSF *TLSF)
+{
+    if(TLSF == NULL)
+    {
+        return;
+    }
+    Rr_DestroyArena(TLSF->Arena);
+}
+
+void *Rr_AllocTLSF(Rr_TLSF *TLSF, size_t Size)
+{
+    if(Size == 0)
+    {
+        RR_LOG("Allocating 0 bytes from a TLSF heap!");
+        return NULL;
+    }
+
+    Size = RR_ALIGN_POW2(Size, RR_TLSF_ALIGNMENT);
+    Size = RR_MAX(Size, RR_TLSF_MIN_BLOCK_SIZE);
+
+    Rr_TLSFBlock *Block = Rr_FindTLSFBlock(TLSF, Size);
+    if(Block == NULL)
+    {
+        Rr_GrowTLSF(TLSF, Size);
+        Block = Rr_FindTLSFBlock(TLSF, Size);
+        if(Block == NULL)
+        {
+            RR_ABORT("TLSF heap is out of memory!");
+        }
+    }
+
+    /* Return the tail to the heap when it can hold a block. */
+
+    size_t BlockSize = Rr_GetTLSFBlockSize(Block);
+    if(BlockSize >= Size + RR_TLSF_HEADER_SIZE + RR_TLSF_MIN_BLOCK_SIZE)
+    {
+        Block->Size -= BlockSize - Size;
+
+        Rr_TLSFBlock *Remainder = Rr_GetNextTLSFBlock(Block);
+        Remainder->Size = (BlockSize - Size - RR_TLSF_HEADER_SIZE) |
+                          RR_TLSF_BLOCK_FREE_BIT;
+        Rr_GetNextTLSFBlock(Remainder)->PrevPhysical = Remainder;
+        Rr_InsertTLSFBlock(TLSF, Remainder);
+    }
+    else
+    {
+        Rr_GetNextTLSFBlock(Block)->Size &= ~RR_TLSF_BLOCK_PREV_FREE_BIT;
+    }
+
+    Block->Size &= ~RR_TLSF_BLOCK_FREE_BIT;
+
+    return (char *)Block + RR_TLSF_HEADER_SIZE;
+}
+
+void Rr_FreeTLSF(Rr_TLSF *TLSF, void *Data)
+{
+    if(Data == NULL)
+    {
+        return;
+    }
+
+    Rr_TLSFBlock *Block =
+        (Rr_TLSFBlock *)((char *)Data - RR_TLSF_HEADER_SIZE);
+    if(Block->Size & RR_TLSF_BLOCK_FREE_BIT)
+    {
+        RR_ABORT("Double free of a TLSF allocation!");
+    }
+    Block->Size |= RR_TLSF_BLOCK_FREE_BIT;
+
+    Block = Rr_MergeTLSFBlockWithPrev(TLSF, Block);
+
+    Rr_TLSFBlock *Next = Rr_GetNextTLSFBlock(Block);
+    if(Next->Size & RR_TLSF_BLOCK_FREE_BIT)
+    {
+        Rr_RemoveTLSFBlock(TLSF, Next);
+        Block->Size += RR_TLSF_HEADER_SIZE + Rr_GetTLSFBlockSize(Next);
+        Next = Rr_GetNextTLSFBlock(Block);
+    }
+    Next->PrevPhysical = Block;
+    Next->Size |= RR_TLSF_BLOCK_PREV_FREE_BIT;
+
+    Rr_InsertTLSFBlock(TLSF, Block);
+}
+
+size_t Rr_GetTLSFAllocationSize(void *Data)
+{
+    return Rr_GetTLSFBlockSize(
+        (Rr_TLSFBlock *)((char *)Data - RR_TLSF_HEADER_SIZE));
+}
@@ -1,7 +1,11 @@
 #include "Rr_Pipeline.h"
 
+#include "Rr_Log.h"
 #include "Rr_Renderer.h"
 
+#include <SDL3/SDL_filesystem.h>
+#include <SDL3/SDL_iostream.h>
+
 #include <assert.h>
 
 #include <xxHash/xxhash.h>
@@ -59,7 +63,7 @@ Rr_PipelineLayout *Rr_CreatePipelineLayout(
     Rr_Device *Device = &Renderer->Device;
 
     Rr_PipelineLayout *PipelineLayout =
-        RR_GET_FREE_LIST_ITEM(&Renderer->PipelineLayouts, Renderer->Arena);
+        RR_ALLOC_POOL_ITEM(&Renderer->PipelineLayouts, Renderer->Arena);
     PipelineLayout->SetLayoutCount = SetCount;
 
     VkDescriptorSetLayout Handles[RR_MAX_SETS] = { 0 };
@@ -88,20 +92,118 @@ Rr_PipelineLayout *Rr_CreatePipelineLayout(
         NULL,
         &PipelineLayout->Handle);
 
+    bool HasPushSet = false;
+    for(size_t Index = 0; Index < SetCount; ++Index)
+    {
+        Rr_DescriptorSetLayout *SetLayout = PipelineLayout->SetLayouts[Index];
+        if(SetLayout->Push == false)
+        {
+            continue;
+        }
+        if(HasPushSet)
+        {
+            RR_ABORT("Pipeline layout can only have one push set!");
+        }
+        HasPushSet = true;
+
+        if(RR_HAS_BIT(SetLayout->Set.Stages, RR_SHADER_STAGE_COMPUTE_BIT))
+        {
+            PipelineLayout->ComputePushTemplate =
+                Rr_CreatePushDescriptorTemplate(
+                    Device,
+                    &SetLayout->Set,
+                    SetLayout->Handle,
+                    PipelineLayout->Handle,
+                    Index,
+                    VK_PIPELINE_BIND_POINT_COMPUTE);
+        }
+        if(RR_HAS_BIT(
+               SetLayout->Set.Stages,
+               (RR_SHADER_STAGE_VERTEX_BIT | RR_SHADER_STAGE_FRAGMENT_BIT)))
+        {
+            PipelineLayout->GraphicsPushTemplate =
+                Rr_CreatePushDescriptorTemplate(
+                    Device,
+                    &SetLayout->Set,
+                    SetLayout->Handle,
+                    PipelineLayout->Handle,
+                    Index,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS);
+        }
+    }
+
     Rr_DestroyScratch(Scratch);
 
     return PipelineLayout;
 }
 
+Rr_PipelineLayout *Rr_CreateBindlessPipelineLayout(
+    Rr_Renderer *Renderer,
+    size_t PushConstantSize)
+{
+    assert(PushConstantSize <= RR_MAX_PUSH_CONSTANTS_SIZE);
+
+    if(Renderer->UsesBindless == false)
+    {
+        RR_LOG("Bindless pipeline layout requested without bindless mode.");
+        return NULL;
+    }
+
+    Rr_Device *Device = &Renderer->Device;
+
+    Rr_PipelineLayout *PipelineLayout =
+        RR_ALLOC_POOL_ITEM(&Renderer->PipelineLayouts, Renderer->Arena);
+    PipelineLayout->Bindless = true;
+    PipelineLayout->PushConstantSize = PushConstantSize;
+
+    VkPushConstantRange PushConstantRange = {
+        .stageFlags = VK_SHADER_STAGE_ALL,
+        .offset = 0,
+        .size = PushConstantSize,
+    };
+
+    VkPipelineLayoutCreateInfo PipelineLayoutCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext = NULL,
+        .setLayoutCount = 1,
+        .pSetLayouts = &Renderer->Bindless.Layout,
+        .pushConstantRangeCount = PushConstantSize > 0 ? 1 : 0,
+        .pPushConstantRanges = &PushConstantRange,
+    };
+
+    Device->CreatePipelineLayout(
+        Device->Handle,
+        &PipelineLayoutCreateInfo,
+        NULL,
+        &PipelineLayout->Handle);
+
+    return PipelineLayout;
+}
+
 void Rr_DestroyPipelineLayout(
     Rr_Renderer *Renderer,
     Rr_PipelineLayout *PipelineLayout)
 {
     Rr_Device *Device = &Renderer->Device;
 
+    if(PipelineLayout->GraphicsPushTemplate != VK_NULL_HANDLE)
+    {
+        Device->DestroyDescriptorUpdateTemplate(
+            Device->Handle,
+            PipelineLayout->GraphicsPushTemplate,
+            NULL);
+    }
+    if(PipelineLayout->ComputePushTemplate != VK_NULL_HANDLE)
+    {
+        Device->DestroyDescriptorUpdateTemplate(
+            Device->Handle,
+            PipelineLayout->ComputePushTemplate,
+            NULL);
+    }
+
     Device->DestroyPipelineLayout(Device->Handle, PipelineLayout->Handle, NULL);
 
-    RR_RETURN_FREE_LIST_ITEM(&Renderer->PipelineLayouts, PipelineLayout);
+    RR_FREE_POOL_ITEM(&Renderer->PipelineLayouts, PipelineLayout);
 }
 
 static VkSpecializationInfo *Rr_GetVulkanSpecializationInfo(
@@ -144,9 +246,190 @@ static VkSpecializationInfo *Rr_GetVulkanSpecializationInfo(
     return SpecializationInfo;
 }
 
-Rr_ComputePipeline *Rr_CreateComputePipeline(
+static void Rr_CompilePipelineJob(Rr_Renderer *Renderer, Rr_PipelineJob *Job)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    VkResult Result;
+    if(Job->GraphicsCreateInfo != NULL)
+    {
+        Result = Device->CreateGraphicsPipelines(
+            Device->Handle,
+            Renderer->PipelineCache,
+            1,
+            Job->GraphicsCreateInfo,
+            NULL,
+            Job->Handle);
+    }
+    else
+    {
+        Result = Device->CreateComputePipelines(
+            Device->Handle,
+            Renderer->PipelineCache,
+            1,
+            Job->ComputeCreateInfo,
+            NULL,
+            Job->Handle);
+    }
+    if(Result != VK_SUCCESS)
+    {
+        RR_LOG("Failed to compile pipeline, VkResult %d.", Result);
+        *Job->Handle = VK_NULL_HANDLE;
+    }
+
+    for(size_t Index = 0; Index < Job->ShaderModuleCount; ++Index)
+    {
+        Device->DestroyShaderModule(
+            Device->Handle,
+            Job->ShaderModules[Index],
+            NULL);
+    }
+
+    Rr_SetAtomicInt(Job->Ready, 1);
+}
+
+static int SDLCALL Rr_PipelineCompilerThreadProc(void *UserData)
+{
+    Rr_Renderer *Renderer = UserData;
+    Rr_PipelineCompiler *Compiler = &Renderer->PipelineCompiler;
+
+    SDL_LockMutex(Compiler->Mutex);
+    while(true)
+    {
+        Rr_PipelineJob *Job = Compiler->FirstJob;
+        if(Job == NULL)
+        {
+            if(Compiler->ExitRequested)
+            {
+                break;
+            }
+            SDL_WaitCondition(Compiler->JobCondition, Compiler->Mutex);
+            continue;
+        }
+        Compiler->FirstJob = Job->Next;
+        if(Compiler->FirstJob == NULL)
+        {
+            Compiler->LastJob = NULL;
+        }
+        SDL_UnlockMutex(Compiler->Mutex);
+
+        Rr_CompilePipelineJob(Renderer, Job);
+        Rr_DestroyArena(Job->Arena);
+
+        SDL_LockMutex(Compiler->Mutex);
+        SDL_BroadcastCondition(Compiler->DoneCondition);
+    }
+    SDL_UnlockMutex(Compiler->Mutex);
+
+    return 0;
+}
+
+void Rr_InitPipelineCompiler(Rr_Renderer *Renderer, size_t Count)
+{
+    Rr_PipelineCompiler *Compiler = &Renderer->PipelineCompiler;
+
+    Count = RR_MIN(Count, RR_MAX_COMPILER_THREADS);
+    if(Count == 0)
+    {
+        return;
+    }
+
+    Compiler->ThreadCount = Count;
+    Compiler->Mutex = SDL_CreateMutex();
+    Compiler->JobCondition = SDL_CreateCondition();
+    Compiler->DoneCondition = SDL_CreateCondition();
+
+    for(size_t Index = 0; Index < Compiler->ThreadCount; ++Index)
+    {
+        Compiler->Threads[Index] = SDL_CreateThread(
+            Rr_PipelineCompilerThreadProc,
+            "pct",
+            Renderer);
+    }
+}
+
+void Rr_CleanupPipelineCompiler(Rr_Renderer *Renderer)
+{
+    Rr_PipelineCompiler *Compiler = &Renderer->PipelineCompiler;
+
+    if(Compiler->ThreadCount == 0)
+    {
+        return;
+    }
+
+    /* Queued jobs are still compiled so their results end up in the
+     * pipeline cache saved afterwards. */
+
+    SDL_LockMutex(Compiler->Mutex);
+    Compiler->ExitRequested = true;
+    SDL_BroadcastCondition(Compiler->JobCondition);
+    SDL_UnlockMutex(Compiler->Mutex);
+
+    for(size_t Index = 0; Index < Compiler->ThreadCount; ++Index)
+    {
+        SDL_WaitThread(Compiler->Threads[Index], NULL);
+    }
+
+    SDL_DestroyCondition(Compiler->DoneCondition);
+    SDL_DestroyCondition(Compiler->JobCondition);
+    SDL_DestroyMutex(Compiler->Mutex);
+}
+
+static void Rr_EnqueuePipelineJob(Rr_Renderer *Renderer, Rr_PipelineJob *Job)
+{
+    Rr_PipelineCompiler *Compiler = &Renderer->PipelineCompiler;
+
+    if(Compiler->ThreadCount == 0)
+    {
+        Rr_CompilePipelineJob(Renderer, Job);
+        Rr_DestroyArena(Job->Arena);
+        return;
+    }
+
+    SDL_LockMutex(Compiler->Mutex);
+    if(Compiler->LastJob != NULL)
+    {
+        Compiler->LastJob->Next = Job;
+    }
+    else
+    {
+        Compiler->FirstJob = Job;
+    }
+    Compiler->LastJob = Job;
+    SDL_SignalCondition(Compiler->JobCondition);
+    SDL_UnlockMutex(Compiler->Mutex);
+}
+
+static void Rr_WaitForPipelineJob(Rr_Renderer *Renderer, Rr_AtomicInt *Ready)
+{
+    Rr_PipelineCompiler *Compiler = &Renderer->PipelineCompiler;
+
+    if(Rr_GetAtomicInt(Ready) != 0)
+    {
+        return;
+    }
+
+    SDL_LockMutex(Compiler->Mutex);
+    while(Rr_GetAtomicInt(Ready) == 0)
+    {
+        SDL_WaitCondition(Compiler->DoneCondition, Compiler->Mutex);
+    }
+    SDL_UnlockMutex(Compiler->Mutex);
+}
+
+static Rr_Arena *Rr_CreatePipelineJobArena(void)
+{
+    return Rr_CreateArena(
+        RR_PIPELINE_JOB_ARENA_SIZE,
+        RR_PIPELINE_JOB_ARENA_SIZE,
+        0);
+}
+
+static Rr_PipelineJob *Rr_BuildComputePipelineJob(
     Rr_Renderer *Renderer,
-    Rr_ComputePipelineCreateInfo *CreateInfo)
+    Rr_ComputePipelineCreateInfo *CreateInfo,
+    Rr_ComputePipeline *Pipeline,
+    Rr_Arena *Arena)
 {
     assert(CreateInfo);
     assert(CreateInfo->Layout != NULL);
@@ -154,14 +437,15 @@ Rr_ComputePipeline *Rr_CreateComputePipeline(
         CreateInfo->SpecializationCount == 0 ||
         CreateInfo->Specializations != NULL);
 
-    Rr_Scratch Scratch = Rr_GetScratch(NULL);
-
     Rr_Device *Device = &Renderer->Device;
 
-    Rr_ComputePipeline *Pipeline =
-        RR_GET_FREE_LIST_ITEM(&Renderer->ComputePipelines, Renderer->Arena);
     Pipeline->Layout = CreateInfo->Layout;
 
+    Rr_PipelineJob *Job = RR_ALLOC_TYPE(Arena, Rr_PipelineJob);
+    Job->Handle = &Pipeline->Handle;
+    Job->Ready = &Pipeline->Ready;
+    Job->Arena = Arena;
+
     VkShaderModuleCreateInfo ShaderModuleCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
         .codeSize = CreateInfo->ShaderSPV.Size,
@@ -175,6 +459,7 @@ Rr_ComputePipeline *Rr_CreateComputePipeline(
         &ShaderModuleCreateInfo,
         NULL,
         &ShaderModule);
+    Job->ShaderModules[Job->ShaderModuleCount++] = ShaderModule;
 
     VkPipelineShaderStageCreateInfo ShaderStageCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -189,56 +474,93 @@ Rr_ComputePipeline *Rr_CreateComputePipeline(
             Rr_GetVulkanSpecializationInfo(
                 CreateInfo->SpecializationCount,
                 CreateInfo->Specializations,
-                Scratch.Arena);
+                Arena);
     }
 
-    VkComputePipelineCreateInfo PipelineCreateInfo = {
+    Job->ComputeCreateInfo = RR_ALLOC_TYPE(Arena, VkComputePipelineCreateInfo);
+    *Job->ComputeCreateInfo = (VkComputePipelineCreateInfo){
         .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
         .layout = CreateInfo->Layout->Handle,
         .stage = ShaderStageCreateInfo,
     };
 
-    Device->CreateComputePipelines(
-        Device->Handle,
-        VK_NULL_HANDLE,
-        1,
-        &PipelineCreateInfo,
-        NULL,
-        &Pipeline->Handle);
+    return Job;
+}
+
+Rr_ComputePipeline *Rr_CreateComputePipeline(
+    Rr_Renderer *Renderer,
+    Rr_ComputePipelineCreateInfo *CreateInfo)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(NULL);
+
+    Rr_ComputePipeline *Pipeline =
+        RR_ALLOC_POOL_ITEM(&Renderer->ComputePipelines, Renderer->Arena);
 
-    Device->DestroyShaderModule(Device->Handle, ShaderModule, NULL);
+    Rr_PipelineJob *Job = Rr_BuildComputePipelineJob(
+        Renderer,
+        CreateInfo,
+        Pipeline,
+        Scratch.Arena);
+    Rr_CompilePipelineJob(Renderer, Job);
 
     Rr_DestroyScratch(Scratch);
 
     return Pipeline;
 }
 
+Rr_ComputePipeline *Rr_CreateComputePipelineAsync(
+    Rr_Renderer *Renderer,
+    Rr_ComputePipelineCreateInfo *CreateInfo)
+{
+    Rr_ComputePipeline *Pipeline =
+        RR_ALLOC_POOL_ITEM(&Renderer->ComputePipelines, Renderer->Arena);
+
+    Rr_PipelineJob *Job = Rr_BuildComputePipelineJob(
+        Renderer,
+        CreateInfo,
+        Pipeline,
+        Rr_CreatePipelineJobArena());
+    Rr_EnqueuePipelineJob(Renderer, Job);
+
+    return Pipeline;
+}
+
+bool Rr_IsComputePipelineReady(Rr_ComputePipeline *ComputePipeline)
+{
+    return Rr_GetAtomicInt(&ComputePipeline->Ready) != 0 &&
+           ComputePipeline->Handle != VK_NULL_HANDLE;
+}
+
 void Rr_DestroyComputePipeline(
     Rr_Renderer *Renderer,
     Rr_ComputePipeline *ComputePipeline)
 {
     Rr_Device *Device = &Renderer->Device;
 
+    Rr_WaitForPipelineJob(Renderer, &ComputePipeline->Ready);
+
     Device->DestroyPipeline(Device->Handle, ComputePipeline->Handle, NULL);
 
-    RR_RETURN_FREE_LIST_ITEM(&Renderer->ComputePipelines, ComputePipeline);
+    RR_FREE_POOL_ITEM(&Renderer->ComputePipelines, ComputePipeline);
 }
 
-Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
+static Rr_PipelineJob *Rr_BuildGraphicsPipelineJob(
     Rr_Renderer *Renderer,
-    Rr_GraphicsPipelineCreateInfo *Info)
+    Rr_GraphicsPipelineCreateInfo *Info,
+    Rr_GraphicsPipeline *Pipeline,
+    Rr_Arena *Arena)
 {
-    Rr_Scratch Scratch = Rr_GetScratch(NULL);
-
     Rr_Device *Device = &Renderer->Device;
 
-    Rr_GraphicsPipeline *Pipeline =
-        RR_GET_FREE_LIST_ITEM(&Renderer->GraphicsPipelines, Renderer->Arena);
     Pipeline->Layout = Info->Layout;
 
+    Rr_PipelineJob *Job = RR_ALLOC_TYPE(Arena, Rr_PipelineJob);
+    Job->Handle = &Pipeline->Handle;
+    Job->Ready = &Pipeline->Ready;
+    Job->Arena = Arena;
+
     RR_SLICE(VkPipelineShaderStageCreateInfo) ShaderStages = { 0 };
 
-    VkShaderModule VertModule = VK_NULL_HANDLE;
     if(Info->VertexShaderSPV.Pointer != NULL)
     {
         VkShaderModuleCreateInfo ShaderModuleCreateInfo = {
@@ -247,13 +569,15 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
             .codeSize = Info->VertexShaderSPV.Size,
             .pCode = (uint32_t *)Info->VertexShaderSPV.Pointer,
         };
+        VkShaderModule VertModule = VK_NULL_HANDLE;
         Device->CreateShaderModule(
             Device->Handle,
             &ShaderModuleCreateInfo,
             NULL,
             &VertModule);
+        Job->ShaderModules[Job->ShaderModuleCount++] = VertModule;
 
-        *RR_PUSH_SLICE(&ShaderStages, Scratch.Arena) =
+        *RR_PUSH_SLICE(&ShaderStages, Arena) =
             (VkPipelineShaderStageCreateInfo){
                 .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                 .pNext = NULL,
@@ -263,7 +587,6 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
             };
     }
 
-    VkShaderModule FragModule = VK_NULL_HANDLE;
     if(Info->FragmentShaderSPV.Pointer != NULL)
     {
         VkShaderModuleCreateInfo ShaderModuleCreateInfo = {
@@ -272,12 +595,15 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
             .codeSize = Info->FragmentShaderSPV.Size,
             .pCode = (uint32_t *)Info->FragmentShaderSPV.Pointer,
         };
+        VkShaderModule FragModule = VK_NULL_HANDLE;
         Device->CreateShaderModule(
             Device->Handle,
             &ShaderModuleCreateInfo,
             NULL,
             &FragModule);
-        *RR_PUSH_SLICE(&ShaderStages, Scratch.Arena) =
+        Job->ShaderModules[Job->ShaderModuleCount++] = FragModule;
+
+        *RR_PUSH_SLICE(&ShaderStages, Arena) =
             (VkPipelineShaderStageCreateInfo){
                 .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                 .pNext = NULL,
@@ -298,7 +624,7 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
         RR_RESERVE_SLICE(
             &AttributeDescriptions,
             AttributeDescriptions.Count + VertexInputBinding->AttributeCount,
-            Scratch.Arena);
+            Arena);
 
         for(size_t Index = 0; Index < VertexInputBinding->AttributeCount;
             ++Index)
@@ -307,7 +633,7 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
                 VertexInputBinding->Attributes + Index;
 
             VkVertexInputAttributeDescription *AttributeDescription =
-                RR_PUSH_SLICE(&AttributeDescriptions, Scratch.Arena);
+                RR_PUSH_SLICE(&AttributeDescriptions, Arena);
             AttributeDescription->location = Attribute->Location;
             AttributeDescription->format =
                 Rr_GetVulkanFormat(Attribute->Format);
@@ -328,7 +654,7 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
             if(BindingDescription == NULL)
             {
                 BindingDescription =
-                    RR_PUSH_SLICE(&BindingDescriptions, Scratch.Arena);
+                    RR_PUSH_SLICE(&BindingDescriptions, Arena);
                 BindingDescription->binding = BindingIndex;
                 BindingDescription->inputRate =
                     VertexInputBinding->Rate == RR_VERTEX_INPUT_RATE_INSTANCE
@@ -341,7 +667,9 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
         }
     }
 
-    VkPipelineVertexInputStateCreateInfo VertexInputInfo = {
+    VkPipelineVertexInputStateCreateInfo *VertexInputInfo =
+        RR_ALLOC_TYPE(Arena, VkPipelineVertexInputStateCreateInfo);
+    *VertexInputInfo = (VkPipelineVertexInputStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext = NULL,
         .flags = 0,
@@ -351,21 +679,27 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
         .pVertexBindingDescriptions = BindingDescriptions.Data,
     };
 
-    VkPipelineInputAssemblyStateCreateInfo InputAssembly = {
+    VkPipelineInputAssemblyStateCreateInfo *InputAssembly =
+        RR_ALLOC_TYPE(Arena, VkPipelineInputAssemblyStateCreateInfo);
+    *InputAssembly = (VkPipelineInputAssemblyStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
         .pNext = NULL,
         .topology = Rr_GetVulkanTopology(Info->Topology),
         .primitiveRestartEnable = VK_FALSE,
     };
 
-    VkPipelineViewportStateCreateInfo ViewportInfo = {
+    VkPipelineViewportStateCreateInfo *ViewportInfo =
+        RR_ALLOC_TYPE(Arena, VkPipelineViewportStateCreateInfo);
+    *ViewportInfo = (VkPipelineViewportStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
         .pNext = NULL,
         .viewportCount = 1,
         .scissorCount = 1,
     };
 
-    VkPipelineRasterizationStateCreateInfo Rasterizer = {
+    VkPipelineRasterizationStateCreateInfo *Rasterizer =
+        RR_ALLOC_TYPE(Arena, VkPipelineRasterizationStateCreateInfo);
+    *Rasterizer = (VkPipelineRasterizationStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
         .pNext = NULL,
         .flags = 0,
@@ -381,16 +715,20 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
         .lineWidth = 1.0f,
     };
 
-    VkDynamicState DynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT,
-                                       VK_DYNAMIC_STATE_SCISSOR };
-    VkPipelineDynamicStateCreateInfo DynamicStateInfo = {
+    static VkDynamicState DynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT,
+                                              VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo *DynamicStateInfo =
+        RR_ALLOC_TYPE(Arena, VkPipelineDynamicStateCreateInfo);
+    *DynamicStateInfo = (VkPipelineDynamicStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
         .pNext = NULL,
         .pDynamicStates = DynamicStates,
         .dynamicStateCount = SDL_arraysize(DynamicStates),
     };
 
-    VkPipelineMultisampleStateCreateInfo Multisampling = {
+    VkPipelineMultisampleStateCreateInfo *Multisampling =
+        RR_ALLOC_TYPE(Arena, VkPipelineMultisampleStateCreateInfo);
+    *Multisampling = (VkPipelineMultisampleStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
         .sampleShadingEnable = VK_FALSE,
         .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
@@ -401,11 +739,11 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
     };
 
     RR_SLICE(VkPipelineColorBlendAttachmentState) ColorAttachments = { 0 };
-    RR_RESERVE_SLICE(&ColorAttachments, Info->ColorTargetCount, Scratch.Arena);
+    RR_RESERVE_SLICE(&ColorAttachments, Info->ColorTargetCount, Arena);
     for(size_t Index = 0; Index < Info->ColorTargetCount; ++Index)
     {
         VkPipelineColorBlendAttachmentState *Attachment =
-            RR_PUSH_SLICE(&ColorAttachments, Scratch.Arena);
+            RR_PUSH_SLICE(&ColorAttachments, Arena);
         Rr_ColorTargetInfo *ColorTargetInfo = Info->ColorTargets + Index;
         Rr_ColorTargetBlend *Blend = &ColorTargetInfo->Blend;
 
@@ -430,7 +768,9 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
 
     Pipeline->ColorAttachmentCount = Info->ColorTargetCount;
 
-    VkPipelineColorBlendStateCreateInfo ColorBlendInfo = {
+    VkPipelineColorBlendStateCreateInfo *ColorBlendInfo =
+        RR_ALLOC_TYPE(Arena, VkPipelineColorBlendStateCreateInfo);
+    *ColorBlendInfo = (VkPipelineColorBlendStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
         .pNext = NULL,
         .logicOpEnable = VK_FALSE,
@@ -439,7 +779,9 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
         .pAttachments = ColorAttachments.Data,
     };
 
-    VkPipelineDepthStencilStateCreateInfo DepthStencil = {
+    VkPipelineDepthStencilStateCreateInfo *DepthStencil =
+        RR_ALLOC_TYPE(Arena, VkPipelineDepthStencilStateCreateInfo);
+    *DepthStencil = (VkPipelineDepthStencilStateCreateInfo){
         .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
         .pNext = NULL,
         .flags = 0,
@@ -455,55 +797,80 @@ Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
             &Info->DepthStencil),
     };
 
-    VkGraphicsPipelineCreateInfo PipelineInfo = {
+    Job->GraphicsCreateInfo =
+        RR_ALLOC_TYPE(Arena, VkGraphicsPipelineCreateInfo);
+    *Job->GraphicsCreateInfo = (VkGraphicsPipelineCreateInfo){
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
         .pNext = NULL,
         .stageCount = ShaderStages.Count,
         .pStages = ShaderStages.Data,
-        .pVertexInputState = &VertexInputInfo,
-        .pInputAssemblyState = &InputAssembly,
-        .pViewportState = &ViewportInfo,
-        .pRasterizationState = &Rasterizer,
-        .pMultisampleState = &Multisampling,
-        .pColorBlendState = &ColorBlendInfo,
-        .pDepthStencilState = &DepthStencil,
+        .pVertexInputState = VertexInputInfo,
+        .pInputAssemblyState = InputAssembly,
+        .pViewportState = ViewportInfo,
+        .pRasterizationState = Rasterizer,
+        .pMultisampleState = Multisampling,
+        .pColorBlendState = ColorBlendInfo,
+        .pDepthStencilState = DepthStencil,
         .layout = Info->Layout->Handle,
-        .pDynamicState = &DynamicStateInfo,
+        .pDynamicState = DynamicStateInfo,
         .renderPass = Rr_GetCompatibleRenderPass(Renderer, Info),
     };
 
-    Device->CreateGraphicsPipelines(
-        Device->Handle,
-        VK_NULL_HANDLE,
-        1,
-        &PipelineInfo,
-        NULL,
-        &Pipeline->Handle);
+    return Job;
+}
 
-    if(VertModule != VK_NULL_HANDLE)
-    {
-        Device->DestroyShaderModule(Device->Handle, VertModule, NULL);
-    }
+Rr_GraphicsPipeline *Rr_CreateGraphicsPipeline(
+    Rr_Renderer *Renderer,
+    Rr_GraphicsPipelineCreateInfo *Info)
+{
+    Rr_Scratch Scratch = Rr_GetScratch(NULL);
 
-    if(FragModule != VK_NULL_HANDLE)
-    {
-        Device->DestroyShaderModule(Device->Handle, FragModule, NULL);
-    }
+    Rr_GraphicsPipeline *Pipeline =
+        RR_ALLOC_POOL_ITEM(&Renderer->GraphicsPipelines, Renderer->Arena);
+
+    Rr_PipelineJob *Job =
+        Rr_BuildGraphicsPipelineJob(Renderer, Info, Pipeline, Scratch.Arena);
+    Rr_CompilePipelineJob(Renderer, Job);
 
     Rr_DestroyScratch(Scratch);
 
     return Pipeline;
 }
 
+Rr_GraphicsPipeline *Rr_CreateGraphicsPipelineAsync(
+    Rr_Renderer *Renderer,
+    Rr_GraphicsPipelineCreateInfo *Info)
+{
+    Rr_GraphicsPipeline *Pipeline =
+        RR_ALLOC_POOL_ITEM(&Renderer->GraphicsPipelines, Renderer->Arena);
+
+    Rr_PipelineJob *Job = Rr_BuildGraphicsPipelineJob(
+        Renderer,
+        Info,
+        Pipeline,
+        Rr_CreatePipelineJobArena());
+    Rr_EnqueuePipelineJob(Renderer, Job);
+
+    return Pipeline;
+}
+
+bool Rr_IsGraphicsPipelineReady(Rr_GraphicsPipeline *GraphicsPipeline)
+{
+    return Rr_GetAtomicInt(&GraphicsPipeline->Ready) != 0 &&
+           GraphicsPipeline->Handle != VK_NULL_HANDLE;
+}
+
 void Rr_DestroyGraphicsPipeline(
     Rr_Renderer *Renderer,
     Rr_GraphicsPipeline *GraphicsPipeline)
 {
     Rr_Device *Device = &Renderer->Device;
 
+    Rr_WaitForPipelineJob(Renderer, &GraphicsPipeline->Ready);
+
     Device->DestroyPipeline(Device->Handle, GraphicsPipeline->Handle, NULL);
 
-    RR_RETURN_FREE_LIST_ITEM(&Renderer->GraphicsPipelines, GraphicsPipeline);
+    RR_FREE_POOL_ITEM(&Renderer->GraphicsPipelines, GraphicsPipeline);
 }
 
 Rr_DescriptorSetLayout *Rr_GetDescriptorSetLayout(
@@ -524,7 +891,8 @@ Rr_DescriptorSetLayout *Rr_GetDescriptorSetLayout(
         }
         if(DescriptorSetLayout->Hash == Hash &&
            DescriptorSetLayout->Set.BindingCount == Set->BindingCount &&
-           DescriptorSetLayout->Set.Stages == Set->Stages)
+           DescriptorSetLayout->Set.Stages == Set->Stages &&
+           DescriptorSetLayout->Set.Push == Set->Push)
         {
             bool Fail = false;
             for(size_t BindingIndex = 0; BindingIndex < Set->BindingCount;
@@ -550,6 +918,11 @@ Rr_DescriptorSetLayout *Rr_GetDescriptorSetLayout(
     }
 
     Rr_DescriptorLayoutBuilder DescriptorLayoutBuilder = { 0 };
+    DescriptorLayoutBuilder.Push =
+        Set->Push &&
+        Renderer->Device.CmdPushDescriptorSetWithTemplateKHR != NULL &&
+        Set->BindingCount <= Renderer->PhysicalDevice.PushDescriptorProperties
+                                 .maxPushDescriptors;
 
     for(size_t BindingIndex = 0; BindingIndex < Set->BindingCount;
         ++BindingIndex)
@@ -581,6 +954,7 @@ Rr_DescriptorSetLayout *Rr_GetDescriptorSetLayout(
         RR_PUSH_SLICE(&Renderer->DescriptorSetLayouts, Renderer->Arena);
     DescriptorSetLayout->Hash = Hash;
     DescriptorSetLayout->Set = *Set;
+    DescriptorSetLayout->Push = DescriptorLayoutBuilder.Push;
     RR_ALLOC_COPY(
         Renderer->Arena,
         DescriptorSetLayout->Set.Bindings,
@@ -591,3 +965,158 @@ Rr_DescriptorSetLayout *Rr_GetDescriptorSetLayout(
 
     return DescriptorSetLayout;
 }
+
+/* Written in front of the Vulkan cache data. Drivers are supposed to
+ * reject foreign blobs on their own, but not all of them do. */
+
+#define RR_PIPELINE_CACHE_MAGIC 0x43505252 /* "RRPC" */
+
+typedef struct Rr_PipelineCacheHeader Rr_PipelineCacheHeader;
+struct Rr_PipelineCacheHeader
+{
+    uint32_t Magic;
+    uint32_t VendorID;
+    uint32_t DeviceID;
+    uint32_t DriverVersion;
+    uint8_t UUID[VK_UUID_SIZE];
+    uint64_t DataSize;
+    uint64_t DataHash;
+};
+
+static Rr_PipelineCacheHeader Rr_GetPipelineCacheHeader(
+    Rr_Renderer *Renderer)
+{
+    VkPhysicalDeviceProperties *Properties =
+        &Renderer->PhysicalDevice.Properties.properties;
+
+    Rr_PipelineCacheHeader Header = {
+        .Magic = RR_PIPELINE_CACHE_MAGIC,
+        .VendorID = Properties->vendorID,
+        .DeviceID = Properties->deviceID,
+        .DriverVersion = Properties->driverVersion,
+    };
+    SDL_memcpy(Header.UUID, Properties->pipelineCacheUUID, VK_UUID_SIZE);
+
+    return Header;
+}
+
+void Rr_InitPipelineCache(Rr_Renderer *Renderer, const char *Path)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    size_t FileSize = 0;
+    void *File = NULL;
+    if(Path != NULL)
+    {
+        RR_ALLOC_COPY(
+            Renderer->Arena,
+            Renderer->PipelineCachePath,
+            Path,
+            SDL_strlen(Path) + 1);
+        File = SDL_LoadFile(Path, &FileSize);
+    }
+
+    VkPipelineCacheCreateInfo CreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+    };
+
+    if(File != NULL)
+    {
+        Rr_PipelineCacheHeader Expected = Rr_GetPipelineCacheHeader(Renderer);
+        Rr_PipelineCacheHeader *Header = File;
+        char *Data = (char *)File + sizeof(Rr_PipelineCacheHeader);
+
+        bool IsValid =
+            FileSize >= sizeof(Rr_PipelineCacheHeader) &&
+            Header->Magic == Expected.Magic &&
+            Header->VendorID == Expected.VendorID &&
+            Header->DeviceID == Expected.DeviceID &&
+            Header->DriverVersion == Expected.DriverVersion &&
+            SDL_memcmp(Header->UUID, Expected.UUID, VK_UUID_SIZE) == 0 &&
+            Header->DataSize == FileSize - sizeof(Rr_PipelineCacheHeader) &&
+            Header->DataHash == XXH3_64bits(Data, Header->DataSize);
+        if(IsValid)
+        {
+            CreateInfo.initialDataSize = Header->DataSize;
+            CreateInfo.pInitialData = Data;
+            RR_LOG(
+                "Loaded pipeline cache of %zu bytes.",
+                (size_t)Header->DataSize);
+        }
+        else
+        {
+            RR_LOG("Pipeline cache is stale or corrupted, discarding.");
+        }
+    }
+
+    Device->CreatePipelineCache(
+        Device->Handle,
+        &CreateInfo,
+        NULL,
+        &Renderer->PipelineCache);
+
+    SDL_free(File);
+}
+
+bool Rr_SavePipelineCache(Rr_Renderer *Renderer)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    if(Renderer->PipelineCachePath == NULL)
+    {
+        return false;
+    }
+
+    size_t DataSize = 0;
+    Device->GetPipelineCacheData(
+        Device->Handle,
+        Renderer->PipelineCache,
+        &DataSize,
+        NULL);
+
+    Rr_Scratch Scratch = Rr_GetScratch(NULL);
+
+    size_t FileSize = sizeof(Rr_PipelineCacheHeader) + DataSize;
+    char *File = RR_ALLOC_NO_ZERO(Scratch.Arena, FileSize);
+    char *Data = File + sizeof(Rr_PipelineCacheHeader);
+    Device->GetPipelineCacheData(
+        Device->Handle,
+        Renderer->PipelineCache,
+        &DataSize,
+        Data);
+
+    Rr_PipelineCacheHeader *Header = (Rr_PipelineCacheHeader *)File;
+    *Header = Rr_GetPipelineCacheHeader(Renderer);
+    Header->DataSize = DataSize;
+    Header->DataHash = XXH3_64bits(Data, DataSize);
+
+    /* Write next to the old cache and swap, a crash mid-write must not
+     * leave a truncated cache behind. */
+
+    size_t TempPathSize = SDL_strlen(Renderer->PipelineCachePath) + 5;
+    char *TempPath = RR_ALLOC_NO_ZERO(Scratch.Arena, TempPathSize);
+    SDL_snprintf(
+        TempPath,
+        TempPathSize,
+        "%s.tmp",
+        Renderer->PipelineCachePath);
+    bool Saved = SDL_SaveFile(TempPath, File, FileSize) &&
+                 SDL_RenamePath(TempPath, Renderer->PipelineCachePath);
+    if(Saved == false)
+    {
+        RR_LOG("Failed to save pipeline cache: %s", SDL_GetError());
+    }
+
+    Rr_DestroyScratch(Scratch);
+
+    return Saved;
+}
+
+void Rr_CleanupPipelineCache(Rr_Renderer *Renderer)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    Rr_SavePipelineCache(Renderer);
+
+    Device->DestroyPipelineCache(Device->Handle, Renderer->PipelineCache, NULL);
+}
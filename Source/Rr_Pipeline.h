@@ -7,25 +7,44 @@
 
 #include <Rr/Rr_Platform.h>
 
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+
 typedef struct Rr_DescriptorSetLayout Rr_DescriptorSetLayout;
+/* Push is only set when the device supports pushing the set. */
+
 struct Rr_DescriptorSetLayout
 {
     Rr_PipelineBindingSet Set;
     VkDescriptorSetLayout Handle;
     uint32_t Hash;
+    bool Push;
 };
 
+/* Bindless layouts have the global set as set 0 and a push constant
+ * range visible to all stages, SetLayoutCount is zero for them. */
+
 struct Rr_PipelineLayout
 {
     VkPipelineLayout Handle;
     size_t SetLayoutCount;
     Rr_DescriptorSetLayout *SetLayouts[RR_MAX_SETS];
+    bool Bindless;
+    uint32_t PushConstantSize;
+
+    /* Templates for the push set, per bind point its stages use. */
+    VkDescriptorUpdateTemplate GraphicsPushTemplate;
+    VkDescriptorUpdateTemplate ComputePushTemplate;
 };
 
+/* Ready is set once compilation finished, Handle stays null if it
+ * failed. */
+
 struct Rr_ComputePipeline
 {
     VkPipeline Handle;
     Rr_PipelineLayout *Layout;
+    Rr_AtomicInt Ready;
 };
 
 struct Rr_GraphicsPipeline
@@ -33,8 +52,46 @@ struct Rr_GraphicsPipeline
     VkPipeline Handle;
     uint32_t ColorAttachmentCount;
     Rr_PipelineLayout *Layout;
+    Rr_AtomicInt Ready;
+};
+
+/* Everything the create info points to lives in Arena, which async
+ * jobs own and destroy after compiling. */
+
+typedef struct Rr_PipelineJob Rr_PipelineJob;
+struct Rr_PipelineJob
+{
+    VkGraphicsPipelineCreateInfo *GraphicsCreateInfo;
+    VkComputePipelineCreateInfo *ComputeCreateInfo;
+    VkShaderModule ShaderModules[2];
+    size_t ShaderModuleCount;
+    VkPipeline *Handle;
+    Rr_AtomicInt *Ready;
+    Rr_Arena *Arena;
+    Rr_PipelineJob *Next;
+};
+
+typedef struct Rr_PipelineCompiler Rr_PipelineCompiler;
+struct Rr_PipelineCompiler
+{
+    SDL_Thread *Threads[RR_MAX_COMPILER_THREADS];
+    size_t ThreadCount;
+    SDL_Mutex *Mutex;
+    SDL_Condition *JobCondition;
+    SDL_Condition *DoneCondition;
+    Rr_PipelineJob *FirstJob;
+    Rr_PipelineJob *LastJob;
+    bool ExitRequested;
 };
 
 extern Rr_DescriptorSetLayout *Rr_GetDescriptorSetLayout(
     Rr_Renderer *Renderer,
     Rr_PipelineBindingSet *Set);
+
+extern void Rr_InitPipelineCache(Rr_Renderer *Renderer, const char *Path);
+
+extern void Rr_CleanupPipelineCache(Rr_Renderer *Renderer);
+
+extern void Rr_InitPipelineCompiler(Rr_Renderer *Renderer, size_t Count);
+
+extern void Rr_CleanupPipelineCompiler(Rr_Renderer *Renderer);
@@ -52,6 +52,53 @@ void Rr_SetSwapchainDirty(Rr_Renderer *Renderer, bool Dirty)
     Rr_SetAtomicInt(&Renderer->Swapchain.RecreatePending, Dirty);
 }
 
+static void Rr_InitPresentPipeline(Rr_Renderer *Renderer)
+{
+    if(Renderer->PresentRenderPass != VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    Rr_PipelineBinding PipelineBinding = {
+        .Binding = 0,
+        .Count = 1,
+        .Type = RR_PIPELINE_BINDING_TYPE_COMBINED_IMAGE_SAMPLER,
+    };
+    Rr_PipelineBindingSet PipelineBindingSet = {
+        .BindingCount = 1,
+        .Bindings = &PipelineBinding,
+        .Stages = RR_SHADER_STAGE_FRAGMENT_BIT,
+        .Push = true,
+    };
+    Renderer->PresentLayout =
+        Rr_CreatePipelineLayout(Renderer, 1, &PipelineBindingSet);
+
+    Rr_ColorTargetInfo ColorTargets[1] = { 0 };
+    ColorTargets[0].Blend.ColorWriteMask = RR_COLOR_COMPONENT_ALL;
+    ColorTargets[0].Format = Rr_GetSwapchainFormat(Renderer);
+
+    Rr_GraphicsPipelineCreateInfo PipelineInfo = { 0 };
+    PipelineInfo.Rasterizer.CullMode = RR_CULL_MODE_NONE;
+    PipelineInfo.Rasterizer.FrontFace = RR_FRONT_FACE_CLOCKWISE;
+    PipelineInfo.Layout = Renderer->PresentLayout;
+    PipelineInfo.VertexShaderSPV = Rr_LoadAsset(RR_BUILTIN_PRESENT_VERT_SPV);
+    PipelineInfo.FragmentShaderSPV = Rr_LoadAsset(RR_BUILTIN_PRESENT_FRAG_SPV);
+    PipelineInfo.ColorTargetCount = 1;
+    PipelineInfo.ColorTargets = ColorTargets;
+
+    Renderer->PresentPipeline =
+        Rr_CreateGraphicsPipeline(Renderer, &PipelineInfo);
+
+    Rr_RenderPassAttachment Attachment = {
+        .LoadOp = RR_LOAD_OP_CLEAR,
+        .StoreOp = RR_STORE_OP_STORE,
+        .Format = Renderer->Swapchain.Format,
+    };
+    Rr_RenderPassInfo RenderPassInfo = { .AttachmentCount = 1,
+                                         .Attachments = &Attachment };
+    Renderer->PresentRenderPass = Rr_GetRenderPass(Renderer, &RenderPassInfo);
+}
+
 static bool Rr_InitSwapchain(
     Rr_Renderer *Renderer,
     uint32_t *Width,
@@ -272,49 +319,7 @@ static bool Rr_InitSwapchain(
 
     /* Initialize Present Pipeline If Needed */
 
-    if(Renderer->PresentRenderPass == VK_NULL_HANDLE)
-    {
-        Rr_PipelineBinding PipelineBinding = {
-            .Binding = 0,
-            .Count = 1,
-            .Type = RR_PIPELINE_BINDING_TYPE_COMBINED_IMAGE_SAMPLER,
-        };
-        Rr_PipelineBindingSet PipelineBindingSet = {
-            .BindingCount = 1,
-            .Bindings = &PipelineBinding,
-            .Stages = RR_SHADER_STAGE_FRAGMENT_BIT,
-        };
-        Renderer->PresentLayout =
-            Rr_CreatePipelineLayout(Renderer, 1, &PipelineBindingSet);
-
-        Rr_ColorTargetInfo ColorTargets[1] = { 0 };
-        ColorTargets[0].Blend.ColorWriteMask = RR_COLOR_COMPONENT_ALL;
-        ColorTargets[0].Format = Rr_GetSwapchainFormat(Renderer);
-
-        Rr_GraphicsPipelineCreateInfo PipelineInfo = { 0 };
-        PipelineInfo.Rasterizer.CullMode = RR_CULL_MODE_NONE;
-        PipelineInfo.Rasterizer.FrontFace = RR_FRONT_FACE_CLOCKWISE;
-        PipelineInfo.Layout = Renderer->PresentLayout;
-        PipelineInfo.VertexShaderSPV =
-            Rr_LoadAsset(RR_BUILTIN_PRESENT_VERT_SPV);
-        PipelineInfo.FragmentShaderSPV =
-            Rr_LoadAsset(RR_BUILTIN_PRESENT_FRAG_SPV);
-        PipelineInfo.ColorTargetCount = 1;
-        PipelineInfo.ColorTargets = ColorTargets;
-
-        Renderer->PresentPipeline =
-            Rr_CreateGraphicsPipeline(Renderer, &PipelineInfo);
-
-        Rr_RenderPassAttachment Attachment = {
-            .LoadOp = RR_LOAD_OP_CLEAR,
-            .StoreOp = RR_STORE_OP_STORE,
-            .Format = Renderer->Swapchain.Format,
-        };
-        Rr_RenderPassInfo RenderPassInfo = { .AttachmentCount = 1,
-                                             .Attachments = &Attachment };
-        Renderer->PresentRenderPass =
-            Rr_GetRenderPass(Renderer, &RenderPassInfo);
-    }
+    Rr_InitPresentPipeline(Renderer);
 
     /* Create Framebuffers And Image Views */
 
@@ -379,6 +384,118 @@ static bool Rr_InitSwapchain(
     return true;
 }
 
+static void Rr_InitHeadlessSwapchain(
+    Rr_Renderer *Renderer,
+    uint32_t Width,
+    uint32_t Height)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    Renderer->Swapchain.Extent = (VkExtent3D){
+        .width = Width,
+        .height = Height,
+        .depth = 1,
+    };
+    Renderer->Swapchain.Format = VK_FORMAT_R8G8B8A8_UNORM;
+    Renderer->Swapchain.ColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+
+    /* One offscreen image per frame in flight, reuse is guarded
+     * by the render fence of the frame that owns the image. */
+
+    Rr_Image *OffscreenImage = Rr_CreateUnbudgetedImage(
+        Renderer,
+        (Rr_IntVec3){
+            .Width = (int32_t)Width,
+            .Height = (int32_t)Height,
+            .Depth = 1,
+        },
+        RR_TEXTURE_FORMAT_R8G8B8A8_UNORM,
+        RR_IMAGE_FLAGS_COLOR_ATTACHMENT_BIT | RR_IMAGE_FLAGS_TRANSFER_BIT |
+            RR_IMAGE_FLAGS_PER_FRAME_BIT);
+    if(OffscreenImage == NULL)
+    {
+        RR_ABORT("Failed to create offscreen image!");
+    }
+    Renderer->Swapchain.OffscreenImage = OffscreenImage;
+
+    Rr_InitPresentPipeline(Renderer);
+
+    size_t ImageCount = OffscreenImage->AllocatedImageCount;
+    RR_RESERVE_SLICE(&Renderer->Swapchain.Images, ImageCount, Renderer->Arena);
+    Renderer->Swapchain.Images.Count = ImageCount;
+
+    VkFramebufferCreateInfo FramebufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+        .attachmentCount = 1,
+        .width = Width,
+        .height = Height,
+        .layers = 1,
+        .renderPass = Renderer->PresentRenderPass,
+    };
+
+    for(size_t Index = 0; Index < ImageCount; Index++)
+    {
+        Rr_SwapchainImage *Image = Renderer->Swapchain.Images.Data + Index;
+        Rr_AllocatedImage *AllocatedImage =
+            OffscreenImage->AllocatedImages + Index;
+
+        Image->Handle = AllocatedImage->Handle;
+        Image->View = AllocatedImage->View;
+
+        FramebufferCreateInfo.pAttachments = &Image->View;
+        Device->CreateFramebuffer(
+            Device->Handle,
+            &FramebufferCreateInfo,
+            NULL,
+            &Image->Framebuffer);
+
+        Rr_SyncState *SyncState =
+            Rr_GetSynchronizationState(Renderer, (Rr_MapKey)Image->Handle);
+        SyncState->StageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+}
+
+static void Rr_CleanupHeadlessSwapchain(Rr_Renderer *Renderer)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    for(size_t Index = 0; Index < Renderer->Swapchain.Images.Count; Index++)
+    {
+        Rr_SwapchainImage *Image = Renderer->Swapchain.Images.Data + Index;
+
+        Device->DestroyFramebuffer(Device->Handle, Image->Framebuffer, NULL);
+
+        Rr_ReturnSynchronizationState(Renderer, (Rr_MapKey)Image->Handle);
+    }
+
+    /* Image views are owned by the offscreen image. */
+
+    Rr_DestroyImage(Renderer, Renderer->Swapchain.OffscreenImage);
+}
+
+static Rr_DescriptorAllocator Rr_CreateFrameDescriptorAllocator(
+    Rr_Device *Device,
+    Rr_Arena *Arena)
+{
+    Rr_DescriptorPoolSizeRatio Ratios[] = {
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 32 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 32 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 32 },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 32 },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 32 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 32 },
+        { VK_DESCRIPTOR_TYPE_SAMPLER, 32 },
+        { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 32 },
+    };
+
+    return Rr_CreateDescriptorAllocator(
+        Device,
+        1024,
+        Ratios,
+        RR_ARRAY_COUNT(Ratios),
+        Arena);
+}
+
 static void Rr_InitFrames(Rr_Renderer *Renderer)
 {
     Rr_Device *Device = &Renderer->Device;
@@ -455,26 +572,52 @@ static void Rr_InitFrames(Rr_Renderer *Renderer)
             NULL,
             &Frame->LateSemaphore);
 
+        /* Async Compute */
+
+        if(Rr_IsUsingComputeQueue(Renderer))
+        {
+            VkCommandPoolCreateInfo ComputeCommandPoolCreateInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .pNext = VK_NULL_HANDLE,
+                .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                .queueFamilyIndex = Renderer->ComputeQueue.FamilyIndex,
+            };
+            Device->CreateCommandPool(
+                Device->Handle,
+                &ComputeCommandPoolCreateInfo,
+                NULL,
+                &Frame->ComputeCommandPool);
+
+            CommandBufferAllocateInfo.commandPool = Frame->ComputeCommandPool;
+            Device->AllocateCommandBuffers(
+                Device->Handle,
+                &CommandBufferAllocateInfo,
+                &Frame->ComputeCommandBuffer);
+
+            Device->CreateSemaphore(
+                Device->Handle,
+                &SemaphoreCreateInfo,
+                NULL,
+                &Frame->ComputeSemaphore);
+            Device->CreateSemaphore(
+                Device->Handle,
+                &SemaphoreCreateInfo,
+                NULL,
+                &Frame->ReleaseSemaphore);
+        }
+
         /* Descriptor Allocator */
 
-        Rr_DescriptorPoolSizeRatio Ratios[] = {
-            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 32 },
-            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 32 },
-            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 32 },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 32 },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 32 },
-            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 32 },
-            { VK_DESCRIPTOR_TYPE_SAMPLER, 32 },
-            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 32 },
-        };
-        Frame->DescriptorAllocator = Rr_CreateDescriptorAllocator(
-            Device,
-            1024,
-            Ratios,
-            RR_ARRAY_COUNT(Ratios),
-            Renderer->Arena);
+        Frame->DescriptorAllocator =
+            Rr_CreateFrameDescriptorAllocator(Device, Renderer->Arena);
 
-        Frame->Arena = Rr_CreateDefaultArena();
+        Frame->Arena = Rr_CreateArena(
+            RR_ARENA_RESERVE_DEFAULT,
+            RR_PER_FRAME_ARENA_SIZE,
+            RR_ARENA_FLAGS_HUGE_PAGES_BIT | RR_ARENA_FLAGS_PREFAULT_BIT);
+        Rr_SetArenaDecommitWindow(
+            Frame->Arena,
+            RR_FRAME_ARENA_DECOMMIT_WINDOW);
     }
 }
 
@@ -496,12 +639,149 @@ static void Rr_CleanupFrames(Rr_Renderer *Renderer)
             Frame->SwapchainSemaphore,
             NULL);
 
+        if(Rr_IsUsingComputeQueue(Renderer))
+        {
+            Device->DestroyCommandPool(
+                Device->Handle,
+                Frame->ComputeCommandPool,
+                NULL);
+            Device->DestroySemaphore(
+                Device->Handle,
+                Frame->ComputeSemaphore,
+                NULL);
+            Device->DestroySemaphore(
+                Device->Handle,
+                Frame->ReleaseSemaphore,
+                NULL);
+        }
+
+        for(size_t EventIndex = 0; EventIndex < Frame->Events.Count;
+            ++EventIndex)
+        {
+            Device->DestroyEvent(
+                Device->Handle,
+                Frame->Events.Data[EventIndex],
+                NULL);
+        }
+
         Rr_DestroyDescriptorAllocator(&Frame->DescriptorAllocator, Device);
 
+        Rr_DestroyTransientHeap(Renderer, &Frame->TransientHeap);
+
         Rr_DestroyArena(Frame->Arena);
     }
 }
 
+static void Rr_InitRecordingThreads(Rr_Renderer *Renderer, size_t Count)
+{
+    Rr_Device *Device = &Renderer->Device;
+    Rr_RecordingThreads *Threads = &Renderer->RecordingThreads;
+
+    Count = RR_MIN(Count, RR_MAX_RECORDING_THREADS);
+    if(Count == 0)
+    {
+        return;
+    }
+
+    Threads->Threads =
+        RR_ALLOC_TYPE_COUNT(Renderer->Arena, Rr_RecordingThread, Count);
+    Threads->Count = Count;
+    Threads->DoneSemaphore = SDL_CreateSemaphore(0);
+
+    for(size_t Index = 0; Index < Count; ++Index)
+    {
+        Rr_RecordingThread *Thread = Threads->Threads + Index;
+        Thread->Renderer = Renderer;
+        Thread->Arena = Rr_CreateDefaultArena();
+        Thread->Semaphore = SDL_CreateSemaphore(0);
+
+        /* Each thread owns a command pool and a descriptor allocator
+         * per frame so recording never needs to lock. */
+
+        for(size_t FrameIndex = 0; FrameIndex < RR_FRAME_OVERLAP; ++FrameIndex)
+        {
+            Rr_RecordingContext *Context = Thread->Contexts + FrameIndex;
+
+            VkCommandPoolCreateInfo CommandPoolCreateInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .pNext = VK_NULL_HANDLE,
+                .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                .queueFamilyIndex = Renderer->GraphicsQueue.FamilyIndex,
+            };
+            Device->CreateCommandPool(
+                Device->Handle,
+                &CommandPoolCreateInfo,
+                NULL,
+                &Context->CommandPool);
+
+            Context->DescriptorAllocator =
+                Rr_CreateFrameDescriptorAllocator(Device, Thread->Arena);
+        }
+
+        Thread->Handle =
+            SDL_CreateThread(Rr_RecordingThreadProc, "rt", Thread);
+    }
+}
+
+static void Rr_ResetRecordingThreads(Rr_Renderer *Renderer)
+{
+    Rr_Device *Device = &Renderer->Device;
+    Rr_RecordingThreads *Threads = &Renderer->RecordingThreads;
+
+    for(size_t Index = 0; Index < Threads->Count; ++Index)
+    {
+        Rr_RecordingContext *Context =
+            Threads->Threads[Index].Contexts + Renderer->CurrentFrameIndex;
+
+        Device->ResetCommandPool(Device->Handle, Context->CommandPool, 0);
+        Context->CommandBufferIndex = 0;
+
+        Rr_ResetDescriptorAllocator(&Context->DescriptorAllocator, Device);
+    }
+}
+
+static void Rr_CleanupRecordingThreads(Rr_Renderer *Renderer)
+{
+    Rr_Device *Device = &Renderer->Device;
+    Rr_RecordingThreads *Threads = &Renderer->RecordingThreads;
+
+    if(Threads->Count == 0)
+    {
+        return;
+    }
+
+    Threads->ExitRequested = true;
+    for(size_t Index = 0; Index < Threads->Count; ++Index)
+    {
+        SDL_SignalSemaphore(Threads->Threads[Index].Semaphore);
+    }
+
+    for(size_t Index = 0; Index < Threads->Count; ++Index)
+    {
+        Rr_RecordingThread *Thread = Threads->Threads + Index;
+
+        SDL_WaitThread(Thread->Handle, NULL);
+        SDL_DestroySemaphore(Thread->Semaphore);
+
+        for(size_t FrameIndex = 0; FrameIndex < RR_FRAME_OVERLAP; ++FrameIndex)
+        {
+            Rr_RecordingContext *Context = Thread->Contexts + FrameIndex;
+
+            Device->DestroyCommandPool(
+                Device->Handle,
+                Context->CommandPool,
+                NULL);
+            Rr_DestroyDescriptorAllocator(
+                &Context->DescriptorAllocator,
+                Device);
+        }
+
+        Rr_DestroyArena(Thread->Arena);
+    }
+
+    SDL_DestroySemaphore(Threads->DoneSemaphore);
+}
+
 static void Rr_InitVMA(Rr_Renderer *Renderer)
 {
     Rr_Instance *Instance = &Renderer->Instance;
@@ -536,7 +816,9 @@ static void Rr_InitVMA(Rr_Renderer *Renderer)
         // Device->BindImageMemory2,
     };
     VmaAllocatorCreateInfo AllocatorInfo = {
-        .flags = 0,
+        .flags = Device->HasMemoryBudget
+                     ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT
+                     : 0,
         .physicalDevice = Renderer->PhysicalDevice.Handle,
         .device = Renderer->Device.Handle,
         .pVulkanFunctions = &VulkanFunctions,
@@ -669,30 +951,73 @@ Rr_Renderer *Rr_CreateRenderer(Rr_App *App)
 
     Rr_Renderer *Renderer = RR_ALLOC_TYPE(Arena, Rr_Renderer);
     Renderer->Arena = Arena;
+    Renderer->Heap = Rr_CreateDefaultTLSF();
 
     SDL_Window *Window = App->Window;
-    // Rr_AppConfig *Config = App->Config;
+    Rr_AppConfig *Config = App->Config;
+
+    Renderer->Headless = Config->Headless;
+    Renderer->UsesSplitBarriers = Config->SplitBarriers;
+    Renderer->EnforcesMemoryBudget = Config->GPUMemoryBudget;
+    Renderer->App = App;
 
     Rr_InitLoader(&Renderer->Loader);
     Rr_InitInstance(
         &Renderer->Loader,
-        SDL_GetWindowTitle(App->Window),
+        Config->Title,
+        Renderer->Headless,
         &Renderer->Instance);
-    Rr_InitSurface(Window, &Renderer->Instance, &Renderer->Surface);
+    if(Renderer->Headless == false)
+    {
+        Rr_InitSurface(Window, &Renderer->Instance, &Renderer->Surface);
+    }
     Rr_InitDeviceAndQueues(
         &Renderer->Instance,
         Renderer->Surface,
         &Renderer->PhysicalDevice,
         &Renderer->Device,
         &Renderer->GraphicsQueue,
-        &Renderer->TransferQueue);
+        &Renderer->TransferQueue,
+        &Renderer->ComputeQueue);
 
     Rr_InitVMA(Renderer);
+    Rr_InitPipelineCache(Renderer, Config->PipelineCachePath);
+    Rr_InitPipelineCompiler(Renderer, Config->PipelineCompilerThreadCount);
+    if(Config->Bindless)
+    {
+        if(Renderer->Device.HasDescriptorIndexing)
+        {
+            Renderer->UsesBindless = Rr_InitBindlessSet(
+                &Renderer->Bindless,
+                &Renderer->PhysicalDevice,
+                &Renderer->Device);
+        }
+        else
+        {
+            RR_LOG("Bindless mode requires VK_EXT_descriptor_indexing.");
+        }
+    }
     Rr_InitTransientCommandPools(Renderer);
-    uint32_t Width, Height;
-    SDL_GetWindowSizeInPixels(Window, (int32_t *)&Width, (int32_t *)&Height);
-    Rr_InitSwapchain(Renderer, &Width, &Height);
+    if(Renderer->Headless)
+    {
+        Rr_IntVec2 Size = Config->HeadlessSize;
+        if(Size.Width <= 0 || Size.Height <= 0)
+        {
+            Size = Rr_GetDefaultWindowSize();
+        }
+        Rr_InitHeadlessSwapchain(Renderer, Size.Width, Size.Height);
+    }
+    else
+    {
+        uint32_t Width, Height;
+        SDL_GetWindowSizeInPixels(
+            Window,
+            (int32_t *)&Width,
+            (int32_t *)&Height);
+        Rr_InitSwapchain(Renderer, &Width, &Height);
+    }
     Rr_InitFrames(Renderer);
+    Rr_InitRecordingThreads(Renderer, Config->RecordingThreadCount);
     Rr_InitImmediateMode(Renderer);
     // Rr_InitNullTextures(App);
     // Rr_InitTextRenderer(App);
@@ -707,6 +1032,11 @@ bool Rr_NewFrame(Rr_App *App, void *Window)
     Rr_Renderer *Renderer = App->Renderer;
     Rr_Device *Device = &Renderer->Device;
 
+    if(Renderer->Headless)
+    {
+        return true;
+    }
+
     if(Rr_IsSwapchainDirty(Renderer) == true)
     {
         Device->DeviceWaitIdle(Device->Handle);
@@ -752,11 +1082,14 @@ void Rr_DestroyRenderer(Rr_App *App, Rr_Renderer *Renderer)
     {
         Device->DestroyFramebuffer(
             Device->Handle,
-            Renderer->Framebuffers.Data[Index].Handle,
+            RR_AT_SEGMENTED_SLICE(&Renderer->Framebuffers, Index)->Handle,
             NULL);
     }
+    RR_EMPTY_SLICE(&Renderer->Framebuffers);
 
+    Rr_CleanupRecordingThreads(Renderer);
     Rr_CleanupFrames(Renderer);
+    Rr_CleanupGraphCache(&Renderer->GraphCache);
 
     // Rr_DestroyImage(App, Renderer->NullTextures.White);
     // Rr_DestroyImage(App, Renderer->NullTextures.Normal);
@@ -764,9 +1097,19 @@ void Rr_DestroyRenderer(Rr_App *App, Rr_Renderer *Renderer)
     Rr_CleanupTransientCommandPools(Renderer);
     Rr_CleanupImmediateMode(Renderer);
 
-    Rr_CleanupSwapchain(Renderer, Renderer->Swapchain.Handle);
+    if(Renderer->Headless)
+    {
+        Rr_CleanupHeadlessSwapchain(Renderer);
+    }
+    else
+    {
+        Rr_CleanupSwapchain(Renderer, Renderer->Swapchain.Handle);
+    }
     Rr_DestroyGraphicsPipeline(Renderer, Renderer->PresentPipeline);
     Rr_DestroyPipelineLayout(Renderer, Renderer->PresentLayout);
+    Rr_CleanupPipelineCompiler(Renderer);
+    Rr_CleanupPipelineCache(Renderer);
+    Rr_CleanupBindlessSet(&Renderer->Bindless, Device);
 
     for(size_t Index = 0; Index < Renderer->DescriptorSetLayouts.Count; ++Index)
     {
@@ -780,11 +1123,15 @@ void Rr_DestroyRenderer(Rr_App *App, Rr_Renderer *Renderer)
 
     vmaDestroyAllocator(Renderer->Allocator);
 
-    Instance->DestroySurfaceKHR(Instance->Handle, Renderer->Surface, NULL);
+    if(Renderer->Surface != VK_NULL_HANDLE)
+    {
+        Instance->DestroySurfaceKHR(Instance->Handle, Renderer->Surface, NULL);
+    }
     Device->DestroyDevice(Device->Handle, NULL);
 
     Instance->DestroyInstance(Instance->Handle, NULL);
 
+    Rr_DestroyTLSF(Renderer->Heap);
     Rr_DestroyArena(Renderer->Arena);
 }
 
@@ -844,18 +1191,37 @@ static void Rr_ProcessPendingLoads(Rr_App *App)
 {
     Rr_Renderer *Renderer = App->Renderer;
 
-    if(Rr_TryLockSpinLock(&App->SyncArena.Lock))
+    Rr_PendingLoad *Pushed =
+        SDL_SetAtomicPointer(&Renderer->PendingLoads, NULL);
+    if(Pushed == NULL)
     {
-        for(size_t Index = 0; Index < Renderer->PendingLoadsSlice.Count;
-            ++Index)
-        {
-            Rr_PendingLoad *PendingLoad =
-                &Renderer->PendingLoadsSlice.Data[Index];
-            PendingLoad->LoadingCallback(App, PendingLoad->UserData);
-        }
-        RR_EMPTY_SLICE(&Renderer->PendingLoadsSlice);
+        return;
+    }
+
+    /* Loads are pushed in front, reverse to run in completion order. */
 
-        Rr_UnlockSpinLock(&App->SyncArena.Lock);
+    Rr_PendingLoad *PendingLoads = NULL;
+    int Count = 0;
+    while(Pushed != NULL)
+    {
+        Rr_PendingLoad *Next = Pushed->Next;
+        Pushed->Next = PendingLoads;
+        PendingLoads = Pushed;
+        Pushed = Next;
+        Count++;
+    }
+
+    for(Rr_PendingLoad *PendingLoad = PendingLoads; PendingLoad != NULL;
+        PendingLoad = PendingLoad->Next)
+    {
+        PendingLoad->LoadingCallback(App, PendingLoad->UserData);
+    }
+
+    /* With no loads in flight the load threads are not allocating. */
+
+    if(SDL_AddAtomicInt(&Renderer->LoadsInFlight, -Count) == Count)
+    {
+        Rr_ResetConcurrentArena(App->LoadArena);
     }
 }
 
@@ -874,6 +1240,7 @@ void Rr_PrepareFrame(Rr_App *App)
         .Extent = Renderer->Swapchain.Extent,
         .Format = Renderer->Swapchain.Format,
         .AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT,
+        .MipLevels = 1,
     };
 
     Frame->Graph = RR_ALLOC_TYPE(Frame->Arena, Rr_Graph);
@@ -906,32 +1273,183 @@ void Rr_DrawFrame(Rr_App *App)
     }
     Device->ResetFences(Device->Handle, 1, &Frame->RenderFence);
 
+    for(size_t Index = 0; Index < Frame->EventCount; ++Index)
+    {
+        Device->ResetEvent(Device->Handle, Frame->Events.Data[Index]);
+    }
+    Frame->EventCount = 0;
+
     Rr_ResetDescriptorAllocator(&Frame->DescriptorAllocator, Device);
+    Rr_ResetRecordingThreads(Renderer);
+    if(Renderer->UsesBindless)
+    {
+        Rr_RecycleBindlessIndices(&Renderer->Bindless, Renderer->FrameNumber);
+    }
 
-    /* Acquire swapchain image. */
+    VkCommandBufferBeginInfo CommandBufferBeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = NULL,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = NULL,
+    };
 
-    uint32_t SwapchainImageIndex;
-    Result = Device->AcquireNextImageKHR(
-        Device->Handle,
-        Swapchain->Handle,
-        1000000000,
-        Frame->SwapchainSemaphore,
-        VK_NULL_HANDLE,
-        &SwapchainImageIndex);
-    if(Result == VK_TIMEOUT)
+    /* Record and submit everything that doesn't touch the swapchain
+     * image before acquiring it, so the GPU is busy while we wait.
+     * Async compute waits for everything submitted to the graphics
+     * queue up to the early command buffer (including ownership
+     * releases), and the late one waits for its results. */
+
+    Device->BeginCommandBuffer(
+        Frame->EarlyCommandBuffer,
+        &CommandBufferBeginInfo);
+    if(Rr_IsUsingComputeQueue(Renderer))
     {
-        RR_ABORT("Swapchain image timeout!");
+        Device->BeginCommandBuffer(
+            Frame->ComputeCommandBuffer,
+            &CommandBufferBeginInfo);
     }
-    if(Result == VK_ERROR_OUT_OF_DATE_KHR)
+
+    Rr_ExecuteEarlyGraph(Renderer, Frame->Graph, Scratch.Arena);
+
+    Device->EndCommandBuffer(Frame->EarlyCommandBuffer);
+    if(Rr_IsUsingComputeQueue(Renderer))
     {
-        Rr_SetSwapchainDirty(Renderer, true);
-        return;
+        Device->EndCommandBuffer(Frame->ComputeCommandBuffer);
+    }
+
+    VkSemaphore EarlySignalSemaphores[] = {
+        Frame->EarlySemaphore,
+        Frame->ReleaseSemaphore,
+    };
+    VkSubmitInfo EarlySubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &Frame->EarlyCommandBuffer,
+        .signalSemaphoreCount = Frame->ComputeSubmitPending ? 2 : 1,
+        .pSignalSemaphores = EarlySignalSemaphores,
+        .waitSemaphoreCount = 0,
+        .pWaitSemaphores = NULL,
+        .pWaitDstStageMask = NULL,
+    };
+
+    VkSubmitInfo ComputeSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &Frame->ComputeCommandBuffer,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &Frame->ComputeSemaphore,
+        .waitSemaphoreCount = 1,
+        .pWaitSemaphores = &Frame->ReleaseSemaphore,
+        .pWaitDstStageMask =
+            &(VkPipelineStageFlags){ VK_PIPELINE_STAGE_ALL_COMMANDS_BIT },
+    };
+
+    Rr_LockSpinLock(&Renderer->GraphicsQueue.Lock);
+
+    Device->QueueSubmit(
+        Renderer->GraphicsQueue.Handle,
+        1,
+        &EarlySubmitInfo,
+        VK_NULL_HANDLE);
+
+    if(Frame->ComputeSubmitPending)
+    {
+        Rr_LockSpinLock(&Renderer->ComputeQueue.Lock);
+        Device->QueueSubmit(
+            Renderer->ComputeQueue.Handle,
+            1,
+            &ComputeSubmitInfo,
+            VK_NULL_HANDLE);
+        Rr_UnlockSpinLock(&Renderer->ComputeQueue.Lock);
+    }
+
+    Rr_UnlockSpinLock(&Renderer->GraphicsQueue.Lock);
+
+    /* Late submission waits for early (and compute) work. */
+
+    uint32_t LateWaitCount = 0;
+    VkSemaphore LateWaitSemaphores[3];
+    VkPipelineStageFlags LateWaitStages[3];
+    LateWaitSemaphores[LateWaitCount] = Frame->EarlySemaphore;
+    LateWaitStages[LateWaitCount++] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    if(Frame->ComputeSubmitPending)
+    {
+        LateWaitSemaphores[LateWaitCount] = Frame->ComputeSemaphore;
+        LateWaitStages[LateWaitCount++] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+
+    /* Acquire swapchain image. */
+
+    uint32_t SwapchainImageIndex;
+    if(Renderer->Headless)
+    {
+        /* Offscreen images are owned by frames so
+         * the render fence above already guards them. */
+
+        SwapchainImageIndex = (uint32_t)Renderer->CurrentFrameIndex;
     }
-    if(Result == VK_SUBOPTIMAL_KHR)
+    else
     {
-        Rr_SetSwapchainDirty(Renderer, true);
+        Result = Device->AcquireNextImageKHR(
+            Device->Handle,
+            Swapchain->Handle,
+            1000000000,
+            Frame->SwapchainSemaphore,
+            VK_NULL_HANDLE,
+            &SwapchainImageIndex);
+        if(Result == VK_TIMEOUT)
+        {
+            RR_ABORT("Swapchain image timeout!");
+        }
+        if(Result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            /* Early work is already in flight. Submit a late command
+             * buffer that only takes back compute resources so that
+             * semaphores are consumed and the render fence signals. */
+
+            Rr_SetSwapchainDirty(Renderer, true);
+
+            Device->BeginCommandBuffer(
+                Frame->LateCommandBuffer,
+                &CommandBufferBeginInfo);
+            Rr_AcquireComputeResources(
+                Renderer,
+                Frame->Graph,
+                Frame->LateCommandBuffer,
+                Scratch.Arena);
+            Device->EndCommandBuffer(Frame->LateCommandBuffer);
+
+            VkSubmitInfo FlushSubmitInfo = {
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                .commandBufferCount = 1,
+                .pCommandBuffers = &Frame->LateCommandBuffer,
+                .signalSemaphoreCount = 0,
+                .pSignalSemaphores = NULL,
+                .waitSemaphoreCount = LateWaitCount,
+                .pWaitSemaphores = LateWaitSemaphores,
+                .pWaitDstStageMask = LateWaitStages,
+            };
+
+            Rr_LockSpinLock(&Renderer->GraphicsQueue.Lock);
+            Device->QueueSubmit(
+                Renderer->GraphicsQueue.Handle,
+                1,
+                &FlushSubmitInfo,
+                Frame->RenderFence);
+            Rr_UnlockSpinLock(&Renderer->GraphicsQueue.Lock);
+
+            Rr_DestroyScratch(Scratch);
+            return;
+        }
+        if(Result == VK_SUBOPTIMAL_KHR)
+        {
+            Rr_SetSwapchainDirty(Renderer, true);
+        }
+        assert(Result >= 0);
+
+        LateWaitSemaphores[LateWaitCount] = Frame->SwapchainSemaphore;
+        LateWaitStages[LateWaitCount++] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
     }
-    assert(Result >= 0);
 
     VkImage SwapchainImage =
         Renderer->Swapchain.Images.Data[SwapchainImageIndex].Handle;
@@ -948,117 +1466,93 @@ void Rr_DrawFrame(Rr_App *App)
     Frame->SwapchainFramebuffer =
         Renderer->Swapchain.Images.Data[SwapchainImageIndex].Framebuffer;
 
-    VkCommandBufferBeginInfo CommandBufferBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .pNext = NULL,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = NULL,
-    };
-
-    /* Execute Frame Graph */
+    /* Record everything that depends on the swapchain image. */
 
-    Device->BeginCommandBuffer(
-        Frame->EarlyCommandBuffer,
-        &CommandBufferBeginInfo);
     Device->BeginCommandBuffer(
         Frame->LateCommandBuffer,
         &CommandBufferBeginInfo);
 
-    Rr_ExecuteGraph(Renderer, Frame->Graph, Scratch.Arena);
+    Rr_ExecuteLateGraph(Renderer, Frame->Graph, Scratch.Arena);
 
-    Device->EndCommandBuffer(Frame->EarlyCommandBuffer);
+    /* Always transition swapchain image to present layout.
+     * Offscreen images are left as is for readback. */
 
-    /* Always transition swapchain image to present layout. */
-
-    Rr_SyncState *SyncState =
-        Rr_GetSynchronizationState(Renderer, (Rr_MapKey)SwapchainImage);
-    Device->CmdPipelineBarrier(
-        Frame->LateCommandBuffer,
-        SyncState->StageMask,
-        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-        0,
-        0,
-        NULL,
-        0,
-        NULL,
-        1,
-        &(VkImageMemoryBarrier){
-            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-            .image = SwapchainImage,
-            .oldLayout = SyncState->Specific.Layout,
-            .newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-            .srcAccessMask = SyncState->AccessMask,
-            .dstAccessMask = 0,
-            .subresourceRange = {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                .baseMipLevel = 0,
-                .levelCount = VK_REMAINING_MIP_LEVELS,
-                .baseArrayLayer = 0,
-                .layerCount = VK_REMAINING_ARRAY_LAYERS,
-            },
-        });
-    SyncState->AccessMask = 0;
-    SyncState->StageMask =
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT; /* Doesn't seems right. */
-    SyncState->Specific.Layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    if(Renderer->Headless == false)
+    {
+        Rr_SyncState *SyncState =
+            Rr_GetSynchronizationState(Renderer, (Rr_MapKey)SwapchainImage);
+        Device->CmdPipelineBarrier(
+            Frame->LateCommandBuffer,
+            SyncState->StageMask,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0,
+            NULL,
+            0,
+            NULL,
+            1,
+            &(VkImageMemoryBarrier){
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .image = SwapchainImage,
+                .oldLayout = SyncState->Specific.Layout,
+                .newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                .srcAccessMask = SyncState->AccessMask,
+                .dstAccessMask = 0,
+                .subresourceRange = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .baseMipLevel = 0,
+                    .levelCount = VK_REMAINING_MIP_LEVELS,
+                    .baseArrayLayer = 0,
+                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
+                },
+            });
+        SyncState->AccessMask = 0;
+        SyncState->StageMask =
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT; /* Doesn't seems right. */
+        SyncState->Specific.Layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    }
 
     Device->EndCommandBuffer(Frame->LateCommandBuffer);
 
-    /* Submit frame command buffer and queue present. */
+    /* Nothing waits for the late semaphore in headless mode. */
 
-    VkSubmitInfo SubmitInfos[] = {
-        {
-            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .commandBufferCount = 1,
-            .pCommandBuffers = &Frame->EarlyCommandBuffer,
-            .signalSemaphoreCount = 1,
-            .pSignalSemaphores = &Frame->EarlySemaphore,
-            .waitSemaphoreCount = 0,
-            .pWaitSemaphores = NULL,
-            .pWaitDstStageMask = NULL,
-        },
-        {
-            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .commandBufferCount = 1,
-            .pCommandBuffers = &Frame->LateCommandBuffer,
-            .signalSemaphoreCount = 1,
-            .pSignalSemaphores = &Frame->LateSemaphore,
-            .waitSemaphoreCount = 2,
-            .pWaitSemaphores =
-                (VkSemaphore[]){
-                    Frame->EarlySemaphore,
-                    Frame->SwapchainSemaphore,
-                },
-            .pWaitDstStageMask =
-                (VkPipelineStageFlags[]){
-                    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                },
-        },
+    VkSubmitInfo LateSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &Frame->LateCommandBuffer,
+        .signalSemaphoreCount = Renderer->Headless ? 0 : 1,
+        .pSignalSemaphores = &Frame->LateSemaphore,
+        .waitSemaphoreCount = LateWaitCount,
+        .pWaitSemaphores = LateWaitSemaphores,
+        .pWaitDstStageMask = LateWaitStages,
     };
 
     Rr_LockSpinLock(&Renderer->GraphicsQueue.Lock);
 
     Device->QueueSubmit(
         Renderer->GraphicsQueue.Handle,
-        2,
-        SubmitInfos,
+        1,
+        &LateSubmitInfo,
         Frame->RenderFence);
 
-    VkPresentInfoKHR PresentInfo = {
-        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &Frame->LateSemaphore,
-        .swapchainCount = 1,
-        .pSwapchains = &Swapchain->Handle,
-        .pImageIndices = &SwapchainImageIndex,
-    };
-
-    Result =
-        Device->QueuePresentKHR(Renderer->GraphicsQueue.Handle, &PresentInfo);
-    if(Result == VK_ERROR_OUT_OF_DATE_KHR)
+    if(Renderer->Headless == false)
     {
-        Rr_SetSwapchainDirty(Renderer, true);
+        VkPresentInfoKHR PresentInfo = {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &Frame->LateSemaphore,
+            .swapchainCount = 1,
+            .pSwapchains = &Swapchain->Handle,
+            .pImageIndices = &SwapchainImageIndex,
+        };
+
+        Result = Device->QueuePresentKHR(
+            Renderer->GraphicsQueue.Handle,
+            &PresentInfo);
+        if(Result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            Rr_SetSwapchainDirty(Renderer, true);
+        }
     }
 
     Rr_UnlockSpinLock(&Renderer->GraphicsQueue.Lock);
@@ -1066,6 +1560,12 @@ void Rr_DrawFrame(Rr_App *App)
     Renderer->FrameNumber++;
     Renderer->CurrentFrameIndex = Renderer->FrameNumber % RR_FRAME_OVERLAP;
 
+    /* Also refreshes heap budgets fetched from VK_EXT_memory_budget. */
+
+    vmaSetCurrentFrameIndex(
+        Renderer->Allocator,
+        (uint32_t)Renderer->FrameNumber);
+
     Rr_DestroyScratch(Scratch);
 }
 
@@ -1074,17 +1574,49 @@ Rr_Frame *Rr_GetCurrentFrame(Rr_Renderer *Renderer)
     return &Renderer->Frames[Renderer->CurrentFrameIndex];
 }
 
+VkEvent Rr_GetFrameEvent(Rr_Renderer *Renderer)
+{
+    Rr_Device *Device = &Renderer->Device;
+    Rr_Frame *Frame = Rr_GetCurrentFrame(Renderer);
+
+    if(Frame->EventCount == Frame->Events.Count)
+    {
+        VkEventCreateInfo EventCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO,
+            .pNext = NULL,
+            .flags = 0,
+        };
+        Device->CreateEvent(
+            Device->Handle,
+            &EventCreateInfo,
+            NULL,
+            RR_PUSH_SLICE(&Frame->Events, Renderer->Arena));
+    }
+
+    return Frame->Events.Data[Frame->EventCount++];
+}
+
 bool Rr_IsUsingTransferQueue(Rr_Renderer *Renderer)
 {
     return Renderer->TransferQueue.Handle != VK_NULL_HANDLE;
 }
 
+bool Rr_IsUsingComputeQueue(Rr_Renderer *Renderer)
+{
+    return Renderer->ComputeQueue.Handle != VK_NULL_HANDLE;
+}
+
 size_t Rr_GetUniformAlignment(Rr_Renderer *Renderer)
 {
     return Renderer->PhysicalDevice.Properties.properties.limits
         .minUniformBufferOffsetAlignment;
 }
 
+bool Rr_IsBindlessEnabled(Rr_Renderer *Renderer)
+{
+    return Renderer->UsesBindless;
+}
+
 size_t Rr_GetStorageAlignment(Rr_Renderer *Renderer)
 {
     return Renderer->PhysicalDevice.Properties.properties.limits
@@ -1103,6 +1635,79 @@ size_t Rr_GetMaxComputeWorkgroupInvocations(Rr_Renderer *Renderer)
         .maxComputeWorkGroupInvocations;
 }
 
+Rr_GPUMemoryStats Rr_GetGPUMemoryStats(Rr_Renderer *Renderer)
+{
+    Rr_GPUMemoryStats Stats = {
+        .HasMemoryBudget = Renderer->Device.HasMemoryBudget,
+    };
+
+    const VkPhysicalDeviceMemoryProperties *MemoryProperties;
+    vmaGetMemoryProperties(Renderer->Allocator, &MemoryProperties);
+
+    VmaBudget Budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(Renderer->Allocator, Budgets);
+
+    Stats.HeapCount =
+        SDL_min(MemoryProperties->memoryHeapCount, RR_MAX_GPU_MEMORY_HEAPS);
+    for(size_t Index = 0; Index < Stats.HeapCount; ++Index)
+    {
+        const VkMemoryHeap *Heap = MemoryProperties->memoryHeaps + Index;
+        VmaBudget *Budget = Budgets + Index;
+        Stats.Heaps[Index] = (Rr_GPUMemoryHeap){
+            .Size = Heap->size,
+            .Budget = Budget->budget,
+            .Usage = Budget->usage,
+            .AllocatedBytes = Budget->statistics.allocationBytes,
+            .BlockBytes = Budget->statistics.blockBytes,
+            .DeviceLocal =
+                RR_HAS_BIT(Heap->flags, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT),
+        };
+    }
+
+    Rr_LockSpinLock(&Renderer->MemoryLock);
+    SDL_memcpy(
+        Stats.CategoryBytes,
+        Renderer->MemoryCategoryBytes,
+        sizeof(Stats.CategoryBytes));
+    Rr_UnlockSpinLock(&Renderer->MemoryLock);
+
+    return Stats;
+}
+
+void Rr_TrackGPUMemory(
+    Rr_Renderer *Renderer,
+    Rr_GPUMemoryCategory Category,
+    VkDeviceSize Size,
+    bool Allocated)
+{
+    Rr_LockSpinLock(&Renderer->MemoryLock);
+    if(Allocated)
+    {
+        Renderer->MemoryCategoryBytes[Category] += Size;
+    }
+    else
+    {
+        Renderer->MemoryCategoryBytes[Category] -= Size;
+    }
+    Rr_UnlockSpinLock(&Renderer->MemoryLock);
+}
+
+bool Rr_RelieveGPUMemoryPressure(Rr_Renderer *Renderer, VkDeviceSize Size)
+{
+    Rr_App *App = Renderer->App;
+
+    RR_LOG(
+        "GPU memory budget exceeded by allocation of %zu bytes.",
+        (size_t)Size);
+
+    if(App->Config->GPUMemoryPressureFunc == NULL)
+    {
+        return false;
+    }
+
+    return App->Config->GPUMemoryPressureFunc(App, Size, App->UserData);
+}
+
 Rr_Graph *Rr_GetGraph(Rr_Renderer *Renderer)
 {
     return Rr_GetCurrentFrame(Renderer)->Graph;
@@ -1135,6 +1740,11 @@ bool Rr_SetSwapchainPresentMode(
     Rr_Renderer *Renderer,
     Rr_PresentMode PresentMode)
 {
+    if(Renderer->Headless)
+    {
+        return false;
+    }
+
     Renderer->Swapchain.PresentMode = PresentMode;
     Rr_SetSwapchainDirty(Renderer, true);
 
@@ -1290,7 +1900,8 @@ static VkFramebuffer Rr_GetFramebufferInternal(
 
     for(size_t Index = 0; Index < Renderer->Framebuffers.Count; ++Index)
     {
-        Rr_Framebuffer *CachedFramebuffer = Renderer->Framebuffers.Data + Index;
+        Rr_Framebuffer *CachedFramebuffer =
+            RR_AT_SEGMENTED_SLICE(&Renderer->Framebuffers, Index);
 
         if(CachedFramebuffer->Hash == Hash)
         {
@@ -1314,16 +1925,61 @@ static VkFramebuffer Rr_GetFramebufferInternal(
 
     Device->CreateFramebuffer(Device->Handle, &CreateInfo, NULL, &Framebuffer);
 
-    *RR_PUSH_SLICE(&Renderer->Framebuffers, Renderer->Arena) = (Rr_Framebuffer){
-        .Handle = Framebuffer,
-        .Hash = Hash,
-    };
+    /* Keep attachments around so that framebuffers
+     * can be evicted when their views are destroyed. */
+
+    VkImageView *CachedImageViews =
+        RR_ALLOC_TYPE_COUNT(Renderer->Arena, VkImageView, ImageViewCount);
+    memcpy(CachedImageViews, ImageViews, sizeof(VkImageView) * ImageViewCount);
+
+    *RR_PUSH_SEGMENTED_SLICE(&Renderer->Framebuffers, Renderer->Arena) =
+        (Rr_Framebuffer){
+            .Handle = Framebuffer,
+            .Hash = Hash,
+            .ImageViews = CachedImageViews,
+            .ImageViewCount = ImageViewCount,
+        };
 
     Rr_DestroyScratch(Scratch);
 
     return Framebuffer;
 }
 
+void Rr_DestroyFramebuffersWithView(
+    Rr_Renderer *Renderer,
+    VkImageView ImageView)
+{
+    Rr_Device *Device = &Renderer->Device;
+
+    for(size_t Index = 0; Index < Renderer->Framebuffers.Count;)
+    {
+        Rr_Framebuffer *CachedFramebuffer =
+            RR_AT_SEGMENTED_SLICE(&Renderer->Framebuffers, Index);
+
+        bool UsesView = false;
+        for(size_t ViewIndex = 0; ViewIndex < CachedFramebuffer->ImageViewCount;
+            ++ViewIndex)
+        {
+            UsesView |= CachedFramebuffer->ImageViews[ViewIndex] == ImageView;
+        }
+
+        if(UsesView)
+        {
+            Device->DestroyFramebuffer(
+                Device->Handle,
+                CachedFramebuffer->Handle,
+                NULL);
+            size_t LastIndex = --Renderer->Framebuffers.Count;
+            *CachedFramebuffer =
+                *RR_AT_SEGMENTED_SLICE(&Renderer->Framebuffers, LastIndex);
+        }
+        else
+        {
+            Index++;
+        }
+    }
+}
+
 VkFramebuffer Rr_GetFramebufferViews(
     Rr_Renderer *Renderer,
     VkRenderPass RenderPass,
@@ -1374,25 +2030,117 @@ VkFramebuffer Rr_GetFramebuffer(
 Rr_SyncState *Rr_GetSynchronizationState(Rr_Renderer *Renderer, Rr_MapKey Key)
 {
     Rr_SyncState **SyncStateRef =
-        RR_UPSERT(&Renderer->GlobalSync, Key, Renderer->Arena);
+        RR_HASH_UPSERT(&Renderer->GlobalSync, Key, Renderer->Arena);
     if(*SyncStateRef != NULL)
     {
         return *SyncStateRef;
     }
     *SyncStateRef =
-        RR_GET_FREE_LIST_ITEM(&Renderer->SyncStates, Renderer->Arena);
+        RR_ALLOC_POOL_ITEM(&Renderer->SyncStates, Renderer->Arena);
     Rr_SyncState *SyncState = *SyncStateRef;
     RR_ZERO_PTR(SyncState);
     return SyncState;
 }
 
+static Rr_MapKey Rr_GetSubresourceKey(Rr_MapKey Key, uint32_t Subresource)
+{
+    uint64_t Words[] = { Key, Subresource + 1 };
+    return XXH3_64bits(Words, sizeof(Words));
+}
+
+static void Rr_ReturnSubresourceStates(
+    Rr_Renderer *Renderer,
+    Rr_MapKey Key,
+    Rr_SyncState *SyncState)
+{
+    for(uint32_t Index = 0; Index < SyncState->SubresourceCount; ++Index)
+    {
+        Rr_ReturnSynchronizationState(
+            Renderer,
+            Rr_GetSubresourceKey(Key, Index));
+    }
+    SyncState->SubresourceCount = 0;
+}
+
 void Rr_ReturnSynchronizationState(Rr_Renderer *Renderer, Rr_MapKey Key)
 {
     Rr_SyncState **SyncStateRef =
-        RR_UPSERT(&Renderer->GlobalSync, Key, Renderer->Arena);
-    if(*SyncStateRef != NULL)
+        RR_HASH_UPSERT(&Renderer->GlobalSync, Key, NULL);
+    if(SyncStateRef == NULL)
     {
-        RR_RETURN_FREE_LIST_ITEM(&Renderer->SyncStates, *SyncStateRef);
+        return;
+    }
+
+    Rr_SyncState *SyncState = *SyncStateRef;
+    Rr_RemoveHashMap(&Renderer->GlobalSync, Key);
+    if(SyncState != NULL)
+    {
+        Rr_ReturnSubresourceStates(Renderer, Key, SyncState);
+        RR_FREE_POOL_ITEM(&Renderer->SyncStates, SyncState);
+    }
+}
+
+void Rr_SplitSynchronizationState(
+    Rr_Renderer *Renderer,
+    Rr_MapKey Key,
+    uint32_t SubresourceCount)
+{
+    Rr_SyncState *SyncState = Rr_GetSynchronizationState(Renderer, Key);
+    if(SyncState->SubresourceCount > 0)
+    {
+        assert(SyncState->SubresourceCount == SubresourceCount);
+        return;
     }
-    *SyncStateRef = NULL;
+
+    for(uint32_t Index = 0; Index < SubresourceCount; ++Index)
+    {
+        *Rr_GetSynchronizationState(
+            Renderer,
+            Rr_GetSubresourceKey(Key, Index)) = *SyncState;
+    }
+    SyncState->SubresourceCount = SubresourceCount;
+}
+
+Rr_SyncState *Rr_GetSubresourceSynchronizationState(
+    Rr_Renderer *Renderer,
+    Rr_MapKey Key,
+    uint32_t Subresource)
+{
+    return Rr_GetSynchronizationState(
+        Renderer,
+        Rr_GetSubresourceKey(Key, Subresource));
+}
+
+bool Rr_JoinSynchronizationState(Rr_Renderer *Renderer, Rr_MapKey Key)
+{
+    Rr_SyncState *SyncState = Rr_GetSynchronizationState(Renderer, Key);
+    if(SyncState->SubresourceCount == 0)
+    {
+        return true;
+    }
+
+    Rr_SyncState *First =
+        Rr_GetSubresourceSynchronizationState(Renderer, Key, 0);
+    for(uint32_t Index = 1; Index < SyncState->SubresourceCount; ++Index)
+    {
+        Rr_SyncState *Other =
+            Rr_GetSubresourceSynchronizationState(Renderer, Key, Index);
+        if(Rr_IsSameSynchronizationState(First, Other) == false)
+        {
+            return false;
+        }
+    }
+
+    Rr_SyncState Joined = *First;
+    Rr_ReturnSubresourceStates(Renderer, Key, SyncState);
+    *SyncState = Joined;
+
+    return true;
+}
+
+bool Rr_IsSameSynchronizationState(Rr_SyncState *A, Rr_SyncState *B)
+{
+    return A->StageMask == B->StageMask && A->AccessMask == B->AccessMask &&
+           A->Specific.Layout == B->Specific.Layout &&
+           A->ComputeOwned == B->ComputeOwned;
 }
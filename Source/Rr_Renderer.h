@@ -3,6 +3,7 @@
 #include <Rr/Rr_Renderer.h>
 
 #include "Rr_Graph.h"
+#include "Rr_Image.h"
 #include "Rr_Load.h"
 #include "Rr_Pipeline.h"
 #include "Rr_Text.h"
@@ -28,6 +29,7 @@ struct Rr_Swapchain
     VkExtent3D Extent;
     Rr_AtomicInt RecreatePending;
     RR_SLICE(Rr_SwapchainImage) Images;
+    Rr_Image *OffscreenImage; /* Backs swapchain images in headless mode. */
 };
 
 typedef struct Rr_ImmediateMode Rr_ImmediateMode;
@@ -54,8 +56,26 @@ struct Rr_Frame
     VkSemaphore LateSemaphore;
     VkFence RenderFence;
 
+    /* Async compute submission, only created with a dedicated
+     * compute queue. Ownership releases from the graphics queue
+     * are recorded into the early command buffer. */
+
+    VkCommandPool ComputeCommandPool;
+    VkCommandBuffer ComputeCommandBuffer;
+    VkSemaphore ComputeSemaphore;
+    VkSemaphore ReleaseSemaphore;
+    bool ComputeSubmitPending;
+
+    /* Events for split barriers, reset once the frame fence
+     * is signaled. */
+
+    RR_SLICE(VkEvent) Events;
+    size_t EventCount;
+
     Rr_DescriptorAllocator DescriptorAllocator;
 
+    Rr_TransientHeap TransientHeap;
+
     Rr_Graph *Graph;
 
     Rr_Arena *Arena;
@@ -66,6 +86,8 @@ struct Rr_CachedFramebuffer
 {
     VkFramebuffer Handle;
     uint32_t Hash;
+    VkImageView *ImageViews;
+    size_t ImageViewCount;
 };
 
 typedef struct Rr_CachedRenderPass Rr_RenderPass;
@@ -87,6 +109,7 @@ struct Rr_Renderer
 
     /* Presentation */
 
+    bool Headless;
     Rr_Swapchain Swapchain;
     Rr_GraphicsPipeline *PresentPipeline;
     Rr_PipelineLayout *PresentLayout;
@@ -96,22 +119,43 @@ struct Rr_Renderer
 
     Rr_Queue GraphicsQueue;
     Rr_Queue TransferQueue;
-    // Rr_Queue ComputeQueue;
+    Rr_Queue ComputeQueue;
 
     /* Vulkan Memory Allocator */
 
     VmaAllocator Allocator;
 
+    /* GPU Memory Budget */
+
+    Rr_SpinLock MemoryLock;
+    uint64_t MemoryCategoryBytes[RR_GPU_MEMORY_CATEGORY_COUNT];
+    bool EnforcesMemoryBudget;
+    Rr_App *App;
+
     /* Frames */
 
     Rr_Frame Frames[RR_FRAME_OVERLAP];
     size_t FrameNumber;
     size_t CurrentFrameIndex;
 
+    /* Pipeline Cache */
+
+    VkPipelineCache PipelineCache;
+    char *PipelineCachePath;
+
+    /* Pipeline Compiler Threads */
+
+    Rr_PipelineCompiler PipelineCompiler;
+
+    /* Bindless Descriptors */
+
+    Rr_BindlessSet Bindless;
+    bool UsesBindless;
+
     /* Hashed structures. */
 
     RR_SLICE(Rr_RenderPass) RenderPasses;
-    RR_SLICE(Rr_Framebuffer) Framebuffers;
+    RR_SEGMENTED_SLICE(Rr_Framebuffer) Framebuffers;
     RR_SLICE(Rr_DescriptorSetLayout) DescriptorSetLayouts;
 
     /* Immediate Command Pool/Buffer */
@@ -128,7 +172,8 @@ struct Rr_Renderer
 
     /* Pending Loads */
 
-    RR_SLICE(Rr_PendingLoad) PendingLoadsSlice;
+    SDL_AtomicPointer PendingLoads;
+    SDL_AtomicInt LoadsInFlight;
 
     /* Text Rendering */
 
@@ -137,25 +182,43 @@ struct Rr_Renderer
 
     /* Global Synchronization Map */
 
-    Rr_Map *GlobalSync;
+    Rr_HashMap GlobalSync;
+
+    /* Compiled Graph Cache */
+
+    Rr_GraphCache GraphCache;
+    bool UsesSplitBarriers;
+
+    /* Transient Image Memory Requirements */
+
+    Rr_Map *TransientImageRequirements;
+
+    /* Recording Threads */
+
+    Rr_RecordingThreads RecordingThreads;
 
     /* Storage */
 
-    RR_FREE_LIST(Rr_Buffer) Buffers;
+    RR_POOL(Rr_Buffer) Buffers;
+    RR_POOL(Rr_BufferPool) BufferPools;
     // RR_FREE_LIST(Rr_Primitive) Primitives;
     // RR_FREE_LIST(Rr_StaticMesh) StaticMeshes;
     // RR_FREE_LIST(Rr_SkeletalMesh) SkeletalMeshes;
-    RR_FREE_LIST(Rr_Image) Images;
-    RR_FREE_LIST(Rr_Font) Fonts;
-    RR_FREE_LIST(Rr_PipelineLayout) PipelineLayouts;
-    RR_FREE_LIST(Rr_ComputePipeline) ComputePipelines;
-    RR_FREE_LIST(Rr_GraphicsPipeline) GraphicsPipelines;
-    RR_FREE_LIST(Rr_Sampler) Samplers;
-    RR_FREE_LIST(Rr_SyncState) SyncStates;
+    RR_POOL(Rr_Image) Images;
+    RR_POOL(Rr_Font) Fonts;
+    RR_POOL(Rr_PipelineLayout) PipelineLayouts;
+    RR_POOL(Rr_ComputePipeline) ComputePipelines;
+    RR_POOL(Rr_GraphicsPipeline) GraphicsPipelines;
+    RR_POOL(Rr_Sampler) Samplers;
+    RR_POOL(Rr_SyncState) SyncStates;
 
     /* Arena */
 
     Rr_Arena *Arena;
+
+    /* Heap for long-lived allocations of varying size. */
+
+    Rr_TLSF *Heap;
 };
 
 extern Rr_Renderer *Rr_CreateRenderer(Rr_App *App);
@@ -176,8 +239,25 @@ extern void Rr_EndImmediate(Rr_Renderer *Renderer);
 
 extern Rr_Frame *Rr_GetCurrentFrame(Rr_Renderer *Renderer);
 
+extern VkEvent Rr_GetFrameEvent(Rr_Renderer *Renderer);
+
 extern bool Rr_IsUsingTransferQueue(Rr_Renderer *Renderer);
 
+extern bool Rr_IsUsingComputeQueue(Rr_Renderer *Renderer);
+
+extern void Rr_TrackGPUMemory(
+    Rr_Renderer *Renderer,
+    Rr_GPUMemoryCategory Category,
+    VkDeviceSize Size,
+    bool Allocated);
+
+/* Called when an allocation failed under the budget policy, true means
+ * the application released memory and the allocation may be retried. */
+
+extern bool Rr_RelieveGPUMemoryPressure(
+    Rr_Renderer *Renderer,
+    VkDeviceSize Size);
+
 typedef struct Rr_RenderPassAttachment Rr_RenderPassAttachment;
 struct Rr_RenderPassAttachment
 {
@@ -211,8 +291,30 @@ extern VkFramebuffer Rr_GetFramebufferViews(
     size_t ImageViewCount,
     VkExtent3D Extent);
 
+extern void Rr_DestroyFramebuffersWithView(
+    Rr_Renderer *Renderer,
+    VkImageView ImageView);
+
 extern Rr_SyncState *Rr_GetSynchronizationState(
     Rr_Renderer *Renderer,
     Rr_MapKey Key);
 
 extern void Rr_ReturnSynchronizationState(Rr_Renderer *Renderer, Rr_MapKey Key);
+
+/* Image state is tracked per mip level once only a part of an image
+ * is accessed. Subresource states stay valid until the states are
+ * joined back, which happens as soon as all of them match again. */
+
+extern void Rr_SplitSynchronizationState(
+    Rr_Renderer *Renderer,
+    Rr_MapKey Key,
+    uint32_t SubresourceCount);
+
+extern Rr_SyncState *Rr_GetSubresourceSynchronizationState(
+    Rr_Renderer *Renderer,
+    Rr_MapKey Key,
+    uint32_t Subresource);
+
+extern bool Rr_JoinSynchronizationState(Rr_Renderer *Renderer, Rr_MapKey Key);
+
+extern bool Rr_IsSameSynchronizationState(Rr_SyncState *A, Rr_SyncState *B);
@@ -140,6 +140,11 @@ Rr_Font *Rr_CreateFont(
         Renderer,
         sizeof(Rr_TextFontLayout),
         RR_BUFFER_FLAGS_UNIFORM_BIT);
+    if(Buffer == NULL)
+    {
+        Rr_DestroyImage(Renderer, Atlas);
+        return NULL;
+    }
 
     Rr_Asset FontJSON = Rr_LoadAsset(FontJSONRef);
 
@@ -158,7 +163,7 @@ Rr_Font *Rr_CreateFont(
         },
     };
 
-    Rr_Font *Font = RR_GET_FREE_LIST_ITEM(&Renderer->Fonts, Renderer->Arena);
+    Rr_Font *Font = RR_ALLOC_POOL_ITEM(&Renderer->Fonts, Renderer->Arena);
     *Font = (Rr_Font){
         .Buffer = Buffer,
         .Atlas = Atlas,
@@ -166,8 +171,11 @@ Rr_Font *Rr_CreateFont(
             cJSON_GetObjectItem(MetricsJSON, "lineHeight")),
         .DefaultSize =
             (float)cJSON_GetNumberValue(cJSON_GetObjectItem(AtlasJSON, "size")),
-        .Advances = Rr_Calloc(RR_TEXT_MAX_GLYPHS, sizeof(float)),
+        .Advances = Rr_AllocTLSF(
+            Renderer->Heap,
+            RR_TEXT_MAX_GLYPHS * sizeof(float)),
     };
+    memset(Font->Advances, 0, RR_TEXT_MAX_GLYPHS * sizeof(float));
 
     cJSON *GlyphsJSON =
         cJSON_GetObjectItemCaseSensitive(FontDataJSON, "glyphs");
@@ -238,12 +246,12 @@ Rr_Font *Rr_CreateFont(
 
 void Rr_DestroyFont(Rr_Renderer *Renderer, Rr_Font *Font)
 {
-    Rr_Free(Font->Advances);
+    Rr_FreeTLSF(Renderer->Heap, Font->Advances);
 
     Rr_DestroyImage(Renderer, Font->Atlas);
     Rr_DestroyBuffer(Renderer, Font->Buffer);
 
-    RR_RETURN_FREE_LIST_ITEM(&Renderer->Fonts, Font);
+    RR_FREE_POOL_ITEM(&Renderer->Fonts, Font);
 }
 
 Rr_Vec2 Rr_CalculateTextSize(Rr_Font *Font, float FontSize, Rr_String *String)
@@ -29,6 +29,7 @@ void Rr_InitLoader(Rr_VulkanLoader *Loader)
 void Rr_InitInstance(
     Rr_VulkanLoader *Loader,
     const char *ApplicationName,
+    bool Headless,
     Rr_Instance *Instance)
 {
     Rr_Scratch Scratch = Rr_GetScratch(NULL);
@@ -46,14 +47,23 @@ void Rr_InitInstance(
     uint32_t AppExtensionCount = RR_ARRAY_COUNT(AppExtensions);
     AppExtensionCount = 0; /* Use Vulkan Configurator! */
 
-    uint32_t SDLExtensionCount;
-    const char *const *SDLExtensions =
-        SDL_Vulkan_GetInstanceExtensions(&SDLExtensionCount);
+    /* Headless instance doesn't need any surface extensions. */
+
+    uint32_t SDLExtensionCount = 0;
+    const char *const *SDLExtensions = NULL;
+    if(Headless == false)
+    {
+        SDLExtensions = SDL_Vulkan_GetInstanceExtensions(&SDLExtensionCount);
+    }
 
     uint32_t ExtensionCount = SDLExtensionCount + AppExtensionCount;
-    const char **Extensions =
-        RR_ALLOC_TYPE_COUNT(Scratch.Arena, const char *, ExtensionCount);
-    for(uint32_t Index = 0; Index < ExtensionCount; Index++)
+    const char **Extensions = NULL;
+    if(ExtensionCount > 0)
+    {
+        Extensions =
+            RR_ALLOC_TYPE_COUNT(Scratch.Arena, const char *, ExtensionCount);
+    }
+    for(uint32_t Index = 0; Index < SDLExtensionCount; Index++)
     {
         Extensions[Index] = SDLExtensions[Index];
     }
@@ -218,23 +228,29 @@ static bool Rr_CheckPhysicalDevice(
     VkSurfaceKHR Surface,
     uint32_t *OutGraphicsQueueFamilyIndex,
     uint32_t *OutTransferQueueFamilyIndex,
+    uint32_t *OutComputeQueueFamilyIndex,
     Rr_Arena *Arena)
 {
+    const char *TargetExtensions[] = {
+        "VK_KHR_swapchain",
+    };
+
+    /* Swapchain extension is only required when presenting to a surface. */
+
+    uint32_t TargetExtensionCount =
+        Surface != VK_NULL_HANDLE ? SDL_arraysize(TargetExtensions) : 0;
+
     uint32_t ExtensionCount;
     Instance->EnumerateDeviceExtensionProperties(
         PhysicalDevice,
         NULL,
         &ExtensionCount,
         NULL);
-    if(ExtensionCount == 0)
+    if(ExtensionCount == 0 && TargetExtensionCount > 0)
     {
         return false;
     }
 
-    const char *TargetExtensions[] = {
-        "VK_KHR_swapchain",
-    };
-
     bool FoundExtensions[] = { 0 };
 
     VkExtensionProperties *Extensions =
@@ -247,8 +263,7 @@ static bool Rr_CheckPhysicalDevice(
 
     for(uint32_t Index = 0; Index < ExtensionCount; Index++)
     {
-        for(uint32_t TargetIndex = 0;
-            TargetIndex < SDL_arraysize(TargetExtensions);
+        for(uint32_t TargetIndex = 0; TargetIndex < TargetExtensionCount;
             ++TargetIndex)
         {
             if(strcmp(
@@ -259,7 +274,7 @@ static bool Rr_CheckPhysicalDevice(
             }
         }
     }
-    for(uint32_t TargetIndex = 0; TargetIndex < SDL_arraysize(TargetExtensions);
+    for(uint32_t TargetIndex = 0; TargetIndex < TargetExtensionCount;
         ++TargetIndex)
     {
         if(!FoundExtensions[TargetIndex])
@@ -293,11 +308,15 @@ static bool Rr_CheckPhysicalDevice(
 
     for(uint32_t Index = 0; Index < QueueFamilyCount; ++Index)
     {
-        Instance->GetPhysicalDeviceSurfaceSupportKHR(
-            PhysicalDevice,
-            Index,
-            Surface,
-            &QueuePresentSupport[Index]);
+        QueuePresentSupport[Index] = VK_TRUE;
+        if(Surface != VK_NULL_HANDLE)
+        {
+            Instance->GetPhysicalDeviceSurfaceSupportKHR(
+                PhysicalDevice,
+                Index,
+                Surface,
+                &QueuePresentSupport[Index]);
+        }
         if(QueuePresentSupport[Index] &&
            QueueFamilyProperties[Index].queueCount > 0 &&
            (QueueFamilyProperties[Index].queueFlags & VK_QUEUE_GRAPHICS_BIT))
@@ -333,10 +352,44 @@ static bool Rr_CheckPhysicalDevice(
         }
     }
 
+    /* Dedicated compute family may be shared with the transfer queue
+     * as long as it exposes a second queue. */
+
+    uint32_t ComputeQueueFamilyIndex = ~0U;
+
+    bool ForceDisableComputeQueue = RR_FORCE_DISABLE_COMPUTE_QUEUE;
+
+    if(!ForceDisableComputeQueue)
+    {
+        for(uint32_t Index = 0; Index < QueueFamilyCount; ++Index)
+        {
+            if(Index == GraphicsQueueFamilyIndex)
+            {
+                continue;
+            }
+
+            uint32_t RequiredQueueCount =
+                Index == TransferQueueFamilyIndex ? 2 : 1;
+            if(QueueFamilyProperties[Index].queueCount >= RequiredQueueCount &&
+               (QueueFamilyProperties[Index].queueFlags &
+                VK_QUEUE_COMPUTE_BIT))
+            {
+                ComputeQueueFamilyIndex = Index;
+                if(Index != TransferQueueFamilyIndex)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
     *OutGraphicsQueueFamilyIndex = GraphicsQueueFamilyIndex;
     *OutTransferQueueFamilyIndex = TransferQueueFamilyIndex == ~0U
                                        ? GraphicsQueueFamilyIndex
                                        : TransferQueueFamilyIndex;
+    *OutComputeQueueFamilyIndex = ComputeQueueFamilyIndex == ~0U
+                                      ? GraphicsQueueFamilyIndex
+                                      : ComputeQueueFamilyIndex;
 
     return true;
 }
@@ -347,6 +400,7 @@ void Rr_SelectPhysicalDevice(
     Rr_PhysicalDevice *PhysicalDevice,
     uint32_t *OutGraphicsQueueFamilyIndex,
     uint32_t *OutTransferQueueFamilyIndex,
+    uint32_t *OutComputeQueueFamilyIndex,
     Rr_Arena *Arena)
 {
     uint32_t PhysicalDeviceCount = 0;
@@ -382,12 +436,14 @@ void Rr_SelectPhysicalDevice(
         VkPhysicalDevice PhysicalDeviceHandle = PhysicalDevices[Index];
         uint32_t GraphicsQueueFamilyIndex;
         uint32_t TransferQueueFamilyIndex;
+        uint32_t ComputeQueueFamilyIndex;
         if(Rr_CheckPhysicalDevice(
                Instance,
                PhysicalDeviceHandle,
                Surface,
                &GraphicsQueueFamilyIndex,
                &TransferQueueFamilyIndex,
+               &ComputeQueueFamilyIndex,
                Arena))
         {
             VkPhysicalDeviceProperties2 Properties = {
@@ -451,6 +507,7 @@ void Rr_SelectPhysicalDevice(
                 BestDeviceMemory = Memory;
                 *OutGraphicsQueueFamilyIndex = GraphicsQueueFamilyIndex;
                 *OutTransferQueueFamilyIndex = TransferQueueFamilyIndex;
+                *OutComputeQueueFamilyIndex = ComputeQueueFamilyIndex;
             }
             else
             {
@@ -494,6 +551,8 @@ void Rr_SelectPhysicalDevice(
 
     bool UseTransferQueue =
         *OutGraphicsQueueFamilyIndex != *OutTransferQueueFamilyIndex;
+    bool UseComputeQueue =
+        *OutGraphicsQueueFamilyIndex != *OutComputeQueueFamilyIndex;
 
     *PhysicalDevice = (Rr_PhysicalDevice){
         .SubgroupProperties =
@@ -521,6 +580,9 @@ void Rr_SelectPhysicalDevice(
     RR_LOG(
         "Using %s transfer queue.",
         UseTransferQueue ? "dedicated" : "unified");
+    RR_LOG(
+        "Using %s compute queue.",
+        UseComputeQueue ? "dedicated" : "unified");
 }
 
 void Rr_InitSurface(void *Window, Rr_Instance *Instance, VkSurfaceKHR *Surface)
@@ -532,13 +594,46 @@ void Rr_InitSurface(void *Window, Rr_Instance *Instance, VkSurfaceKHR *Surface)
     }
 }
 
+static bool Rr_HasDeviceExtension(
+    Rr_Instance *Instance,
+    VkPhysicalDevice PhysicalDevice,
+    const char *Name,
+    Rr_Arena *Arena)
+{
+    uint32_t ExtensionCount;
+    Instance->EnumerateDeviceExtensionProperties(
+        PhysicalDevice,
+        NULL,
+        &ExtensionCount,
+        NULL);
+
+    VkExtensionProperties *Extensions =
+        RR_ALLOC_TYPE_COUNT(Arena, VkExtensionProperties, ExtensionCount);
+    Instance->EnumerateDeviceExtensionProperties(
+        PhysicalDevice,
+        NULL,
+        &ExtensionCount,
+        Extensions);
+
+    for(uint32_t Index = 0; Index < ExtensionCount; Index++)
+    {
+        if(strcmp(Extensions[Index].extensionName, Name) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void Rr_InitDeviceAndQueues(
     Rr_Instance *Instance,
     VkSurfaceKHR Surface,
     Rr_PhysicalDevice *PhysicalDevice,
     Rr_Device *Device,
     Rr_Queue *GraphicsQueue,
-    Rr_Queue *TransferQueue)
+    Rr_Queue *TransferQueue,
+    Rr_Queue *ComputeQueue)
 {
     Rr_Scratch Scratch = Rr_GetScratch(NULL);
 
@@ -548,34 +643,198 @@ void Rr_InitDeviceAndQueues(
         PhysicalDevice,
         &GraphicsQueue->FamilyIndex,
         &TransferQueue->FamilyIndex,
+        &ComputeQueue->FamilyIndex,
         Scratch.Arena);
 
     bool UseTransferQueue =
         GraphicsQueue->FamilyIndex != TransferQueue->FamilyIndex;
-    float QueuePriorities[] = { 1.0f };
-    VkDeviceQueueCreateInfo QueueInfos[] = {
-        {
+    bool UseComputeQueue =
+        GraphicsQueue->FamilyIndex != ComputeQueue->FamilyIndex;
+    bool ShareComputeFamily =
+        UseTransferQueue &&
+        TransferQueue->FamilyIndex == ComputeQueue->FamilyIndex;
+    float QueuePriorities[] = { 1.0f, 1.0f };
+    VkDeviceQueueCreateInfo QueueInfos[3] = { 0 };
+    uint32_t QueueInfoCount = 0;
+    QueueInfos[QueueInfoCount++] = (VkDeviceQueueCreateInfo){
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+        .queueFamilyIndex = GraphicsQueue->FamilyIndex,
+        .queueCount = 1,
+        .pQueuePriorities = QueuePriorities,
+    };
+    if(UseTransferQueue)
+    {
+        QueueInfos[QueueInfoCount++] = (VkDeviceQueueCreateInfo){
             .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-            .queueFamilyIndex = GraphicsQueue->FamilyIndex,
-            .queueCount = 1,
+            .queueFamilyIndex = TransferQueue->FamilyIndex,
+            .queueCount = ShareComputeFamily ? 2 : 1,
             .pQueuePriorities = QueuePriorities,
-        },
-        {
+        };
+    }
+    if(UseComputeQueue && ShareComputeFamily == false)
+    {
+        QueueInfos[QueueInfoCount++] = (VkDeviceQueueCreateInfo){
             .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-            .queueFamilyIndex = TransferQueue->FamilyIndex,
+            .queueFamilyIndex = ComputeQueue->FamilyIndex,
             .queueCount = 1,
             .pQueuePriorities = QueuePriorities,
-        }
+        };
+    }
+
+    const char *DeviceExtensions[5];
+    uint32_t DeviceExtensionCount = 0;
+    if(Surface != VK_NULL_HANDLE)
+    {
+        DeviceExtensions[DeviceExtensionCount++] =
+            VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+    }
+
+    /* Synchronization2 is optional, graph barriers fall back to
+     * vkCmdPipelineBarrier without it. */
+
+    VkPhysicalDeviceSynchronization2FeaturesKHR Synchronization2Features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
     };
+    bool UseSynchronization2 = Rr_HasDeviceExtension(
+        Instance,
+        PhysicalDevice->Handle,
+        VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+        Scratch.Arena);
+    if(UseSynchronization2)
+    {
+        VkPhysicalDeviceFeatures2 Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &Synchronization2Features,
+        };
+        Instance->GetPhysicalDeviceFeatures2(PhysicalDevice->Handle, &Features);
+        UseSynchronization2 = Synchronization2Features.synchronization2;
+    }
+    if(UseSynchronization2)
+    {
+        DeviceExtensions[DeviceExtensionCount++] =
+            VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME;
+    }
+
+    /* Memory budget lets VMA report per-heap budgets from the OS
+     * instead of guessing from the heap size. */
+
+    bool UseMemoryBudget = Rr_HasDeviceExtension(
+        Instance,
+        PhysicalDevice->Handle,
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+        Scratch.Arena);
+    if(UseMemoryBudget)
+    {
+        DeviceExtensions[DeviceExtensionCount++] =
+            VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+    }
 
-    const char *DeviceExtensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    /* Descriptor indexing backs the optional bindless set. Only the
+     * features the bindless set relies on are enabled. */
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT DescriptorIndexingFeatures =
+        {
+            .sType =
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT,
+        };
+    bool UseDescriptorIndexing = Rr_HasDeviceExtension(
+        Instance,
+        PhysicalDevice->Handle,
+        VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
+        Scratch.Arena);
+    if(UseDescriptorIndexing)
+    {
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT Supported = {
+            .sType =
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT,
+        };
+        VkPhysicalDeviceFeatures2 Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &Supported,
+        };
+        Instance->GetPhysicalDeviceFeatures2(PhysicalDevice->Handle, &Features);
+        UseDescriptorIndexing =
+            Supported.runtimeDescriptorArray &&
+            Supported.descriptorBindingPartiallyBound &&
+            Supported.descriptorBindingSampledImageUpdateAfterBind &&
+            Supported.descriptorBindingStorageImageUpdateAfterBind &&
+            Supported.descriptorBindingStorageBufferUpdateAfterBind &&
+            Supported.shaderSampledImageArrayNonUniformIndexing;
+        DescriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+        DescriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        DescriptorIndexingFeatures
+            .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        DescriptorIndexingFeatures
+            .descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+        DescriptorIndexingFeatures
+            .descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        DescriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing =
+            VK_TRUE;
+    }
+    if(UseDescriptorIndexing)
+    {
+        DeviceExtensions[DeviceExtensionCount++] =
+            VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME;
+
+        PhysicalDevice->DescriptorIndexingProperties =
+            (VkPhysicalDeviceDescriptorIndexingPropertiesEXT){
+                .sType =
+                    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT,
+            };
+        VkPhysicalDeviceProperties2 Properties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &PhysicalDevice->DescriptorIndexingProperties,
+        };
+        Instance->GetPhysicalDeviceProperties2(
+            PhysicalDevice->Handle,
+            &Properties);
+    }
+
+    /* Push descriptors let small sets be written straight into the
+     * command buffer, sets fall back to pooled allocation without. */
+
+    bool UsePushDescriptor = Rr_HasDeviceExtension(
+        Instance,
+        PhysicalDevice->Handle,
+        VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
+        Scratch.Arena);
+    if(UsePushDescriptor)
+    {
+        DeviceExtensions[DeviceExtensionCount++] =
+            VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME;
+
+        PhysicalDevice->PushDescriptorProperties =
+            (VkPhysicalDevicePushDescriptorPropertiesKHR){
+                .sType =
+                    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR,
+            };
+        VkPhysicalDeviceProperties2 Properties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &PhysicalDevice->PushDescriptorProperties,
+        };
+        Instance->GetPhysicalDeviceProperties2(
+            PhysicalDevice->Handle,
+            &Properties);
+    }
+
+    void *DeviceCreateInfoNext = NULL;
+    if(UseDescriptorIndexing)
+    {
+        DescriptorIndexingFeatures.pNext = DeviceCreateInfoNext;
+        DeviceCreateInfoNext = &DescriptorIndexingFeatures;
+    }
+    if(UseSynchronization2)
+    {
+        Synchronization2Features.pNext = DeviceCreateInfoNext;
+        DeviceCreateInfoNext = &Synchronization2Features;
+    }
 
     VkDeviceCreateInfo DeviceCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext = NULL,
-        .queueCreateInfoCount = UseTransferQueue ? 2 : 1,
+        .pNext = DeviceCreateInfoNext,
+        .queueCreateInfoCount = QueueInfoCount,
         .pQueueCreateInfos = QueueInfos,
-        .enabledExtensionCount = SDL_arraysize(DeviceExtensions),
+        .enabledExtensionCount = DeviceExtensionCount,
         .ppEnabledExtensionNames = DeviceExtensions,
     };
 
@@ -1050,6 +1309,58 @@ void Rr_InitDeviceAndQueues(
             Device->Handle,
             "vkQueuePresentKHR");
 
+    /* Vulkan 1.1 */
+
+    Device->CreateDescriptorUpdateTemplate =
+        (PFN_vkCreateDescriptorUpdateTemplate)Instance->GetDeviceProcAddr(
+            Device->Handle,
+            "vkCreateDescriptorUpdateTemplate");
+    Device->DestroyDescriptorUpdateTemplate =
+        (PFN_vkDestroyDescriptorUpdateTemplate)Instance->GetDeviceProcAddr(
+            Device->Handle,
+            "vkDestroyDescriptorUpdateTemplate");
+
+    /* VK_KHR_synchronization2 */
+
+    if(UseSynchronization2)
+    {
+        Device->CmdPipelineBarrier2KHR =
+            (PFN_vkCmdPipelineBarrier2KHR)Instance->GetDeviceProcAddr(
+                Device->Handle,
+                "vkCmdPipelineBarrier2KHR");
+    }
+    RR_LOG(
+        "Synchronization2 is %s.",
+        UseSynchronization2 ? "enabled" : "not supported");
+
+    /* VK_EXT_memory_budget */
+
+    Device->HasMemoryBudget = UseMemoryBudget;
+    RR_LOG(
+        "Memory budget is %s.",
+        UseMemoryBudget ? "enabled" : "not supported");
+
+    /* VK_KHR_push_descriptor */
+
+    if(UsePushDescriptor)
+    {
+        Device->CmdPushDescriptorSetWithTemplateKHR =
+            (PFN_vkCmdPushDescriptorSetWithTemplateKHR)
+                Instance->GetDeviceProcAddr(
+                    Device->Handle,
+                    "vkCmdPushDescriptorSetWithTemplateKHR");
+    }
+    RR_LOG(
+        "Push descriptors are %s.",
+        UsePushDescriptor ? "enabled" : "not supported");
+
+    /* VK_EXT_descriptor_indexing */
+
+    Device->HasDescriptorIndexing = UseDescriptorIndexing;
+    RR_LOG(
+        "Descriptor indexing is %s.",
+        UseDescriptorIndexing ? "enabled" : "not supported");
+
     Device->GetDeviceQueue(
         Device->Handle,
         GraphicsQueue->FamilyIndex,
@@ -1063,6 +1374,14 @@ void Rr_InitDeviceAndQueues(
             0,
             &TransferQueue->Handle);
     }
+    if(UseComputeQueue)
+    {
+        Device->GetDeviceQueue(
+            Device->Handle,
+            ComputeQueue->FamilyIndex,
+            ShareComputeFamily ? 1 : 0,
+            &ComputeQueue->Handle);
+    }
 
     Rr_DestroyScratch(Scratch);
 }
@@ -1071,7 +1390,9 @@ void Rr_BlitColorImage(
     Rr_Device *Device,
     VkCommandBuffer CommandBuffer,
     VkImage Source,
+    uint32_t SrcMipLevel,
     VkImage Destination,
+    uint32_t DstMipLevel,
     Rr_IntVec4 SrcRect,
     Rr_IntVec4 DstRect,
     VkImageAspectFlags AspectMask)
@@ -1079,7 +1400,7 @@ void Rr_BlitColorImage(
     VkImageBlit ImageBlit = {
         .srcSubresource = {
             .aspectMask = AspectMask,
-            .mipLevel = 0,
+            .mipLevel = SrcMipLevel,
             .baseArrayLayer = 0,
             .layerCount = 1,
         },
@@ -1089,7 +1410,7 @@ void Rr_BlitColorImage(
         },
         .dstSubresource = {
             .aspectMask = AspectMask,
-            .mipLevel = 0,
+            .mipLevel = DstMipLevel,
             .baseArrayLayer = 0,
             .layerCount = 1,
         },
@@ -32,6 +32,11 @@ struct Rr_SyncState
     {
         VkImageLayout Layout;
     } Specific;
+    bool ComputeOwned;
+
+    /* Nonzero when parts of the resource diverged, see
+     * Rr_SplitSynchronizationState. */
+    uint32_t SubresourceCount;
 };
 
 typedef struct Rr_BufferMemoryBarrier Rr_BufferMemoryBarrier;
@@ -89,6 +94,13 @@ struct Rr_PhysicalDevice
     VkPhysicalDeviceProperties2 Properties;
     VkPhysicalDeviceMemoryProperties MemoryProperties;
     VkPhysicalDeviceSubgroupProperties SubgroupProperties;
+
+    /* Only filled when VK_EXT_descriptor_indexing is enabled. */
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT
+        DescriptorIndexingProperties;
+
+    /* Only filled when VK_KHR_push_descriptor is enabled. */
+    VkPhysicalDevicePushDescriptorPropertiesKHR PushDescriptorProperties;
 };
 
 typedef struct Rr_Device Rr_Device;
@@ -219,6 +231,11 @@ struct Rr_Device
     PFN_vkUpdateDescriptorSets UpdateDescriptorSets;
     PFN_vkWaitForFences WaitForFences;
 
+    /* Vulkan 1.1 */
+
+    PFN_vkCreateDescriptorUpdateTemplate CreateDescriptorUpdateTemplate;
+    PFN_vkDestroyDescriptorUpdateTemplate DestroyDescriptorUpdateTemplate;
+
     /* VK_KHR_swapchain */
 
     PFN_vkAcquireNextImageKHR AcquireNextImageKHR;
@@ -226,6 +243,23 @@ struct Rr_Device
     PFN_vkDestroySwapchainKHR DestroySwapchainKHR;
     PFN_vkGetSwapchainImagesKHR GetSwapchainImagesKHR;
     PFN_vkQueuePresentKHR QueuePresentKHR;
+
+    /* VK_KHR_synchronization2, NULL when not supported. */
+
+    PFN_vkCmdPipelineBarrier2KHR CmdPipelineBarrier2KHR;
+
+    /* VK_KHR_push_descriptor, NULL when not supported. */
+
+    PFN_vkCmdPushDescriptorSetWithTemplateKHR
+        CmdPushDescriptorSetWithTemplateKHR;
+
+    /* VK_EXT_memory_budget */
+
+    bool HasMemoryBudget;
+
+    /* VK_EXT_descriptor_indexing */
+
+    bool HasDescriptorIndexing;
 };
 
 typedef struct Rr_Instance Rr_Instance;
@@ -300,6 +334,7 @@ extern void Rr_InitLoader(Rr_VulkanLoader *Loader);
 extern void Rr_InitInstance(
     Rr_VulkanLoader *Loader,
     const char *ApplicationName,
+    bool Headless,
     Rr_Instance *Instance);
 
 extern void Rr_InitSurface(
@@ -313,13 +348,16 @@ extern void Rr_InitDeviceAndQueues(
     Rr_PhysicalDevice *PhysicalDevice,
     Rr_Device *Device,
     Rr_Queue *GraphicsQueue,
-    Rr_Queue *TransferQueue);
+    Rr_Queue *TransferQueue,
+    Rr_Queue *ComputeQueue);
 
 extern void Rr_BlitColorImage(
     Rr_Device *Device,
     VkCommandBuffer CommandBuffer,
     VkImage Source,
+    uint32_t SrcMipLevel,
     VkImage Destination,
+    uint32_t DstMipLevel,
     Rr_IntVec4 SrcRect,
     Rr_IntVec4 DstRect,
     VkImageAspectFlags AspectMask);
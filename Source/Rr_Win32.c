@@ -13,6 +13,7 @@ bool Rr_InitPlatform()
     GetSystemInfo(&SystemInfo);
     PlatformInfo.PageSize = SystemInfo.dwPageSize;
     PlatformInfo.AllocationGranularity = SystemInfo.dwAllocationGranularity;
+    PlatformInfo.HugePageSize = 0;
 
     return true;
 }
@@ -27,6 +28,14 @@ void *Rr_ReserveMemory(size_t Size)
     return VirtualAlloc(0, Size, MEM_RESERVE, PAGE_READWRITE);
 }
 
+/* Large pages need SeLockMemoryPrivilege and can't be committed
+ * lazily, reserve regular pages instead. */
+
+void *Rr_ReserveHugeMemory(size_t Size)
+{
+    return Rr_ReserveMemory(Size);
+}
+
 void Rr_ReleaseMemory(void *Data, size_t Size)
 {
     VirtualFree(Data, 0, MEM_RELEASE);
@@ -42,6 +51,15 @@ void Rr_DecommitMemory(void *Data, size_t Size)
     VirtualFree(Data, Size, MEM_DECOMMIT);
 }
 
+void Rr_PrefaultMemory(void *Data, size_t Size)
+{
+    volatile char *Bytes = Data;
+    for(size_t Offset = 0; Offset < Size; Offset += PlatformInfo.PageSize)
+    {
+        Bytes[Offset] = Bytes[Offset];
+    }
+}
+
 int Rr_GetAtomicInt(Rr_AtomicInt *AtomicInt)
 {
     return _InterlockedOr((long *)&AtomicInt->Value, 0);